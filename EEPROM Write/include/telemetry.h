@@ -0,0 +1,141 @@
+/*
+ * telemetry.h
+ *
+ *  Fixed-size binary telemetry records, shared by the FEE, EEPROM Write and
+ *  sdcard projects (the same telemetry.h and telemetry.c in each of them).
+ *
+ *  Every record is TELEMETRY_RECORD_SIZE bytes, big-endian like logbin.h:
+ *
+ *   0  sync       0x5A (1)
+ *   1  type       TELEMETRY_... (1)
+ *   2  source     project that sent it, TELEMETRY_SOURCE_... (1)
+ *   3  sequence   per source, wraps at 256; a gap is a lost record (1)
+ *   4  timestamp  TELEMETRY_TIMESTAMP() ticks (4)
+ *   8  value      per type, see below (4)
+ *  12  detail     per type, two bytes hi and lo (2)
+ *  14  check      Fletcher-16 of bytes 0 to 13 (2)
+ *
+ *  Type                    value                detail hi         detail lo
+ *  TELEMETRY_FLASH_PROGRAM address              bytes             Fapi_StatusType
+ *  TELEMETRY_FAPI_STATUS   Fapi_getFsmStatus()  TELEMETRY_FAPI_.. Fapi_StatusType
+ *  TELEMETRY_ESM_EVENT     status register      group             channel
+ *  TELEMETRY_ECC_ERROR     address              TELEMETRY_ECC_..  errors, at most 255
+ *  TELEMETRY_FEE_JOB       block number         TELEMETRY_FEE_..  TI_FeeJobResultType
+ *  TELEMETRY_SD_ERROR      sector               TELEMETRY_SD_..   error code
+ *
+ *  telemetry_put() encodes a record into a batch in RAM, telemetry_flush()
+ *  hands the batch to TELEMETRY_WRITE(), fwrite() to the debug console by
+ *  default. Both are for the main loop only. A host decoder is in
+ *  sdcard/sim/source/telemetry_decode.c.
+ */
+
+#ifndef INCLUDE_TELEMETRY_H_
+#define INCLUDE_TELEMETRY_H_
+
+#include "hal_stdtypes.h"
+
+#define TELEMETRY_RECORD_SIZE		16U
+#define TELEMETRY_SYNC				0x5AU
+#define TELEMETRY_BATCH_RECORDS		32U		// records kept before telemetry_put() flushes by itself
+
+#ifndef TELEMETRY_TIMESTAMP
+#include "sys_pmu.h"
+#define TELEMETRY_TIMESTAMP()		_pmuGetCycleCount_()
+#endif
+
+#ifndef TELEMETRY_WRITE
+#include <stdio.h>
+#define TELEMETRY_WRITE(data, length)	{ (void) fwrite((data), 1U, (length), stdout); (void) fflush(stdout); }
+#endif
+
+#define TELEMETRY_DETAIL(hi, lo)	((uint16) ((((uint32) (hi) & 0xFFU) << 8) | ((uint32) (lo) & 0xFFU)))
+
+// Sources
+#define TELEMETRY_SOURCE_FEE		0x01U
+#define TELEMETRY_SOURCE_EEPROM		0x02U
+#define TELEMETRY_SOURCE_SDCARD		0x03U
+
+// Record types
+#define TELEMETRY_FLASH_PROGRAM		0x01U
+#define TELEMETRY_FAPI_STATUS		0x02U
+#define TELEMETRY_ESM_EVENT			0x03U
+#define TELEMETRY_ECC_ERROR			0x04U
+#define TELEMETRY_FEE_JOB			0x05U
+#define TELEMETRY_SD_ERROR			0x06U
+
+// Detail hi of TELEMETRY_FAPI_STATUS: the call that returned the status
+#define TELEMETRY_FAPI_INIT_BANKS	0x01U	// Fapi_initializeFlashBanks()
+#define TELEMETRY_FAPI_ACTIVE_BANK	0x02U	// Fapi_setActiveFlashBank()
+#define TELEMETRY_FAPI_SECTORS		0x03U	// Fapi_enableMainBankSectors() or Fapi_enableEepromBankSectors()
+#define TELEMETRY_FAPI_PROGRAM		0x04U	// Fapi_issueProgrammingCommand()
+#define TELEMETRY_FAPI_ERASE		0x05U	// Fapi_issueAsyncCommandWithAddress()
+
+// Detail hi of TELEMETRY_ECC_ERROR
+#define TELEMETRY_ECC_FLASH_SINGLE	0x01U
+#define TELEMETRY_ECC_FLASH_DOUBLE	0x02U
+#define TELEMETRY_ECC_RAM_SINGLE	0x03U	// RAMSCRUB_EVENT_SINGLE
+#define TELEMETRY_ECC_RAM_DOUBLE	0x04U	// RAMSCRUB_EVENT_DOUBLE
+#define TELEMETRY_ECC_RAM_OTHER		0x05U	// RAMSCRUB_EVENT_OTHER, the address is 0
+
+// Detail hi of TELEMETRY_FEE_JOB
+#define TELEMETRY_FEE_WRITE			0x01U
+#define TELEMETRY_FEE_READ			0x02U
+#define TELEMETRY_FEE_INVALIDATE	0x03U
+#define TELEMETRY_FEE_ERASE			0x04U
+#define TELEMETRY_FEE_FORMAT		0x05U
+#define TELEMETRY_FEE_INIT			0x06U
+
+// Detail hi of TELEMETRY_SD_ERROR
+#define TELEMETRY_SD_INIT			0x01U
+#define TELEMETRY_SD_READ			0x02U
+#define TELEMETRY_SD_WRITE			0x03U
+#define TELEMETRY_SD_ERASE			0x04U
+
+//
+// A record decoded by telemetry_decode().
+//
+typedef struct
+{
+	uint8 type;
+	uint8 source;
+	uint8 sequence;
+	uint32 timestamp;
+	uint32 value;
+	uint16 detail;
+}
+telemetry_record;
+
+/**
+ * 	@brief Sets the source of the records and empties the batch.
+ */
+void telemetry_init(uint8 source);
+
+/**
+ * 	@brief Encodes a record with the next sequence number.
+ *
+ *	@param record - Receives TELEMETRY_RECORD_SIZE bytes.
+ */
+void telemetry_encode(uint8* record, uint8 type, uint32 timestamp, uint32 value, uint16 detail);
+
+/**
+ * 	@brief Checks the sync byte and the check of a record and decodes it.
+ *
+ *  @return TRUE when *record holds a valid record.
+ */
+boolean telemetry_decode(const uint8* data, telemetry_record* record);
+
+/**
+ * 	@brief Encodes a record stamped with TELEMETRY_TIMESTAMP() into the batch.
+ *
+ *  A full batch is flushed first.
+ */
+void telemetry_put(uint8 type, uint32 value, uint16 detail);
+
+/**
+ * 	@brief Writes the batch with TELEMETRY_WRITE() and empties it.
+ *
+ *  @return Bytes written.
+ */
+uint32 telemetry_flush(void);
+
+#endif /* INCLUDE_TELEMETRY_H_ */
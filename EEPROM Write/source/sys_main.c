@@ -56,6 +56,7 @@
 #include <stdio.h>
 #include "ti_fee.h"
 #include "F021.h"
+#include "telemetry.h"
 #define _L2FMC
 /* USER CODE END */
 
@@ -90,22 +91,24 @@ int main(void)
     buffer[3] = 0x45;
     uint32 address = 0xF0200000;
 
+    // Report the results as telemetry records, time stamped with the PMU cycle counter
+    _pmuInit_();
+    _pmuEnableCountersGlobal_();
+    _pmuStartCounters_(pmuCYCLE_COUNTER);
+    telemetry_init(TELEMETRY_SOURCE_EEPROM);
+
     oReturnCheck = Fapi_initializeFlashBanks(80);
-    printf("Initialize Flash Banks return: %d\n", oReturnCheck);
+    telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_INIT_BANKS, oReturnCheck));
     oReturnCheck = Fapi_setActiveFlashBank(Fapi_FlashBank7);
-    printf("Set Active Flash Bank return: %d\n", oReturnCheck);
+    telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_ACTIVE_BANK, oReturnCheck));
     oReturnCheck = Fapi_enableEepromBankSectors(0xFFFFFFFF, 0xFFFFFFFF);
-    printf("enable main bank sectors return: %d\n", oReturnCheck);
+    telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_SECTORS, oReturnCheck));
     while(Fapi_checkFsmForReady() != Fapi_Status_FsmReady);
     oReturnCheck = Fapi_issueProgrammingCommand((uint32*)address, buffer, (uint8)4, 0, 0, Fapi_DataOnly);
     while(Fapi_checkFsmForReady() == Fapi_Status_FsmBusy);
-    printf("Return check %d\n", oReturnCheck);
-    printf("FSM Status %d\n", Fapi_getFsmStatus());
-    while(Fapi_checkFsmForReady() == Fapi_Status_FsmBusy);
-
-    printf("Return of programming command %d\n", oReturnCheck);
-
-    printf("After wait while\n");
+    telemetry_put(TELEMETRY_FLASH_PROGRAM, address, TELEMETRY_DETAIL(4U, oReturnCheck));
+    telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_PROGRAM, oReturnCheck));
+    (void) telemetry_flush();
 
     // Wait here if the tests are successful
     while(1);
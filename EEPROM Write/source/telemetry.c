@@ -0,0 +1,103 @@
+/**
+ *	\file telemetry.c
+ *	\brief Encoder and decoder of the binary telemetry records.
+ *	The record layout is described in telemetry.h.
+ */
+
+#include "telemetry.h"
+
+static uint8 telemetry_batch[TELEMETRY_BATCH_RECORDS * TELEMETRY_RECORD_SIZE];
+static uint32 telemetry_used = 0;		// bytes of the batch in use
+static uint8 telemetry_source = 0;
+static uint8 telemetry_sequence = 0;
+
+//
+// Fletcher-16 of the first 14 bytes. The sums of 14 bytes cannot overflow, so the modulo is taken once.
+//
+static uint16 telemetry_check(const uint8* data)
+{
+	uint32 sum1 = 0;
+	uint32 sum2 = 0;
+	uint32 i;
+
+	for (i = 0U; i < (TELEMETRY_RECORD_SIZE - 2U); i++)
+	{
+		sum1 += data[i];
+		sum2 += sum1;
+	}
+
+	return (uint16) (((sum2 % 255U) << 8) | (sum1 % 255U));
+}
+
+void telemetry_init(uint8 source)
+{
+	telemetry_source = source;
+	telemetry_sequence = 0U;
+	telemetry_used = 0U;
+}
+
+void telemetry_encode(uint8* record, uint8 type, uint32 timestamp, uint32 value, uint16 detail)
+{
+	uint16 check;
+
+	record[0] = TELEMETRY_SYNC;
+	record[1] = type;
+	record[2] = telemetry_source;
+	record[3] = telemetry_sequence++;
+	record[4] = (uint8) (timestamp >> 24);
+	record[5] = (uint8) (timestamp >> 16);
+	record[6] = (uint8) (timestamp >> 8);
+	record[7] = (uint8) timestamp;
+	record[8] = (uint8) (value >> 24);
+	record[9] = (uint8) (value >> 16);
+	record[10] = (uint8) (value >> 8);
+	record[11] = (uint8) value;
+	record[12] = (uint8) (detail >> 8);
+	record[13] = (uint8) detail;
+
+	check = telemetry_check(record);
+	record[14] = (uint8) (check >> 8);
+	record[15] = (uint8) check;
+}
+
+boolean telemetry_decode(const uint8* data, telemetry_record* record)
+{
+	if (data[0] != TELEMETRY_SYNC ||
+		telemetry_check(data) != (uint16) (((uint32) data[14] << 8) | data[15]))
+	{
+		return FALSE;
+	}
+
+	record->type = data[1];
+	record->source = data[2];
+	record->sequence = data[3];
+	record->timestamp = ((uint32) data[4] << 24) | ((uint32) data[5] << 16) | ((uint32) data[6] << 8) | data[7];
+	record->value = ((uint32) data[8] << 24) | ((uint32) data[9] << 16) | ((uint32) data[10] << 8) | data[11];
+	record->detail = (uint16) (((uint32) data[12] << 8) | data[13]);
+
+	return TRUE;
+}
+
+void telemetry_put(uint8 type, uint32 value, uint16 detail)
+{
+	if (telemetry_used >= sizeof(telemetry_batch))
+	{
+		(void) telemetry_flush();
+	}
+
+	telemetry_encode(&telemetry_batch[telemetry_used], type, TELEMETRY_TIMESTAMP(), value, detail);
+	telemetry_used += TELEMETRY_RECORD_SIZE;
+}
+
+uint32 telemetry_flush(void)
+{
+	uint32 length = telemetry_used;
+
+	if (length > 0U)
+	{
+		TELEMETRY_WRITE(telemetry_batch, length);
+	}
+	telemetry_used = 0U;
+
+	return length;
+}
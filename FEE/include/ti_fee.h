@@ -174,6 +174,150 @@
 #define FEE_ENABLE_SECTORS_31_00  0xFFFFFFFFU 
 #define FEE_ENABLE_SECTORS_63_32  0xFFFFFFFFU 
 
+/* Size of the block number hash used by TI_FeeInternal_GetBlockIndex. Power of two, at least twice the number of
+   configured blocks, so that linear probing stays short. */
+#if (TI_FEE_NUMBER_OF_BLOCKS <= 8U)
+#define TI_FEE_BLOCK_HASH_SIZE    16U
+#elif (TI_FEE_NUMBER_OF_BLOCKS <= 32U)
+#define TI_FEE_BLOCK_HASH_SIZE    64U
+#elif (TI_FEE_NUMBER_OF_BLOCKS <= 128U)
+#define TI_FEE_BLOCK_HASH_SIZE    256U
+#elif (TI_FEE_NUMBER_OF_BLOCKS <= 512U)
+#define TI_FEE_BLOCK_HASH_SIZE    1024U
+#else
+#define TI_FEE_BLOCK_HASH_SIZE    4096U
+#endif
+#define TI_FEE_BLOCK_HASH_EMPTY   0xFFFFU
+
+/* Block offset snapshot. After each copy of the valid blocks into a new virtual sector, the block offset array is
+   written as a block with number TI_FEE_SNAPSHOT_BLOCK_NUMBER, and its address is recorded in the unused bytes 24-31
+   of the virtual sector header. TI_Fee_Init loads it and scans only the block headers written after it.
+   TI_FEE_SNAPSHOT_BLOCK_NUMBER must not be used by a configured block. */
+#ifndef TI_FEE_BLOCK_OFFSET_SNAPSHOT
+#define TI_FEE_BLOCK_OFFSET_SNAPSHOT     STD_ON
+#endif
+#ifndef TI_FEE_SNAPSHOT_BLOCK_NUMBER
+#define TI_FEE_SNAPSHOT_BLOCK_NUMBER     0xFFFEU
+#endif
+#define TI_FEE_SNAPSHOT_MAGIC            0x534E4150U
+#define TI_FEE_SNAPSHOT_POINTER_OFFSET   24U
+/* Magic, configuration signature, checksum, reserved word and one offset per data set, in 8 byte units */
+#define TI_FEE_SNAPSHOT_SIZE             ((16U + (2U * TI_FEE_TOTAL_BLOCKS_DATASETS) + 7U) & 0xFFF8U)
+#if ((TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON) && (TI_FEE_NUMBER_OF_UNCONFIGUREDBLOCKSTOCOPY != 0U))
+#error "TI_FEE_BLOCK_OFFSET_SNAPSHOT cannot be used when unconfigured blocks are copied."
+#endif
+
+/* Words summed by TI_FeeInternal_Fletcher16 before its 32 bit sums are folded. 1024 words keep the second sum below
+   2^31. */
+#define TI_FEE_FLETCHER_WORDS_PER_FOLD   1024U
+
+/* Program 16 bytes per FSM command when the write address is 16 byte aligned and 16 bytes or more remain. Only used
+   when the FWPWRITE buffer is 16 bytes wide (WIDTH_EEPROM_BANK). */
+#ifndef TI_FEE_WIDE_WRITE
+#define TI_FEE_WIDE_WRITE                STD_ON
+#endif
+
+/* Background copy. When the FEE is idle and the active virtual sector is filled to TI_FEE_BACKGROUND_COPY_THRESHOLD
+   percent, TI_FeeInternal_FeeManager starts the copy of the valid blocks into the next virtual sector, so that the 
+   write which would not fit anymore does not wait for the copy. The copy is only started when it frees at least 
+   TI_FEE_BACKGROUND_COPY_MIN_RECLAIM percent of the virtual sector, and when an empty virtual sector is available.
+   A write requested while the copy runs still waits for the whole copy, so the foreground latency only stays flat
+   when the copy completes while the FEE is idle. Copying early also erases the virtual sectors more often (23 instead
+   of 20 erases for 2000 writes in the FEE sim), which costs flash endurance; it is therefore off by default. */
+#ifndef TI_FEE_BACKGROUND_COPY
+#define TI_FEE_BACKGROUND_COPY           STD_OFF
+#endif
+#ifndef TI_FEE_BACKGROUND_COPY_THRESHOLD
+#define TI_FEE_BACKGROUND_COPY_THRESHOLD     90U
+#endif
+#ifndef TI_FEE_BACKGROUND_COPY_MIN_RECLAIM
+#define TI_FEE_BACKGROUND_COPY_MIN_RECLAIM   25U
+#endif
+
+/* Cycle accounting. TI_Fee_MainFunction measures every step, i.e. one pass of the state machine of an EEP, and the 
+   whole call with TI_FEE_GET_TIMESTAMP and keeps the maximum, the sum and a histogram per step type. With a budget 
+   set (TI_FEE_MAIN_FUNCTION_BUDGET or TI_Fee_SetMainFunctionBudget) a call keeps taking steps while the FEE is busy 
+   and the longest step measured so far still fits into the budget, at most TI_FEE_MAIN_FUNCTION_MAX_STEPS. A budget 
+   of 0 runs one step per call. TI_FEE_GET_TIMESTAMP defaults to the free running counter 0 of the RTI (RTIFRC0), 
+   which sys_main.c starts with rtiInit and rtiStartCounter; the budget is in its ticks. A call stops after a step 
+   over which the timestamp did not advance, so with a stopped counter it runs one step like a budget of 0. */
+#ifndef TI_FEE_CYCLE_ACCOUNTING
+#define TI_FEE_CYCLE_ACCOUNTING          STD_ON
+#endif
+#ifndef TI_FEE_MAIN_FUNCTION_BUDGET
+#define TI_FEE_MAIN_FUNCTION_BUDGET      0U
+#endif
+#ifndef TI_FEE_MAIN_FUNCTION_MAX_STEPS
+#define TI_FEE_MAIN_FUNCTION_MAX_STEPS   256U
+#endif
+#ifndef TI_FEE_GET_TIMESTAMP
+#define TI_FEE_GET_TIMESTAMP()           (*(volatile uint32*) (0xFFFFFC10U))
+#endif
+/* Bin 0 counts steps of 0 ticks, bin n steps of 2^(n-1) to 2^n - 1 ticks. The last bin is open ended. */
+#define TI_FEE_STEP_HISTOGRAM_BINS       16U
+
+/* Write-back cache. TI_Fee_WriteAsync of a block in TI_FEE_WRITE_CACHE_BLOCK_LIST only copies the data into RAM and 
+   completes at once; reads of the block are served from RAM until it is flushed. TI_Fee_MainFunction flushes a block 
+   after TI_FEE_WRITE_CACHE_FLUSH_WRITES coalesced writes, TI_FEE_WRITE_CACHE_FLUSH_CALLS calls after its first 
+   unflushed write, or after TI_Fee_FlushWriteCache. TI_Fee_Shutdown flushes all blocks. Writes which are not flushed 
+   are lost on a reset. Blocks which do not fit into TI_FEE_WRITE_CACHE_SIZE bytes are not cached. */
+#ifndef TI_FEE_WRITE_CACHE
+#define TI_FEE_WRITE_CACHE               STD_OFF
+#endif
+#ifndef TI_FEE_WRITE_CACHE_BLOCK_LIST
+#define TI_FEE_WRITE_CACHE_BLOCK_LIST    {0x1U}
+#define TI_FEE_WRITE_CACHE_BLOCKS        1U
+#endif
+#ifndef TI_FEE_WRITE_CACHE_SIZE
+#define TI_FEE_WRITE_CACHE_SIZE          64U
+#endif
+#ifndef TI_FEE_WRITE_CACHE_FLUSH_WRITES
+#define TI_FEE_WRITE_CACHE_FLUSH_WRITES  1000U
+#endif
+#ifndef TI_FEE_WRITE_CACHE_FLUSH_CALLS
+#define TI_FEE_WRITE_CACHE_FLUSH_CALLS   60000U
+#endif
+
+/* Flash ECC sweep. TI_Fee_EccSweepStep reads the next double words of the sectors in TI_FEE_ECC_SWEEP_SECTOR_LIST, 
+   program flash of bank 0 and the EEPROM bank 7, so that their ECC is checked. It then harvests the error status of 
+   both banks and counts corrected and uncorrectable errors for the sector of the reported address. A step reads at 
+   most TI_FEE_ECC_SWEEP_DOUBLEWORDS double words and stops early once TI_FEE_ECC_SWEEP_BUDGET ticks of 
+   TI_FEE_GET_TIMESTAMP have passed (0: no budget), or, with a stopped counter, when the timestamp has not advanced 
+   after the first 32 double words; TI_Fee_SetEccSweepRate changes both. Bank 7 is skipped while the FSM is busy. 
+   An uncorrectable error in bank 0 raises a data abort on the read, which dabort.asm treats as fatal; 
+   TI_Fee_EccSweepInit counts one that is still flagged after the reset. Only list flash whose ECC is programmed. */
+#ifndef TI_FEE_ECC_SWEEP
+#define TI_FEE_ECC_SWEEP                 STD_OFF
+#endif
+#ifndef TI_FEE_ECC_SWEEP_SECTOR_LIST
+/* Bank, start address and length of each sector */
+#define TI_FEE_ECC_SWEEP_SECTOR_LIST     {{Fapi_FlashBank0, 0x00000000U, 0x00008000U}, \
+                                          {Fapi_FlashBank0, 0x00008000U, 0x00008000U}, \
+                                          {Fapi_FlashBank0, 0x00010000U, 0x00008000U}, \
+                                          {Fapi_FlashBank0, 0x00018000U, 0x00008000U}, \
+                                          {Fapi_FlashBank0, 0x00020000U, 0x00020000U}, \
+                                          {Fapi_FlashBank0, 0x00040000U, 0x00020000U}, \
+                                          {Fapi_FlashBank7, 0xF0200000U, 0x00001000U}, \
+                                          {Fapi_FlashBank7, 0xF0201000U, 0x00001000U}, \
+                                          {Fapi_FlashBank7, 0xF0202000U, 0x00001000U}, \
+                                          {Fapi_FlashBank7, 0xF0203000U, 0x00001000U}}
+#define TI_FEE_ECC_SWEEP_SECTORS         10U
+#endif
+#ifndef TI_FEE_ECC_SWEEP_DOUBLEWORDS
+#define TI_FEE_ECC_SWEEP_DOUBLEWORDS     256U
+#endif
+#ifndef TI_FEE_ECC_SWEEP_BUDGET
+#define TI_FEE_ECC_SWEEP_BUDGET          0U
+#endif
+/* Reading one word of a double word makes the flash wrapper check the ECC of the whole double word */
+#ifndef TI_FEE_ECC_SWEEP_READ
+#define TI_FEE_ECC_SWEEP_READ(u32Address)   ((void)(*(volatile uint32 *)(u32Address)))
+#endif
+/* The error flags of FEDACSTATUS and EE_STATUS are cleared by writing 1 */
+#ifndef TI_FEE_CLEAR_ERROR_STATUS
+#define TI_FEE_CLEAR_ERROR_STATUS(pu32Register, u32Flags)   (*(pu32Register) = (u32Flags))
+#endif
+
 /**********************************************************************************************************************
  *  GLOBAL DATA TYPES AND STRUCTURES
  *********************************************************************************************************************/
@@ -381,6 +525,86 @@ typedef struct
 	#endif
 }TI_Fee_GlobalVarsType;
 
+/* Job latency statistics, counted in calls of TI_Fee_MainFunction. Returned by TI_Fee_GetLatencyStats. */
+typedef struct
+{
+	uint32 u32Jobs;									/* Number of jobs completed by TI_Fee_MainFunction */
+	uint32 u32MaxJobCalls;							/* Most calls a job stayed pending, including the last one */
+	uint32 u32MaxInternalCalls;						/* Most consecutive calls in BUSY_INTERNAL without a pending job 
+	                                                   (copy or erase of virtual sectors) */
+	uint32 u32BackgroundCopies;						/* Virtual sector copies started by the background copy */
+}TI_Fee_LatencyStatsType;
+
+/* Step types of the cycle accounting. TI_FEE_STEP_MAIN_FUNCTION accounts whole calls of TI_Fee_MainFunction. */
+typedef enum
+{
+	TI_FEE_STEP_MAIN_FUNCTION = 0U,
+	TI_FEE_STEP_WRITE,
+	TI_FEE_STEP_READ,
+	TI_FEE_STEP_INVALIDATE,							/* TI_Fee_InvalidateBlock and TI_Fee_EraseImmediateBlock */
+	TI_FEE_STEP_COPY,								/* Copy of the valid blocks into a new virtual sector */
+	TI_FEE_STEP_ERASE,								/* Erase of virtual sectors */
+	TI_FEE_STEP_IDLE,
+	TI_FEE_NUMBER_OF_STEP_TYPES
+}TI_Fee_StepType;
+
+/* Cycle statistics of one step type, in TI_FEE_GET_TIMESTAMP ticks. Returned by TI_Fee_GetStepStats. The average is 
+   u64TotalTicks / u32Steps. */
+typedef struct
+{
+	uint32 u32Steps;								/* Number of steps measured */
+	uint32 u32MaxTicks;								/* Longest step */
+	uint64 u64TotalTicks;							/* Sum of all steps */
+	uint32 au32Histogram[TI_FEE_STEP_HISTOGRAM_BINS];	/* Steps per power of two bin */
+}TI_Fee_StepStatsType;
+
+/* Write cache entry of one block */
+typedef struct
+{
+	uint16 u16BlockNumber;							/* Block number including the data set bits */
+	uint16 u16Offset;								/* Start of the data in TI_Fee_au32WriteCacheData, in bytes */
+	uint16 u16Size;									/* Block size, 0 if the block is not cached */
+	uint8  u8EEPIndex;
+	uint32 u32Writes;								/* Writes coalesced since the last flush */
+	uint32 u32DirtyCalls;							/* Calls of TI_Fee_MainFunction since the first of them */
+}TI_Fee_WriteCacheEntryType;
+
+/* Write cache statistics. Returned by TI_Fee_GetWriteCacheStats. */
+typedef struct
+{
+	uint32 u32Writes;								/* Writes taken by the cache */
+	uint32 u32Reads;								/* Reads served by the cache */
+	uint32 u32Flushes;								/* Blocks written to flash by the cache */
+}TI_Fee_WriteCacheStatsType;
+
+/* Sector swept by TI_Fee_EccSweepStep */
+typedef struct
+{
+	Fapi_FlashBankType oBank;						/* Fapi_FlashBank0 or Fapi_FlashBank7 */
+	uint32 u32StartAddress;
+	uint32 u32Length;								/* In bytes, a multiple of 8 */
+}TI_Fee_EccSweepSectorType;
+
+/* Error counts of one swept sector. Returned by TI_Fee_GetEccSweepSectorStats. */
+typedef struct
+{
+	uint32 u32Corrected;							/* Corrected errors since TI_Fee_EccSweepInit */
+	uint32 u32Uncorrectable;						/* Uncorrectable errors since TI_Fee_EccSweepInit */
+	uint32 u32PassCorrected;						/* Corrected errors of the last complete pass */
+	uint32 u32PassUncorrectable;					/* Uncorrectable errors of the last complete pass */
+	uint32 u32LastErrorAddress;						/* Address reported with the last error, 0 if none */
+}TI_Fee_EccSweepSectorStatsType;
+
+/* ECC sweep statistics. Returned by TI_Fee_GetEccSweepStats. */
+typedef struct
+{
+	uint32 u32Passes;								/* Complete passes over all sectors */
+	uint32 u32PassTicks;							/* Duration of the last pass */
+	uint32 u32StepMaxTicks;							/* Longest step */
+	uint32 u32SkippedSteps;							/* Steps on bank 7 skipped while the FSM was busy */
+	uint32 u32Unattributed;							/* Errors at an address outside the swept sectors */
+}TI_Fee_EccSweepStatsType;
+
 /**********************************************************************************************************************
  * EXTERN Declarations
  *********************************************************************************************************************/
@@ -417,6 +641,37 @@ extern TI_Fee_StatusWordType_UN TI_Fee_oStatusWord_Global;
 #endif
 extern boolean TI_Fee_FapiInitCalled; 
 extern boolean TI_Fee_bEraseSuspended;
+extern uint16 TI_Fee_au16BlockHash[TI_FEE_BLOCK_HASH_SIZE];
+extern uint16 TI_Fee_au16DataSetStart[TI_FEE_NUMBER_OF_BLOCKS + 1U];
+extern uint16 TI_Fee_au16ArrayToBlockIndex[TI_FEE_TOTAL_BLOCKS_DATASETS];
+#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+extern uint16 TI_Fee_au16SnapshotStep[TI_FEE_NUMBER_OF_EEPS];
+extern uint32 TI_Fee_au32SnapshotAddress[TI_FEE_NUMBER_OF_EEPS];
+#endif
+extern TI_Fee_LatencyStatsType TI_Fee_oLatencyStats[TI_FEE_NUMBER_OF_EEPS];
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+extern TI_Fee_StepStatsType TI_Fee_oStepStats[TI_FEE_NUMBER_OF_STEP_TYPES];
+extern uint32 TI_Fee_u32MainFunctionBudget;
+#endif
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+extern TI_Fee_WriteCacheEntryType TI_Fee_aoWriteCache[TI_FEE_WRITE_CACHE_BLOCKS];
+extern uint32 TI_Fee_au32WriteCacheData[(TI_FEE_WRITE_CACHE_SIZE + 3U) / 4U];
+extern uint32 TI_Fee_au32WriteCacheDirty[(TI_FEE_WRITE_CACHE_BLOCKS + 31U) / 32U];
+extern uint16 TI_Fee_u16WriteCacheFlushEntry;
+extern volatile boolean TI_Fee_bWriteCacheFlushRequest;
+extern TI_Fee_WriteCacheStatsType TI_Fee_oWriteCacheStats;
+#endif
+#if (TI_FEE_ECC_SWEEP == STD_ON)
+extern TI_Fee_EccSweepSectorStatsType TI_Fee_aoEccSweepSectorStats[TI_FEE_ECC_SWEEP_SECTORS];
+extern uint32 TI_Fee_au32EccSweepPassCorrected[TI_FEE_ECC_SWEEP_SECTORS];
+extern uint32 TI_Fee_au32EccSweepPassUncorrectable[TI_FEE_ECC_SWEEP_SECTORS];
+extern TI_Fee_EccSweepStatsType TI_Fee_oEccSweepStats;
+extern uint16 TI_Fee_u16EccSweepSector;
+extern uint32 TI_Fee_u32EccSweepOffset;
+extern uint32 TI_Fee_u32EccSweepDoubleWords;
+extern uint32 TI_Fee_u32EccSweepBudget;
+extern uint32 TI_Fee_u32EccSweepPassStart;
+#endif
 
 
 /**********************************************************************************************************************
@@ -438,7 +693,26 @@ extern void TI_Fee_MainFunction(void);
 extern TI_Fee_ErrorCodeType TI_FeeErrorCode(uint8 u8EEPIndex);
 extern void TI_Fee_ErrorRecovery(TI_Fee_ErrorCodeType ErrorCode, uint8 u8VirtualSector);
 extern TI_FeeJobResultType TI_Fee_GetJobResult(uint8 u8EEPIndex);
+extern TI_FeeJobResultType TI_Fee_GetBlockView(uint16 BlockNumber, const uint8 ** ppu8Data, uint16 * pu16Length);
 extern void TI_Fee_SuspendResumeErase(TI_Fee_EraseCommandType Command);
+extern void TI_Fee_GetLatencyStats(uint8 u8EEPIndex, TI_Fee_LatencyStatsType * pLatencyStats);
+extern void TI_Fee_ClearLatencyStats(uint8 u8EEPIndex);
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+extern void TI_Fee_SetMainFunctionBudget(uint32 u32Ticks);
+extern void TI_Fee_GetStepStats(TI_Fee_StepType StepType, TI_Fee_StepStatsType * pStepStats);
+extern void TI_Fee_ClearStepStats(void);
+#endif
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+extern void TI_Fee_FlushWriteCache(void);
+extern void TI_Fee_GetWriteCacheStats(TI_Fee_WriteCacheStatsType * pWriteCacheStats);
+#endif
+#if (TI_FEE_ECC_SWEEP == STD_ON)
+extern void TI_Fee_EccSweepInit(void);
+extern boolean TI_Fee_EccSweepStep(void);
+extern void TI_Fee_SetEccSweepRate(uint32 u32DoubleWords, uint32 u32BudgetTicks);
+extern void TI_Fee_GetEccSweepStats(TI_Fee_EccSweepStatsType * pEccSweepStats);
+extern void TI_Fee_GetEccSweepSectorStats(uint16 u16Sector, TI_Fee_EccSweepSectorStatsType * pSectorStats);
+#endif
 
 #if(TI_FEE_FLASH_ERROR_CORRECTION_HANDLING == TI_Fee_Fix)
 extern void TI_Fee_ErrorHookSingleBitError(void);
@@ -487,9 +761,27 @@ void TI_FeeInternal_WriteInitialize(TI_Fee_AddressType oFlashNextAddress, uint8*
 void TI_FeeInternal_CheckForError(uint8 u8EEPIndex);
 void TI_FeeInternal_EnableRequiredFlashSector(uint32 u32VirtualSectorStartAddress);
 uint16 TI_FeeInternal_GetArrayIndex(uint16 BlockNumber, uint16 DataSetNumber, uint8 u8EEPIndex, boolean bCallContext);
+void TI_FeeInternal_BuildBlockIndex(void);
+#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+boolean TI_FeeInternal_WriteBlockOffsetSnapshot(uint8 u8EEPIndex);
+uint32 TI_FeeInternal_LoadBlockOffsetSnapshot(uint8 u8EEPIndex, uint32 u32VirtualSectorStartAddress, 
+                                              uint32 u32VirtualSectorEndAddress);
+#endif
 #if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
 uint32 TI_FeeInternal_Fletcher16( uint8 const *pu8data, uint16 u16Length);
 #endif
+boolean TI_FeeInternal_BlockDataMatches(TI_Fee_AddressType oBlockAddress, uint8 const *pu8Data, uint16 u16Length);
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+void TI_FeeInternal_WriteCacheInit(void);
+boolean TI_FeeInternal_WriteCacheStore(uint16 BlockNumber, const uint8 * DataBufferPtr);
+boolean TI_FeeInternal_WriteCacheLoad(uint16 BlockNumber, uint16 BlockOffset, uint8 * DataBufferPtr, uint16 Length);
+const uint8 * TI_FeeInternal_WriteCacheView(uint16 BlockNumber);
+void TI_FeeInternal_WriteCacheDiscard(uint16 BlockNumber);
+void TI_FeeInternal_WriteCacheFlush(void);
+#if(TI_FEE_DRIVER == 1U)
+Std_ReturnType TI_FeeInternal_WriteCacheFlushSync(void);
+#endif
+#endif
 #if (TI_FEE_GENERATE_DEVICEANDVIRTUALSECTORSTRUC == STD_ON)
 void TI_FeeInternal_PopulateStructures(TI_Fee_DeviceType DeviceType);
 #endif
@@ -0,0 +1,293 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  F021.h
+ *      Project:  Host simulation of the F021 Flash API
+ *       Module:  FEE
+ *    Generator:  None
+ *
+ *  Description:  Stand-in for the TI F021 Flash API header when the FEE driver is built for a Linux host.
+ *                It declares the subset of types, registers and Fapi functions used by ti_fee_*.c and
+ *                Device_TMS570LS04.c. The functions are implemented by Fapi_Sim.c, which maps a simulated
+ *                bank 7 and its ECC at their device addresses.
+ *
+ *                Only the sim/include directory may shadow the real F021.h, i.e. it has to be first on the
+ *                include path of the host build and must never be on the include path of the target build.
+ *********************************************************************************************************************/
+
+#ifndef F021_H_
+#define F021_H_
+
+/**********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * COMPILER AND ENDIANNESS
+ *********************************************************************************************************************/
+/* The host is little endian; the FEE selects its FWPWRITE word order on this symbol. */
+#ifndef _LITTLE_ENDIAN
+#define _LITTLE_ENDIAN
+#endif
+
+/* Byte index translation for the FWPWRITE accessors. Identity on a little endian host. */
+#define EI8(idx)    (idx)
+#define L2EI8(idx)  (idx)
+
+/* Width of the FWPWRITE buffer used for bank 7 programming. The FEE programs 8 bytes at FWPWRITE0/1
+   for even double words and at FWPWRITE2/3 for odd double words, or all 16 bytes at once. */
+#define WIDTH_EEPROM_BANK   16U
+
+typedef unsigned char boolean_t;
+
+/**********************************************************************************************************************
+ * F021 TYPES
+ *********************************************************************************************************************/
+typedef enum
+{
+   Fapi_FlashBank0 = 0, Fapi_FlashBank1 = 1, Fapi_FlashBank2 = 2, Fapi_FlashBank3 = 3,
+   Fapi_FlashBank4 = 4, Fapi_FlashBank5 = 5, Fapi_FlashBank6 = 6, Fapi_FlashBank7 = 7
+} Fapi_FlashBankType;
+
+typedef enum
+{
+   Fapi_FlashSector0,  Fapi_FlashSector1,  Fapi_FlashSector2,  Fapi_FlashSector3,
+   Fapi_FlashSector4,  Fapi_FlashSector5,  Fapi_FlashSector6,  Fapi_FlashSector7,
+   Fapi_FlashSector8,  Fapi_FlashSector9,  Fapi_FlashSector10, Fapi_FlashSector11,
+   Fapi_FlashSector12, Fapi_FlashSector13, Fapi_FlashSector14, Fapi_FlashSector15,
+   Fapi_FlashSector16, Fapi_FlashSector17, Fapi_FlashSector18, Fapi_FlashSector19,
+   Fapi_FlashSector20, Fapi_FlashSector21, Fapi_FlashSector22, Fapi_FlashSector23,
+   Fapi_FlashSector24, Fapi_FlashSector25, Fapi_FlashSector26, Fapi_FlashSector27,
+   Fapi_FlashSector28, Fapi_FlashSector29, Fapi_FlashSector30, Fapi_FlashSector31,
+   Fapi_FlashSector63 = 63
+} Fapi_FlashSectorType;
+
+typedef enum
+{
+   Fapi_Status_Success = 0,
+   Fapi_Status_FsmBusy,
+   Fapi_Status_FsmReady,
+   Fapi_Error_Fail,
+   Fapi_Error_InvalidBank,
+   Fapi_Error_InvalidAddress,
+   Fapi_Error_InvalidCommand
+} Fapi_StatusType;
+
+typedef enum
+{
+   Fapi_ProgramData    = 0x0002,
+   Fapi_EraseSector    = 0x0006,
+   Fapi_EraseBank      = 0x0008,
+   Fapi_ValidateSector = 0x000E,
+   Fapi_ClearStatus    = 0x0010,
+   Fapi_ProgramResume  = 0x0014,
+   Fapi_EraseResume    = 0x0016,
+   Fapi_ClearMore      = 0x0018
+} Fapi_FlashStateCommandsType;
+
+typedef enum
+{
+   Fapi_AutoEccGeneration,
+   Fapi_DataOnly,
+   Fapi_EccOnly,
+   Fapi_DataAndEcc
+} Fapi_FlashProgrammingCommandsType;
+
+typedef struct
+{
+   uint32_t au32StatusWord[4];
+} Fapi_FlashStatusWordType;
+
+/**********************************************************************************************************************
+ * FMC REGISTERS
+ *********************************************************************************************************************/
+/* Only the bit fields referenced by the FEE and the simulator are named; the remaining bits are reserved. */
+typedef union
+{
+   volatile uint32_t u32Register;
+   struct
+   {
+      uint32_t EDACEN      : 4;
+      uint32_t EZCV        : 1;
+      uint32_t EOCV        : 1;
+      uint32_t             : 26;
+   } FEDACCTRL1_BITS;
+   struct
+   {
+      uint32_t EMU_ECC     : 8;
+      uint32_t             : 24;
+   } FEMU_ECC_BITS;
+   struct
+   {
+      uint32_t             : 16;
+      uint32_t AutoCalc_EN : 1;
+      uint32_t             : 15;
+   } FTCTRL_BITS;
+   struct
+   {
+      uint32_t FSMCMD      : 6;
+      uint32_t             : 26;
+   } FSM_COMMAND_BITS;
+   struct
+   {
+      uint32_t FSMEXECUTE  : 5;
+      uint32_t             : 11;
+      uint32_t SUSPEND_NOW : 4;
+      uint32_t             : 12;
+   } FSM_EXECUTE_BITS;
+   struct
+   {
+      uint32_t EE_EDACEN   : 4;
+      uint32_t EE_ALL0_OK  : 1;
+      uint32_t EE_ALL1_OK  : 1;
+      uint32_t             : 2;
+      uint32_t EE_EDACMODE : 4;
+      uint32_t             : 20;
+   } EE_CTRL1_BITS;
+   struct
+   {
+      uint32_t COR_ERR_ADD : 32;
+   } EE_COR_ERR_ADD_BITS;
+   struct
+   {
+      uint32_t EE_CME      : 1;
+      uint32_t EE_D_COR_ERR: 1;
+      uint32_t             : 2;
+      uint32_t EE_CMG      : 1;
+      uint32_t             : 3;
+      uint32_t EE_UNC_ERR  : 1;
+      uint32_t             : 23;
+   } EE_STATUS_BITS;
+   struct
+   {
+      uint32_t UNC_ERR_ADD : 32;
+   } EE_UNC_ERR_ADD_BITS;
+} Fapi_FmcRegisterType;
+
+/* Register block at F021_CPU0_BASE_ADDRESS, laid out at the device offsets. */
+typedef struct
+{
+   Fapi_FmcRegisterType FrdCntl;          /* 0x000 */
+   uint32_t au32Reserved0[1];
+   Fapi_FmcRegisterType FedAcCtrl1;       /* 0x008 */
+   Fapi_FmcRegisterType FedAcCtrl2;       /* 0x00C */
+   Fapi_FmcRegisterType FcorErrCnt;       /* 0x010 */
+   Fapi_FmcRegisterType FcorErrAdd;       /* 0x014 */
+   Fapi_FmcRegisterType FcorErrPos;       /* 0x018 */
+   Fapi_FmcRegisterType FedAcStatus;      /* 0x01C */
+   Fapi_FmcRegisterType FuncErrAdd;       /* 0x020 */
+   uint32_t au32Reserved1[3];
+   Fapi_FmcRegisterType Fbprot;           /* 0x030 */
+   Fapi_FmcRegisterType Fbse;             /* 0x034 */
+   Fapi_FmcRegisterType Fbbusy;           /* 0x038 */
+   uint32_t au32Reserved2[6];
+   Fapi_FmcRegisterType Fmstat;           /* 0x054 */
+   Fapi_FmcRegisterType FemuDmsw;         /* 0x058 */
+   Fapi_FmcRegisterType FemuDlsw;         /* 0x05C */
+   Fapi_FmcRegisterType FemuEcc;          /* 0x060 */
+   uint32_t au32Reserved3[1];
+   Fapi_FmcRegisterType FemuAddr;         /* 0x068 */
+   uint32_t au32Reserved4[40];
+   Fapi_FmcRegisterType Ftctrl;           /* 0x10C */
+   Fapi_FmcRegisterType Faddr;            /* 0x110 */
+   uint32_t au32Reserved5[3];
+   Fapi_FmcRegisterType FwpWrite[8];      /* 0x120 */
+   Fapi_FmcRegisterType FwpWriteEcc;      /* 0x140 */
+   uint32_t au32Reserved6[50];
+   Fapi_FmcRegisterType FsmCommand;       /* 0x20C */
+   uint32_t au32Reserved7[31];
+   Fapi_FmcRegisterType FsmWrEna;         /* 0x288 */
+   uint32_t au32Reserved8[10];
+   Fapi_FmcRegisterType FsmExecute;       /* 0x2B4 */
+   uint32_t au32Reserved9[20];
+   Fapi_FmcRegisterType EeCtrl1;          /* 0x308 */
+   Fapi_FmcRegisterType EeCtrl2;          /* 0x30C */
+   Fapi_FmcRegisterType EeCorErrCnt;      /* 0x310 */
+   Fapi_FmcRegisterType EeCorErrAdd;      /* 0x314 */
+   Fapi_FmcRegisterType EeCorErrPos;      /* 0x318 */
+   Fapi_FmcRegisterType EeStatus;         /* 0x31C */
+   Fapi_FmcRegisterType EeUncErrAdd;      /* 0x320 */
+   uint32_t au32Reserved10[55];
+   Fapi_FmcRegisterType FcfgBank;         /* 0x400 */
+} Fapi_FmcRegistersType;
+
+typedef volatile uint8_t  FwpWriteByteAccessorType;
+typedef volatile uint32_t FwpWriteDWordAccessorType;
+
+/**********************************************************************************************************************
+ * ADDRESSES AND ACCESSORS
+ *********************************************************************************************************************/
+/* The register block is a host variable rather than the page at 0xFFF87000, which a 32-bit Linux process
+   shares with its stack. TI_FEE_GET_DEVICE_TYPE (only used with TI_FEE_GENERATE_DEVICEANDVIRTUALSECTORSTRUC)
+   still reads the device address and is therefore not supported by the simulation. */
+extern Fapi_FmcRegistersType Fapi_Sim_oRegisters;
+
+#define F021_CPU0_BASE_ADDRESS              (&Fapi_Sim_oRegisters)
+
+/* FMSTAT bits reported by the simulated FSM */
+#define F021_FMSTAT_CSTAT                   0x00000010U
+#define F021_FMSTAT_INVDAT                  0x00000020U
+#define F021_FMSTAT_PGM                     0x00000040U
+#define F021_FMSTAT_ERS                     0x00000080U
+#define F021_FMSTAT_BUSY                    0x00000100U
+#define F021_FMSTAT_ESUSP                   0x00000004U
+
+#define FWPWRITE_BYTE_ACCESSOR_ADDRESS      ((FwpWriteByteAccessorType *)&Fapi_Sim_oRegisters.FwpWrite[0])
+#define FWPWRITE_DWORD_ACCESSOR_ADDRESS     ((FwpWriteDWordAccessorType *)&Fapi_Sim_oRegisters.FwpWrite[0])
+#define FWPWRITE_ECC_BYTE_ACCESSOR_ADDRESS  ((FwpWriteByteAccessorType *)&Fapi_Sim_oRegisters.FwpWriteEcc)
+
+/* Every access through FLASH_CONTROL_REGISTER first lets the simulated FSM consume the previous register
+   writes (FSMEXECUTE, FEMU_xxx), which is what the wrapper does between two bus accesses on the device. */
+#define FLASH_CONTROL_REGISTER              (Fapi_Sim_ServiceRegisters())
+
+#define FAPI_CHECK_FSM_READY_BUSY           (Fapi_Sim_CheckFsmReadyBusy())
+#define FAPI_GET_FSM_STATUS                 (Fapi_Sim_GetFsmStatus())
+#define FAPI_SUSPEND_FSM                    (Fapi_Sim_SuspendFsm())
+#define FAPI_WRITE_LOCKED_FSM_REGISTER(pu32Register, u32Value) \
+                                            (Fapi_Sim_WriteLockedFsmRegister((pu32Register), (u32Value)))
+
+/* RTIFRC0, which TI_FEE_GET_TIMESTAMP reads on the device, is replaced by the virtual time in microseconds. Time only
+   passes in FSM status polls and Fapi_Sim_AdvanceTime, so steps are measured by the flash time they wait for. */
+#define TI_FEE_GET_TIMESTAMP()              (Fapi_Sim_GetTimestamp())
+
+/* The ECC sweep (TI_FEE_ECC_SWEEP) reads through the simulator, which checks the ECC of the double word like the 
+   wrapper does on a device read, and clears the error flags with write-1-to-clear semantics. Bank 0 would be the 
+   host's page zero and is not simulated, so only the four sectors of bank 7 are swept. */
+#define TI_FEE_ECC_SWEEP_READ(u32Address)   (Fapi_Sim_ReadDoubleWord(u32Address))
+#define TI_FEE_CLEAR_ERROR_STATUS(pu32Register, u32Flags) \
+                                            (Fapi_Sim_ClearErrorStatus((pu32Register), (u32Flags)))
+#define TI_FEE_ECC_SWEEP_SECTOR_LIST        {{Fapi_FlashBank7, 0xF0200000U, 0x00001000U}, \
+                                             {Fapi_FlashBank7, 0xF0201000U, 0x00001000U}, \
+                                             {Fapi_FlashBank7, 0xF0202000U, 0x00001000U}, \
+                                             {Fapi_FlashBank7, 0xF0203000U, 0x00001000U}}
+#define TI_FEE_ECC_SWEEP_SECTORS            4U
+
+/**********************************************************************************************************************
+ * FAPI FUNCTIONS
+ *********************************************************************************************************************/
+extern Fapi_StatusType Fapi_initializeFlashBanks(uint32_t u32HclkFrequency);
+extern Fapi_StatusType Fapi_setActiveFlashBank(Fapi_FlashBankType oNewFlashBank);
+extern Fapi_StatusType Fapi_enableEepromBankSectors(uint32_t u32SectorsEnables_31_0, uint32_t u32SectorsEnables_63_32);
+extern Fapi_StatusType Fapi_issueAsyncCommand(Fapi_FlashStateCommandsType oCommand);
+extern Fapi_StatusType Fapi_issueAsyncCommandWithAddress(Fapi_FlashStateCommandsType oCommand,
+                                                         uint32_t * pu32StartAddress);
+extern Fapi_StatusType Fapi_doBlankCheck(uint32_t * pu32StartAddress, uint32_t u32Length,
+                                         Fapi_FlashStatusWordType * poFlashStatusWord);
+extern Fapi_StatusType Fapi_serviceWatchdogTimer(void);
+
+/* Simulator hooks behind the register macros above */
+extern Fapi_FmcRegistersType * Fapi_Sim_ServiceRegisters(void);
+extern Fapi_StatusType Fapi_Sim_CheckFsmReadyBusy(void);
+extern uint32_t Fapi_Sim_GetFsmStatus(void);
+extern void Fapi_Sim_SuspendFsm(void);
+extern void Fapi_Sim_WriteLockedFsmRegister(volatile uint32_t * pu32Register, uint32_t u32Value);
+extern uint32_t Fapi_Sim_GetTimestamp(void);
+extern void Fapi_Sim_ReadDoubleWord(uint32_t u32Address);
+extern void Fapi_Sim_ClearErrorStatus(volatile uint32_t * pu32Register, uint32_t u32Flags);
+
+#endif /* F021_H_ */
+
+/**********************************************************************************************************************
+ *  END OF FILE: F021.h
+ *********************************************************************************************************************/
@@ -0,0 +1,159 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  Fapi_Sim.h
+ *      Project:  Host simulation of the F021 Flash API
+ *       Module:  FEE
+ *    Generator:  None
+ *
+ *  Description:  Control interface of the simulated bank 7 (see F021.h for the Fapi side).
+ *
+ *                The simulation maps the four 4 KB sectors of Device_TMS570LS04.c at 0xF0200000 and their ECC at
+ *                0xF0100000, so the FEE driver dereferences the same addresses it uses on the device. The driver
+ *                keeps addresses in uint32 variables, hence the host build has to be a 32-bit build:
+ *
+ *                gcc -m32 -std=c99 -Isim/include -Iinclude sim/source/Fapi_Sim.c sim/source/fee_sim_main.c
+ *                    source/ti_fee_*.c source/Device_TMS570LS04.c source/Fapi_UserDefinedFunctions.c -o fee_sim
+ *
+ *                Model:
+ *                - Program only clears bits. Setting a bit that is already 0 is reported as INVDAT in FMSTAT.
+ *                - A program command writes the 16 byte FWPWRITE row at FADDR, then FWPWRITE returns to all ones.
+ *                  Double words the command did not load are left alone.
+ *                - Sector erase sets data and ECC to 0xFF and takes Fapi_SimConfigType.u32EraseTimeUs.
+ *                - Time is virtual. Every FSM status poll costs u32PollTimeUs, and the host adds the time spent
+ *                  outside the driver with Fapi_Sim_AdvanceTime(). Runs are therefore deterministic.
+ *                - ECC is a Hamming SECDED code over each 64-bit double word. It is not the device code matrix,
+ *                  so a reprogrammed double word stores the code of the resulting data instead of the AND of
+ *                  both codes.
+ *                - Flash reads are plain host loads and are not corrected. Injected bit errors are reported
+ *                  through EE_STATUS/EE_xxx_ERR_ADD when injected and stay latched until the next power cycle.
+ *                  Upsets are reported when the ECC sweep reads the double word (TI_FEE_ECC_SWEEP_READ); the
+ *                  sweep clears the flags with TI_FEE_CLEAR_ERROR_STATUS.
+ *********************************************************************************************************************/
+
+#ifndef FAPI_SIM_H
+#define FAPI_SIM_H
+
+/**********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#include "hal_stdtypes.h"
+#include "F021.h"
+
+/**********************************************************************************************************************
+ * GLOBAL CONSTANT MACROS
+ *********************************************************************************************************************/
+#define FAPI_SIM_BANK_START_ADDRESS     0xF0200000U
+#define FAPI_SIM_ECC_START_ADDRESS      0xF0100000U
+#define FAPI_SIM_NUMBER_OF_SECTORS      4U
+#define FAPI_SIM_SECTOR_SIZE            0x1000U
+#define FAPI_SIM_SECTOR_ECC_SIZE        (FAPI_SIM_SECTOR_SIZE >> 3U)
+
+/* Defaults: program time is Device_NominalWriteTime of Device_TMS570LS04.c */
+#define FAPI_SIM_DEFAULT_PROGRAM_TIME   31U
+#define FAPI_SIM_DEFAULT_ERASE_TIME     200000U
+#define FAPI_SIM_DEFAULT_POLL_TIME      1U
+
+/**********************************************************************************************************************
+ * GLOBAL DATA TYPES AND STRUCTURES
+ *********************************************************************************************************************/
+typedef struct
+{
+	uint32 u32ProgramTimeUs;        /* Duration of one 64-bit program command */
+	uint32 u32EraseTimeUs;          /* Duration of one sector erase */
+	uint32 u32PollTimeUs;           /* Virtual time charged for every FSM status poll */
+	uint32 u32Seed;                 /* Seed for the bit pattern of interrupted operations */
+} Fapi_SimConfigType;
+
+typedef enum
+{
+	Fapi_SimFault_None,
+	Fapi_SimFault_ProgramFail,      /* Program command leaves the double word untouched and sets CSTAT */
+	Fapi_SimFault_EraseFail,        /* Erase command leaves the sector partially erased and sets CSTAT */
+	Fapi_SimFault_PowerLoss         /* Operation is cut in the middle and all further commands are ignored */
+} Fapi_SimFaultType;
+
+typedef struct
+{
+	uint32 u32ProgramCount;         /* Program commands executed */
+	uint32 u32EraseCount;           /* Sector erases executed */
+	uint32 au32SectorEraseCount[FAPI_SIM_NUMBER_OF_SECTORS];
+	uint32 u32StatusPolls;          /* FSM status reads, busy or not */
+	uint32 u32BusyPolls;            /* FSM status reads that returned busy */
+	uint32 u32InvalidDataCount;     /* Program commands that tried to set a cleared bit */
+	uint32 u32RejectedCommands;     /* Commands outside an enabled sector, while busy or after power loss */
+	uint32 u32InjectedFaults;       /* Scheduled faults that fired plus injected bit errors */
+	uint64 u64TimeUs;               /* Virtual time since Fapi_Sim_Init */
+} Fapi_SimCountersType;
+
+/**********************************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ *********************************************************************************************************************/
+/** @fn boolean Fapi_Sim_Init(const Fapi_SimConfigType * poConfig)
+*   @brief Maps the simulated bank and ECC, erases them and resets FSM, registers and counters.
+*   @param[in] poConfig Timing and seed, NULL_PTR selects the defaults above.
+*   @return TRUE if the bank could be mapped at its device address.
+*/
+boolean Fapi_Sim_Init(const Fapi_SimConfigType * poConfig);
+
+/** @fn void Fapi_Sim_PowerCycle(void)
+*   @brief Models a reset: aborts the running command, clears registers, faults and the power loss state.
+*          Flash contents survive.
+*/
+void Fapi_Sim_PowerCycle(void);
+
+/** @fn void Fapi_Sim_AdvanceTime(uint32 u32TimeUs)
+*   @brief Lets virtual time pass, e.g. the period between two TI_Fee_MainFunction calls.
+*/
+void Fapi_Sim_AdvanceTime(uint32 u32TimeUs);
+
+/** @fn void Fapi_Sim_StopTimestamp(boolean bStopped)
+*   @brief Freezes the timestamp of TI_FEE_GET_TIMESTAMP at the current virtual time, like an RTI counter that was
+*          never started, or lets it follow the virtual time again. Flash timing is not affected.
+*/
+void Fapi_Sim_StopTimestamp(boolean bStopped);
+
+/** @fn void Fapi_Sim_ScheduleFault(Fapi_SimFaultType oFault, uint32 u32Operation)
+*   @brief Arms a fault for the u32Operation-th program or erase command from now, 1 being the next one.
+*/
+void Fapi_Sim_ScheduleFault(Fapi_SimFaultType oFault, uint32 u32Operation);
+
+/** @fn boolean Fapi_Sim_IsPowerLost(void)
+*   @brief Returns TRUE once a scheduled power loss has fired, until Fapi_Sim_PowerCycle.
+*/
+boolean Fapi_Sim_IsPowerLost(void);
+
+/** @fn void Fapi_Sim_InjectBitError(uint32 u32Address, uint8 u8BitMask)
+*   @brief Flips the bits of u8BitMask in the flash byte at u32Address without touching its ECC.
+*          One flipped bit per double word is a correctable error, more are uncorrectable.
+*/
+void Fapi_Sim_InjectBitError(uint32 u32Address, uint8 u8BitMask);
+
+/** @fn void Fapi_Sim_UpsetBits(uint32 u32Address, uint8 u8BitMask)
+*   @brief Flips the bits of u8BitMask like Fapi_Sim_InjectBitError, but leaves the error to be reported by the next
+*          read through Fapi_Sim_ReadDoubleWord, like an upset in the field that is found by a scan.
+*/
+void Fapi_Sim_UpsetBits(uint32 u32Address, uint8 u8BitMask);
+
+/** @fn uint32 Fapi_Sim_CheckEcc(uint32 * pu32FirstErrorAddress)
+*   @brief Compares the stored ECC of every written double word with its data.
+*   @param[out] pu32FirstErrorAddress Address of the first mismatch, may be NULL_PTR.
+*   @return Number of double words whose ECC does not match.
+*/
+uint32 Fapi_Sim_CheckEcc(uint32 * pu32FirstErrorAddress);
+
+/** @fn void Fapi_Sim_GetCounters(Fapi_SimCountersType * poCounters)
+*   @brief Copies the operation counters and the virtual time.
+*/
+void Fapi_Sim_GetCounters(Fapi_SimCountersType * poCounters);
+
+/** @fn void Fapi_Sim_ResetCounters(void)
+*   @brief Clears the operation counters, virtual time keeps running.
+*/
+void Fapi_Sim_ResetCounters(void);
+
+#endif /* FAPI_SIM_H */
+
+/**********************************************************************************************************************
+ *  END OF FILE: Fapi_Sim.h
+ *********************************************************************************************************************/
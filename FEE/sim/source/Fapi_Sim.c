@@ -0,0 +1,1112 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  Fapi_Sim.c
+ *      Project:  Host simulation of the F021 Flash API
+ *       Module:  FEE
+ *    Generator:  None
+ *
+ *  Description:  Simulated F021 bank 7 behind the Fapi functions and FMC registers used by the FEE driver.
+ *                See Fapi_Sim.h for the model and the host build.
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#define _GNU_SOURCE
+#include <string.h>
+#include <sys/mman.h>
+#include "Fapi_Sim.h"
+
+/**********************************************************************************************************************
+ * LOCAL CONSTANT MACROS
+ *********************************************************************************************************************/
+#define FAPI_SIM_BANK_SIZE          (FAPI_SIM_NUMBER_OF_SECTORS * FAPI_SIM_SECTOR_SIZE)
+#define FAPI_SIM_ECC_SIZE           (FAPI_SIM_NUMBER_OF_SECTORS * FAPI_SIM_SECTOR_ECC_SIZE)
+#define FAPI_SIM_PAGE_SIZE          0x1000U
+#define FAPI_SIM_ALL_SECTORS        ((1U << FAPI_SIM_NUMBER_OF_SECTORS) - 1U)
+
+/* FSM_EXECUTE values: 0x15 starts the command in FSM_COMMAND, 0x0A is the idle value */
+#define FAPI_SIM_FSM_EXECUTE        0x15U
+#define FAPI_SIM_FSM_EXECUTE_IDLE   0x0AU
+/* FSM_WR_ENA value that unlocks the FSM registers */
+#define FAPI_SIM_FSM_WR_ENABLE      0x5U
+
+/**********************************************************************************************************************
+ * LOCAL DATA TYPES AND STRUCTURES
+ *********************************************************************************************************************/
+typedef enum
+{
+	FAPI_SIM_IDLE,
+	FAPI_SIM_PROGRAM,
+	FAPI_SIM_ERASE
+} Fapi_SimStateType;
+
+typedef struct
+{
+	Fapi_SimConfigType oConfig;
+	Fapi_SimCountersType oCounters;
+	Fapi_SimStateType oState;
+	uint64 u64DoneTime;                 /* Virtual time the running command completes */
+	uint32 u32Address;                  /* 16 byte row being programmed */
+	uint8 au8Data[16];                  /* Latched FWPWRITE data */
+	uint8 au8Ecc[2];                    /* Latched FWPWRITE_ECC, one byte per double word */
+	uint32 u32EraseSectors;             /* Sectors of the running or suspended erase */
+	boolean bEraseSuspended;
+	uint32 u32SuspendedRemainingUs;
+	uint32 u32SectorEnables;            /* Set by Fapi_enableEepromBankSectors */
+	boolean bBankActive;
+	Fapi_SimFaultType oPendingFault;
+	uint32 u32FaultCountdown;
+	Fapi_SimFaultType oRunningFault;    /* Fault that fires when the running command completes */
+	boolean bPowerLost;
+	uint32 u32Random;
+	boolean bTimestampStopped;
+	uint32 u32StoppedTimestamp;         /* Value of the timestamp while it is stopped */
+} Fapi_SimType;
+
+/**********************************************************************************************************************
+ * GLOBAL DATA
+ *********************************************************************************************************************/
+Fapi_FmcRegistersType Fapi_Sim_oRegisters;
+
+/**********************************************************************************************************************
+ * LOCAL DATA
+ *********************************************************************************************************************/
+static Fapi_SimType Fapi_Sim;
+static uint8 * const Fapi_Sim_pu8Bank = (uint8 *)FAPI_SIM_BANK_START_ADDRESS;
+static uint8 * const Fapi_Sim_pu8Ecc = (uint8 *)FAPI_SIM_ECC_START_ADDRESS;
+/* Contribution of each data byte to the check bits, indexed by byte position and value */
+static uint8 Fapi_Sim_au8EccTable[8][256];
+
+/**********************************************************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *********************************************************************************************************************/
+static void FapiSim_BuildEccTable(void);
+static uint8 FapiSim_ComputeEcc(const volatile uint8 * pu8Data);
+static uint32 FapiSim_Random(void);
+static void FapiSim_ResetRegisters(void);
+static boolean FapiSim_TakeFault(Fapi_SimFaultType * poFault);
+static void FapiSim_StartProgram(uint32 u32Address);
+static Fapi_StatusType FapiSim_StartErase(uint32 u32Sectors);
+static void FapiSim_ProgramDoubleWord(uint32 u32Offset, const uint8 * pu8Data, uint8 u8Ecc, uint8 u8BitMask);
+static void FapiSim_ProgramRow(uint8 u8BitMask);
+static void FapiSim_EraseSectors(uint32 u32Sectors, boolean bPartial);
+static void FapiSim_Complete(void);
+static void FapiSim_Tick(uint32 u32TimeUs);
+static void FapiSim_LosePower(void);
+static boolean FapiSim_FlipBits(uint32 u32Address, uint8 u8BitMask);
+static uint32 FapiSim_CountErrors(uint32 u32DoubleWord);
+static void FapiSim_LatchErrors(uint32 u32DoubleWord, uint32 u32Errors);
+
+/**********************************************************************************************************************
+ *  FapiSim_BuildEccTable
+ *********************************************************************************************************************/
+/*! \brief      Builds the byte tables of a Hamming(72,64) SECDED code. Data bit n takes the n-th codeword
+ *              position that is not a power of two, check bit k covers the positions with bit k set and
+ *              check bit 7 is the overall parity.
+ *  \param[in]  none
+ *  \return     none
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_BuildEccTable(void)
+{
+	uint8 au8BitCode[64];
+	uint32 u32Position = 3U;
+	uint32 u32Bit;
+	uint32 u32Byte;
+	uint32 u32Value;
+
+	for(u32Bit = 0U; u32Bit < 64U; u32Bit++)
+	{
+		while((u32Position & (u32Position - 1U)) == 0U)
+		{
+			u32Position++;
+		}
+		/* Check bits 0..6 from the position, bit 7 collects the parity of data and check bits */
+		au8BitCode[u32Bit] = (uint8)(u32Position & 0x7FU);
+		u32Value = u32Position & 0x7FU;
+		u32Value ^= u32Value >> 4U;
+		u32Value ^= u32Value >> 2U;
+		u32Value ^= u32Value >> 1U;
+		if((u32Value & 1U) == 0U)
+		{
+			/* Even number of check bits: the data bit itself makes the overall parity odd */
+			au8BitCode[u32Bit] |= 0x80U;
+		}
+		u32Position++;
+	}
+
+	for(u32Byte = 0U; u32Byte < 8U; u32Byte++)
+	{
+		for(u32Value = 0U; u32Value < 256U; u32Value++)
+		{
+			uint8 u8Code = 0U;
+			for(u32Bit = 0U; u32Bit < 8U; u32Bit++)
+			{
+				if((u32Value & (1U << u32Bit)) != 0U)
+				{
+					u8Code ^= au8BitCode[(u32Byte * 8U) + u32Bit];
+				}
+			}
+			Fapi_Sim_au8EccTable[u32Byte][u32Value] = u8Code;
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_ComputeEcc
+ *********************************************************************************************************************/
+/*! \brief      Returns the check byte of the double word at pu8Data (address order).
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static uint8 FapiSim_ComputeEcc(const volatile uint8 * pu8Data)
+{
+	uint8 u8Ecc = 0U;
+	uint32 u32Byte;
+
+	for(u32Byte = 0U; u32Byte < 8U; u32Byte++)
+	{
+		u8Ecc ^= Fapi_Sim_au8EccTable[u32Byte][pu8Data[u32Byte]];
+	}
+	return(u8Ecc);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_Random
+ *********************************************************************************************************************/
+/*! \brief      Deterministic pseudo random numbers for interrupted operations.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static uint32 FapiSim_Random(void)
+{
+	Fapi_Sim.u32Random = (Fapi_Sim.u32Random * 1664525U) + 1013904223U;
+	return(Fapi_Sim.u32Random >> 8U);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_ResetRegisters
+ *********************************************************************************************************************/
+/*! \brief      Puts the FMC registers into their reset state.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_ResetRegisters(void)
+{
+	(void)memset((void *)&Fapi_Sim_oRegisters, 0, sizeof(Fapi_Sim_oRegisters));
+	Fapi_Sim_oRegisters.FsmExecute.u32Register = FAPI_SIM_FSM_EXECUTE_IDLE;
+	Fapi_Sim_oRegisters.FsmWrEna.u32Register = 0x2U;
+	(void)memset((void *)Fapi_Sim_oRegisters.FwpWrite, 0xFF, sizeof(Fapi_Sim_oRegisters.FwpWrite));
+	(void)memset((void *)&Fapi_Sim_oRegisters.FwpWriteEcc, 0xFF, sizeof(Fapi_Sim_oRegisters.FwpWriteEcc));
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_TakeFault
+ *********************************************************************************************************************/
+/*! \brief      Counts one program or erase command against the armed fault.
+ *  \param[out] poFault The fault for this command.
+ *  \return     TRUE if the fault fires on this command.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static boolean FapiSim_TakeFault(Fapi_SimFaultType * poFault)
+{
+	boolean bFire = FALSE;
+
+	*poFault = Fapi_SimFault_None;
+	if(Fapi_Sim.u32FaultCountdown != 0U)
+	{
+		Fapi_Sim.u32FaultCountdown--;
+		if(Fapi_Sim.u32FaultCountdown == 0U)
+		{
+			*poFault = Fapi_Sim.oPendingFault;
+			Fapi_Sim.oPendingFault = Fapi_SimFault_None;
+			Fapi_Sim.oCounters.u32InjectedFaults++;
+			bFire = TRUE;
+		}
+	}
+	return(bFire);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_ProgramDoubleWord
+ *********************************************************************************************************************/
+/*! \brief      Programs the bits of u8BitMask in every byte of a double word. Bits only go from 1 to 0.
+ *  \param[in]  u32Offset Offset of the double word in the bank.
+ *  \param[in]  pu8Data   Data in address order.
+ *  \param[in]  u8Ecc     Check byte supplied through FWPWRITE_ECC.
+ *  \param[in]  u8BitMask 0xFF for a complete program, a partial mask for an interrupted one.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_ProgramDoubleWord(uint32 u32Offset, const uint8 * pu8Data, uint8 u8Ecc, uint8 u8BitMask)
+{
+	volatile uint8 * pu8Target = &Fapi_Sim_pu8Bank[u32Offset];
+	volatile uint8 * pu8TargetEcc = &Fapi_Sim_pu8Ecc[u32Offset >> 3U];
+	boolean bBlank = (*pu8TargetEcc == 0xFFU) ? TRUE : FALSE;
+	boolean bInvalidData = FALSE;
+	uint32 u32Byte;
+
+	for(u32Byte = 0U; u32Byte < 8U; u32Byte++)
+	{
+		if(((uint8)(~pu8Target[u32Byte]) & pu8Data[u32Byte]) != 0U)
+		{
+			bInvalidData = TRUE;
+		}
+		if(pu8Target[u32Byte] != 0xFFU)
+		{
+			bBlank = FALSE;
+		}
+		pu8Target[u32Byte] &= (uint8)(pu8Data[u32Byte] | (uint8)(~u8BitMask));
+	}
+	if(bInvalidData == TRUE)
+	{
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_INVDAT;
+		Fapi_Sim.oCounters.u32InvalidDataCount++;
+	}
+	if(u8BitMask != 0xFFU)
+	{
+		*pu8TargetEcc &= (uint8)(u8Ecc | (uint8)(~u8BitMask));
+	}
+	else if(bBlank == TRUE)
+	{
+		*pu8TargetEcc = u8Ecc;
+	}
+	else
+	{
+		/* Reprogrammed double word, see Fapi_Sim.h */
+		*pu8TargetEcc = FapiSim_ComputeEcc(pu8Target);
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_ProgramRow
+ *********************************************************************************************************************/
+/*! \brief      Programs the latched row. A double word whose data and check byte are all ones is not touched.
+ *  \param[in]  u8BitMask 0xFF for a complete program, a partial mask for an interrupted one.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_ProgramRow(uint8 u8BitMask)
+{
+	uint32 u32DoubleWord;
+	uint32 u32Byte;
+	uint8 u8And;
+
+	for(u32DoubleWord = 0U; u32DoubleWord < 2U; u32DoubleWord++)
+	{
+		u8And = Fapi_Sim.au8Ecc[u32DoubleWord];
+		for(u32Byte = 0U; u32Byte < 8U; u32Byte++)
+		{
+			u8And &= Fapi_Sim.au8Data[(u32DoubleWord * 8U) + u32Byte];
+		}
+		if(u8And != 0xFFU)
+		{
+			FapiSim_ProgramDoubleWord((Fapi_Sim.u32Address - FAPI_SIM_BANK_START_ADDRESS) + (u32DoubleWord * 8U),
+			                          &Fapi_Sim.au8Data[u32DoubleWord * 8U], Fapi_Sim.au8Ecc[u32DoubleWord], u8BitMask);
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_EraseSectors
+ *********************************************************************************************************************/
+/*! \brief      Erases data and ECC of the sectors in u32Sectors. A partial erase only reaches a random part.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_EraseSectors(uint32 u32Sectors, boolean bPartial)
+{
+	uint32 u32Sector;
+	uint32 u32Length = FAPI_SIM_SECTOR_SIZE;
+
+	for(u32Sector = 0U; u32Sector < FAPI_SIM_NUMBER_OF_SECTORS; u32Sector++)
+	{
+		if((u32Sectors & (1U << u32Sector)) != 0U)
+		{
+			if(bPartial == TRUE)
+			{
+				u32Length = (FapiSim_Random() % FAPI_SIM_SECTOR_SIZE) & ~7U;
+			}
+			(void)memset(&Fapi_Sim_pu8Bank[u32Sector * FAPI_SIM_SECTOR_SIZE], 0xFF, u32Length);
+			(void)memset(&Fapi_Sim_pu8Ecc[u32Sector * FAPI_SIM_SECTOR_ECC_SIZE], 0xFF, u32Length >> 3U);
+			Fapi_Sim.oCounters.u32EraseCount++;
+			Fapi_Sim.oCounters.au32SectorEraseCount[u32Sector]++;
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_LosePower
+ *********************************************************************************************************************/
+/*! \brief      Cuts the running command and stops the FSM until Fapi_Sim_PowerCycle.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_LosePower(void)
+{
+	if(Fapi_Sim.oState == FAPI_SIM_PROGRAM)
+	{
+		FapiSim_ProgramRow((uint8)FapiSim_Random());
+	}
+	else if(Fapi_Sim.oState == FAPI_SIM_ERASE)
+	{
+		FapiSim_EraseSectors(Fapi_Sim.u32EraseSectors, TRUE);
+	}
+	else
+	{
+	}
+	Fapi_Sim.oState = FAPI_SIM_IDLE;
+	Fapi_Sim.bPowerLost = TRUE;
+	/* Leave the FSM ready so the driver does not spin until the host notices */
+	Fapi_Sim_oRegisters.Fmstat.u32Register = 0U;
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_Complete
+ *********************************************************************************************************************/
+/*! \brief      Applies the result of the running command and returns the FSM to ready.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_Complete(void)
+{
+	if(Fapi_Sim.oState == FAPI_SIM_PROGRAM)
+	{
+		if(Fapi_Sim.oRunningFault == Fapi_SimFault_ProgramFail)
+		{
+			Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_CSTAT;
+		}
+		else
+		{
+			FapiSim_ProgramRow(0xFFU);
+		}
+		Fapi_Sim.oCounters.u32ProgramCount++;
+	}
+	else if(Fapi_Sim.oState == FAPI_SIM_ERASE)
+	{
+		if(Fapi_Sim.oRunningFault == Fapi_SimFault_EraseFail)
+		{
+			FapiSim_EraseSectors(Fapi_Sim.u32EraseSectors, TRUE);
+			Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_CSTAT;
+		}
+		else
+		{
+			FapiSim_EraseSectors(Fapi_Sim.u32EraseSectors, FALSE);
+		}
+		Fapi_Sim.u32EraseSectors = 0U;
+	}
+	else
+	{
+	}
+	Fapi_Sim.oState = FAPI_SIM_IDLE;
+	Fapi_Sim.oRunningFault = Fapi_SimFault_None;
+	Fapi_Sim_oRegisters.Fmstat.u32Register &= ~(F021_FMSTAT_BUSY | F021_FMSTAT_PGM | F021_FMSTAT_ERS);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_Tick
+ *********************************************************************************************************************/
+/*! \brief      Advances virtual time and completes the running command when its time is up.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_Tick(uint32 u32TimeUs)
+{
+	Fapi_Sim.oCounters.u64TimeUs += u32TimeUs;
+	if((Fapi_Sim.oState != FAPI_SIM_IDLE) && (Fapi_Sim.oCounters.u64TimeUs >= Fapi_Sim.u64DoneTime))
+	{
+		FapiSim_Complete();
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_StartProgram
+ *********************************************************************************************************************/
+/*! \brief      Latches FWPWRITE and starts programming the 16 byte row containing u32Address. The buffer returns
+ *              to all ones, so bytes a command does not load leave the flash unchanged.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_StartProgram(uint32 u32Address)
+{
+	uint32 u32Offset = u32Address - FAPI_SIM_BANK_START_ADDRESS;
+	uint32 u32Sector = u32Offset / FAPI_SIM_SECTOR_SIZE;
+	uint32 u32Byte;
+	Fapi_SimFaultType oFault;
+
+	if((Fapi_Sim.bPowerLost == TRUE) || (Fapi_Sim.oState != FAPI_SIM_IDLE) || (Fapi_Sim.bBankActive == FALSE) ||
+	   (u32Address < FAPI_SIM_BANK_START_ADDRESS) || (u32Offset >= FAPI_SIM_BANK_SIZE) ||
+	   ((Fapi_Sim.u32SectorEnables & (1U << u32Sector)) == 0U) ||
+	   ((Fapi_Sim.bEraseSuspended == TRUE) && ((Fapi_Sim.u32EraseSectors & (1U << u32Sector)) != 0U)))
+	{
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_CSTAT;
+		Fapi_Sim.oCounters.u32RejectedCommands++;
+	}
+	else
+	{
+		Fapi_Sim.u32Address = u32Address & ~0xFU;
+		for(u32Byte = 0U; u32Byte < 16U; u32Byte++)
+		{
+			Fapi_Sim.au8Data[u32Byte] = ((volatile uint8 *)Fapi_Sim_oRegisters.FwpWrite)[u32Byte];
+		}
+		Fapi_Sim.au8Ecc[0] = ((volatile uint8 *)&Fapi_Sim_oRegisters.FwpWriteEcc)[0];
+		Fapi_Sim.au8Ecc[1] = ((volatile uint8 *)&Fapi_Sim_oRegisters.FwpWriteEcc)[1];
+		(void)memset((void *)Fapi_Sim_oRegisters.FwpWrite, 0xFF, sizeof(Fapi_Sim_oRegisters.FwpWrite));
+		(void)memset((void *)&Fapi_Sim_oRegisters.FwpWriteEcc, 0xFF, sizeof(Fapi_Sim_oRegisters.FwpWriteEcc));
+		Fapi_Sim.oState = FAPI_SIM_PROGRAM;
+		Fapi_Sim.u64DoneTime = Fapi_Sim.oCounters.u64TimeUs + Fapi_Sim.oConfig.u32ProgramTimeUs;
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= (F021_FMSTAT_BUSY | F021_FMSTAT_PGM);
+		if(FapiSim_TakeFault(&oFault) == TRUE)
+		{
+			if(oFault == Fapi_SimFault_PowerLoss)
+			{
+				FapiSim_LosePower();
+			}
+			else if(oFault == Fapi_SimFault_ProgramFail)
+			{
+				Fapi_Sim.oRunningFault = oFault;
+			}
+			else
+			{
+			}
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_StartErase
+ *********************************************************************************************************************/
+/*! \brief      Starts erasing the sectors in u32Sectors.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static Fapi_StatusType FapiSim_StartErase(uint32 u32Sectors)
+{
+	Fapi_StatusType oStatus = Fapi_Status_Success;
+	Fapi_SimFaultType oFault;
+	uint32 u32Sector;
+	uint32 u32Time = 0U;
+
+	if(Fapi_Sim.oState != FAPI_SIM_IDLE)
+	{
+		oStatus = Fapi_Status_FsmBusy;
+		Fapi_Sim.oCounters.u32RejectedCommands++;
+	}
+	else if((Fapi_Sim.bBankActive == FALSE) || (Fapi_Sim.bEraseSuspended == TRUE) ||
+	        ((u32Sectors & Fapi_Sim.u32SectorEnables) != u32Sectors))
+	{
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_CSTAT;
+		Fapi_Sim.oCounters.u32RejectedCommands++;
+	}
+	else if(Fapi_Sim.bPowerLost == TRUE)
+	{
+		/* Nothing runs any more, the host has to power cycle */
+		Fapi_Sim.oCounters.u32RejectedCommands++;
+	}
+	else
+	{
+		for(u32Sector = 0U; u32Sector < FAPI_SIM_NUMBER_OF_SECTORS; u32Sector++)
+		{
+			if((u32Sectors & (1U << u32Sector)) != 0U)
+			{
+				u32Time += Fapi_Sim.oConfig.u32EraseTimeUs;
+			}
+		}
+		Fapi_Sim.u32EraseSectors = u32Sectors;
+		Fapi_Sim.oState = FAPI_SIM_ERASE;
+		Fapi_Sim.u64DoneTime = Fapi_Sim.oCounters.u64TimeUs + u32Time;
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= (F021_FMSTAT_BUSY | F021_FMSTAT_ERS);
+		if(FapiSim_TakeFault(&oFault) == TRUE)
+		{
+			if(oFault == Fapi_SimFault_PowerLoss)
+			{
+				FapiSim_LosePower();
+			}
+			else if(oFault == Fapi_SimFault_EraseFail)
+			{
+				Fapi_Sim.oRunningFault = oFault;
+			}
+			else
+			{
+			}
+		}
+	}
+	return(oStatus);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_ServiceRegisters
+ *********************************************************************************************************************/
+/*! \brief      Consumes the register writes since the last access: updates the wrapper ECC of FEMU_DxSW and
+ *              starts the command in FSM_COMMAND if FSM_EXECUTE was written.
+ *  \return     The register block.
+ *  \note       Reached through FLASH_CONTROL_REGISTER.
+ *********************************************************************************************************************/
+Fapi_FmcRegistersType * Fapi_Sim_ServiceRegisters(void)
+{
+	uint8 au8Data[8];
+	uint32 u32Low = Fapi_Sim_oRegisters.FemuDlsw.u32Register;
+	uint32 u32High = Fapi_Sim_oRegisters.FemuDmsw.u32Register;
+	uint32 u32Byte;
+
+	for(u32Byte = 0U; u32Byte < 4U; u32Byte++)
+	{
+		au8Data[u32Byte] = (uint8)(u32Low >> (8U * u32Byte));
+		au8Data[u32Byte + 4U] = (uint8)(u32High >> (8U * u32Byte));
+	}
+	Fapi_Sim_oRegisters.FemuEcc.u32Register = FapiSim_ComputeEcc(au8Data);
+
+	if(Fapi_Sim_oRegisters.FsmExecute.FSM_EXECUTE_BITS.FSMEXECUTE == FAPI_SIM_FSM_EXECUTE)
+	{
+		Fapi_Sim_oRegisters.FsmExecute.FSM_EXECUTE_BITS.FSMEXECUTE = FAPI_SIM_FSM_EXECUTE_IDLE;
+		if((Fapi_Sim_oRegisters.FsmWrEna.u32Register & 0x7U) != FAPI_SIM_FSM_WR_ENABLE)
+		{
+			Fapi_Sim.oCounters.u32RejectedCommands++;
+		}
+		else if(Fapi_Sim_oRegisters.FsmCommand.FSM_COMMAND_BITS.FSMCMD == (uint32)Fapi_ClearStatus)
+		{
+			Fapi_Sim_oRegisters.Fmstat.u32Register &= (F021_FMSTAT_BUSY | F021_FMSTAT_PGM | F021_FMSTAT_ERS |
+			                                           F021_FMSTAT_ESUSP);
+		}
+		else if(Fapi_Sim_oRegisters.FsmCommand.FSM_COMMAND_BITS.FSMCMD == (uint32)Fapi_ProgramData)
+		{
+			FapiSim_StartProgram(Fapi_Sim_oRegisters.Faddr.u32Register);
+		}
+		else
+		{
+			Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_CSTAT;
+			Fapi_Sim.oCounters.u32RejectedCommands++;
+		}
+	}
+	return(&Fapi_Sim_oRegisters);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_GetFsmStatus
+ *********************************************************************************************************************/
+/*! \brief      FMSTAT read. Every read costs u32PollTimeUs of virtual time.
+ *  \note       Reached through FAPI_GET_FSM_STATUS.
+ *********************************************************************************************************************/
+uint32_t Fapi_Sim_GetFsmStatus(void)
+{
+	(void)Fapi_Sim_ServiceRegisters();
+	FapiSim_Tick(Fapi_Sim.oConfig.u32PollTimeUs);
+	Fapi_Sim.oCounters.u32StatusPolls++;
+	if((Fapi_Sim_oRegisters.Fmstat.u32Register & F021_FMSTAT_BUSY) != 0U)
+	{
+		Fapi_Sim.oCounters.u32BusyPolls++;
+	}
+	return(Fapi_Sim_oRegisters.Fmstat.u32Register);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_CheckFsmReadyBusy
+ *********************************************************************************************************************/
+/*! \brief      FMSTAT.BUSY read.
+ *  \note       Reached through FAPI_CHECK_FSM_READY_BUSY.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_Sim_CheckFsmReadyBusy(void)
+{
+	return(((Fapi_Sim_GetFsmStatus() & F021_FMSTAT_BUSY) != 0U) ? Fapi_Status_FsmBusy : Fapi_Status_FsmReady);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_SuspendFsm
+ *********************************************************************************************************************/
+/*! \brief      Suspends a running erase. Programs are too short to be suspended and finish first.
+ *  \note       Reached through FAPI_SUSPEND_FSM.
+ *********************************************************************************************************************/
+void Fapi_Sim_SuspendFsm(void)
+{
+	if(Fapi_Sim.oState == FAPI_SIM_PROGRAM)
+	{
+		FapiSim_Tick((uint32)(Fapi_Sim.u64DoneTime - Fapi_Sim.oCounters.u64TimeUs));
+	}
+	else if(Fapi_Sim.oState == FAPI_SIM_ERASE)
+	{
+		Fapi_Sim.u32SuspendedRemainingUs = (uint32)(Fapi_Sim.u64DoneTime - Fapi_Sim.oCounters.u64TimeUs);
+		Fapi_Sim.bEraseSuspended = TRUE;
+		Fapi_Sim.oState = FAPI_SIM_IDLE;
+		Fapi_Sim_oRegisters.Fmstat.u32Register &= ~(F021_FMSTAT_BUSY | F021_FMSTAT_ERS);
+		Fapi_Sim_oRegisters.Fmstat.u32Register |= F021_FMSTAT_ESUSP;
+	}
+	else
+	{
+	}
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_WriteLockedFsmRegister
+ *********************************************************************************************************************/
+/*! \brief      Write to an FSM register with the FSM_WR_ENA unlock sequence around it.
+ *  \note       Reached through FAPI_WRITE_LOCKED_FSM_REGISTER.
+ *********************************************************************************************************************/
+void Fapi_Sim_WriteLockedFsmRegister(volatile uint32_t * pu32Register, uint32_t u32Value)
+{
+	Fapi_Sim_oRegisters.FsmWrEna.u32Register = FAPI_SIM_FSM_WR_ENABLE;
+	*pu32Register = u32Value;
+	Fapi_Sim_oRegisters.FsmWrEna.u32Register = 0x2U;
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_GetTimestamp
+ *********************************************************************************************************************/
+/*! \brief      Virtual time in microseconds, truncated to 32 bits like RTIFRC0. Reading it takes no time.
+ *  \note       Reached through TI_FEE_GET_TIMESTAMP.
+ *********************************************************************************************************************/
+uint32_t Fapi_Sim_GetTimestamp(void)
+{
+	return((Fapi_Sim.bTimestampStopped == TRUE) ? Fapi_Sim.u32StoppedTimestamp : (uint32_t)Fapi_Sim.oCounters.u64TimeUs);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_StopTimestamp
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_StopTimestamp(boolean bStopped)
+{
+	Fapi_Sim.u32StoppedTimestamp = (uint32)Fapi_Sim.oCounters.u64TimeUs;
+	Fapi_Sim.bTimestampStopped = bStopped;
+}
+
+/**********************************************************************************************************************
+ *  Fapi_initializeFlashBanks
+ *********************************************************************************************************************/
+/*! \brief      Accepts any HCLK frequency; timing comes from Fapi_SimConfigType.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_initializeFlashBanks(uint32_t u32HclkFrequency)
+{
+	(void)u32HclkFrequency;
+	return(Fapi_Status_Success);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_setActiveFlashBank
+ *********************************************************************************************************************/
+/*! \brief      Only bank 7 is simulated.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_setActiveFlashBank(Fapi_FlashBankType oNewFlashBank)
+{
+	Fapi_StatusType oStatus = Fapi_Error_InvalidBank;
+
+	Fapi_Sim.bBankActive = FALSE;
+	if(oNewFlashBank == Fapi_FlashBank7)
+	{
+		Fapi_Sim.bBankActive = TRUE;
+		oStatus = Fapi_Status_Success;
+	}
+	return(oStatus);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_enableEepromBankSectors
+ *********************************************************************************************************************/
+/*! \brief      Sets the sectors that program and erase commands may touch.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_enableEepromBankSectors(uint32_t u32SectorsEnables_31_0, uint32_t u32SectorsEnables_63_32)
+{
+	(void)u32SectorsEnables_63_32;
+	Fapi_Sim.u32SectorEnables = u32SectorsEnables_31_0 & FAPI_SIM_ALL_SECTORS;
+	return(Fapi_Status_Success);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_issueAsyncCommand
+ *********************************************************************************************************************/
+/*! \brief      Supports Fapi_EraseResume and Fapi_ClearStatus.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_issueAsyncCommand(Fapi_FlashStateCommandsType oCommand)
+{
+	Fapi_StatusType oStatus = Fapi_Status_Success;
+
+	if(oCommand == Fapi_EraseResume)
+	{
+		/* Resuming an erase that is not suspended has no effect */
+		if((Fapi_Sim.bEraseSuspended == TRUE) && (Fapi_Sim.oState == FAPI_SIM_IDLE) && (Fapi_Sim.bPowerLost == FALSE))
+		{
+			Fapi_Sim.bEraseSuspended = FALSE;
+			Fapi_Sim.oState = FAPI_SIM_ERASE;
+			Fapi_Sim.u64DoneTime = Fapi_Sim.oCounters.u64TimeUs + Fapi_Sim.u32SuspendedRemainingUs;
+			Fapi_Sim_oRegisters.Fmstat.u32Register &= ~F021_FMSTAT_ESUSP;
+			Fapi_Sim_oRegisters.Fmstat.u32Register |= (F021_FMSTAT_BUSY | F021_FMSTAT_ERS);
+		}
+	}
+	else if(oCommand == Fapi_ClearStatus)
+	{
+		Fapi_Sim_oRegisters.Fmstat.u32Register &= (F021_FMSTAT_BUSY | F021_FMSTAT_PGM | F021_FMSTAT_ERS |
+		                                           F021_FMSTAT_ESUSP);
+	}
+	else
+	{
+		oStatus = Fapi_Error_InvalidCommand;
+	}
+	return(oStatus);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_issueAsyncCommandWithAddress
+ *********************************************************************************************************************/
+/*! \brief      Supports Fapi_EraseSector and Fapi_EraseBank.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_issueAsyncCommandWithAddress(Fapi_FlashStateCommandsType oCommand, uint32_t * pu32StartAddress)
+{
+	Fapi_StatusType oStatus = Fapi_Error_InvalidAddress;
+	uint32 u32Address = (uint32)pu32StartAddress;
+
+	if((u32Address >= FAPI_SIM_BANK_START_ADDRESS) && ((u32Address - FAPI_SIM_BANK_START_ADDRESS) < FAPI_SIM_BANK_SIZE))
+	{
+		if(oCommand == Fapi_EraseSector)
+		{
+			oStatus = FapiSim_StartErase(1U << ((u32Address - FAPI_SIM_BANK_START_ADDRESS) / FAPI_SIM_SECTOR_SIZE));
+		}
+		else if(oCommand == Fapi_EraseBank)
+		{
+			oStatus = FapiSim_StartErase(Fapi_Sim.u32SectorEnables);
+		}
+		else
+		{
+			oStatus = Fapi_Error_InvalidCommand;
+		}
+	}
+	return(oStatus);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_doBlankCheck
+ *********************************************************************************************************************/
+/*! \brief      Checks u32Length words for 0xFFFFFFFF. On failure the status word holds the failing address,
+ *              the data read and the expected data.
+ *********************************************************************************************************************/
+Fapi_StatusType Fapi_doBlankCheck(uint32_t * pu32StartAddress, uint32_t u32Length,
+                                  Fapi_FlashStatusWordType * poFlashStatusWord)
+{
+	Fapi_StatusType oStatus = Fapi_Status_Success;
+	uint32 u32Index;
+
+	for(u32Index = 0U; u32Index < u32Length; u32Index++)
+	{
+		if(pu32StartAddress[u32Index] != 0xFFFFFFFFU)
+		{
+			poFlashStatusWord->au32StatusWord[0] = (uint32)&pu32StartAddress[u32Index];
+			poFlashStatusWord->au32StatusWord[1] = pu32StartAddress[u32Index];
+			poFlashStatusWord->au32StatusWord[2] = 0xFFFFFFFFU;
+			poFlashStatusWord->au32StatusWord[3] = 0U;
+			oStatus = Fapi_Error_Fail;
+			break;
+		}
+	}
+	return(oStatus);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_Init
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+boolean Fapi_Sim_Init(const Fapi_SimConfigType * poConfig)
+{
+	static boolean bMapped = FALSE;
+	boolean bResult = TRUE;
+	void * pvBank;
+	void * pvEcc;
+	/* Shared, so a forked process that models a reboot sees the same flash */
+	int iFlags = MAP_SHARED | MAP_ANONYMOUS;
+
+	#ifdef MAP_FIXED_NOREPLACE
+	iFlags |= MAP_FIXED_NOREPLACE;
+	#endif
+	if(bMapped == FALSE)
+	{
+		/* Without MAP_FIXED_NOREPLACE the addresses are hints and are checked below */
+		pvBank = mmap((void *)FAPI_SIM_BANK_START_ADDRESS, FAPI_SIM_BANK_SIZE, PROT_READ | PROT_WRITE, iFlags, -1, 0);
+		pvEcc = mmap((void *)FAPI_SIM_ECC_START_ADDRESS, FAPI_SIM_PAGE_SIZE, PROT_READ | PROT_WRITE, iFlags, -1, 0);
+		if((pvBank != (void *)Fapi_Sim_pu8Bank) || (pvEcc != (void *)Fapi_Sim_pu8Ecc))
+		{
+			bResult = FALSE;
+		}
+		else
+		{
+			bMapped = TRUE;
+			FapiSim_BuildEccTable();
+		}
+	}
+
+	if(bResult == TRUE)
+	{
+		(void)memset(&Fapi_Sim, 0, sizeof(Fapi_Sim));
+		Fapi_Sim.oConfig.u32ProgramTimeUs = FAPI_SIM_DEFAULT_PROGRAM_TIME;
+		Fapi_Sim.oConfig.u32EraseTimeUs = FAPI_SIM_DEFAULT_ERASE_TIME;
+		Fapi_Sim.oConfig.u32PollTimeUs = FAPI_SIM_DEFAULT_POLL_TIME;
+		Fapi_Sim.oConfig.u32Seed = 1U;
+		if(poConfig != NULL_PTR)
+		{
+			Fapi_Sim.oConfig = *poConfig;
+		}
+		Fapi_Sim.u32Random = Fapi_Sim.oConfig.u32Seed;
+		(void)memset(Fapi_Sim_pu8Bank, 0xFF, FAPI_SIM_BANK_SIZE);
+		(void)memset(Fapi_Sim_pu8Ecc, 0xFF, FAPI_SIM_ECC_SIZE);
+		FapiSim_ResetRegisters();
+	}
+	return(bResult);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_PowerCycle
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_PowerCycle(void)
+{
+	if(Fapi_Sim.oState != FAPI_SIM_IDLE)
+	{
+		FapiSim_LosePower();
+	}
+	else if(Fapi_Sim.bEraseSuspended == TRUE)
+	{
+		/* A suspended erase that is never resumed leaves the sector partially erased */
+		Fapi_Sim.oState = FAPI_SIM_ERASE;
+		FapiSim_LosePower();
+	}
+	else
+	{
+	}
+	Fapi_Sim.bPowerLost = FALSE;
+	Fapi_Sim.bEraseSuspended = FALSE;
+	Fapi_Sim.u32EraseSectors = 0U;
+	Fapi_Sim.bBankActive = FALSE;
+	Fapi_Sim.u32SectorEnables = 0U;
+	Fapi_Sim.oPendingFault = Fapi_SimFault_None;
+	Fapi_Sim.u32FaultCountdown = 0U;
+	Fapi_Sim.oRunningFault = Fapi_SimFault_None;
+	FapiSim_ResetRegisters();
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_AdvanceTime
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_AdvanceTime(uint32 u32TimeUs)
+{
+	FapiSim_Tick(u32TimeUs);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_ScheduleFault
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_ScheduleFault(Fapi_SimFaultType oFault, uint32 u32Operation)
+{
+	Fapi_Sim.oPendingFault = oFault;
+	Fapi_Sim.u32FaultCountdown = (oFault == Fapi_SimFault_None) ? 0U : u32Operation;
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_IsPowerLost
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+boolean Fapi_Sim_IsPowerLost(void)
+{
+	return(Fapi_Sim.bPowerLost);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_FlipBits
+ *********************************************************************************************************************/
+/*! \brief      Flips the bits of u8BitMask in the flash byte at u32Address without touching its ECC.
+ *  \return     TRUE if the address is in the bank and a bit was flipped.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static boolean FapiSim_FlipBits(uint32 u32Address, uint8 u8BitMask)
+{
+	uint32 u32Offset = u32Address - FAPI_SIM_BANK_START_ADDRESS;
+
+	if((u32Address >= FAPI_SIM_BANK_START_ADDRESS) && (u32Offset < FAPI_SIM_BANK_SIZE) && (u8BitMask != 0U))
+	{
+		Fapi_Sim_pu8Bank[u32Offset] ^= u8BitMask;
+		Fapi_Sim.oCounters.u32InjectedFaults++;
+		return(TRUE);
+	}
+	return(FALSE);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_CountErrors
+ *********************************************************************************************************************/
+/*! \brief      Classifies a double word like the bank 7 SECDED logic does on a read.
+ *  \param[in]  u32DoubleWord Offset of the double word in the bank.
+ *  \return     0, 1 for a correctable or 2 for an uncorrectable error.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static uint32 FapiSim_CountErrors(uint32 u32DoubleWord)
+{
+	volatile uint8 * pu8Data = &Fapi_Sim_pu8Bank[u32DoubleWord];
+	uint8 u8Ecc = Fapi_Sim_pu8Ecc[u32DoubleWord >> 3U];
+	uint32 u32Errors = 0U;
+	uint32 u32Byte;
+	uint8 u8Syndrome;
+
+	if(u8Ecc == 0xFFU)
+	{
+		/* Erased double word: every 0 bit is an error */
+		for(u32Byte = 0U; u32Byte < 8U; u32Byte++)
+		{
+			uint8 u8Zeros = (uint8)~pu8Data[u32Byte];
+			while(u8Zeros != 0U)
+			{
+				u8Zeros &= (uint8)(u8Zeros - 1U);
+				u32Errors++;
+			}
+		}
+		u32Errors = (u32Errors > 2U) ? 2U : u32Errors;
+	}
+	else
+	{
+		u8Syndrome = FapiSim_ComputeEcc(pu8Data) ^ u8Ecc;
+		if(u8Syndrome == 0U)
+		{
+			u32Errors = 0U;
+		}
+		else
+		{
+			/* The parity of the syndrome is the parity of the whole 72-bit word: odd for one error */
+			u8Syndrome ^= (uint8)(u8Syndrome >> 4U);
+			u8Syndrome ^= (uint8)(u8Syndrome >> 2U);
+			u8Syndrome ^= (uint8)(u8Syndrome >> 1U);
+			u32Errors = ((u8Syndrome & 1U) != 0U) ? 1U : 2U;
+		}
+	}
+	return(u32Errors);
+}
+
+/**********************************************************************************************************************
+ *  FapiSim_LatchErrors
+ *********************************************************************************************************************/
+/*! \brief      Reports the errors of a double word through EE_STATUS and EE_xxx_ERR_ADD.
+ *  \note       Simulation internal.
+ *********************************************************************************************************************/
+static void FapiSim_LatchErrors(uint32 u32DoubleWord, uint32 u32Errors)
+{
+	if(u32Errors == 1U)
+	{
+		Fapi_Sim_oRegisters.EeStatus.EE_STATUS_BITS.EE_D_COR_ERR = 1U;
+		Fapi_Sim_oRegisters.EeCorErrAdd.u32Register = FAPI_SIM_BANK_START_ADDRESS + u32DoubleWord;
+		Fapi_Sim_oRegisters.EeCorErrCnt.u32Register++;
+	}
+	else if(u32Errors == 2U)
+	{
+		Fapi_Sim_oRegisters.EeStatus.EE_STATUS_BITS.EE_UNC_ERR = 1U;
+		Fapi_Sim_oRegisters.EeUncErrAdd.u32Register = FAPI_SIM_BANK_START_ADDRESS + u32DoubleWord;
+	}
+	else
+	{
+	}
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_ReadDoubleWord
+ *********************************************************************************************************************/
+/*! \brief      Read of the double word at u32Address with the ECC check of the wrapper. Addresses outside the bank
+ *              are ignored.
+ *  \note       Reached through TI_FEE_ECC_SWEEP_READ.
+ *********************************************************************************************************************/
+void Fapi_Sim_ReadDoubleWord(uint32_t u32Address)
+{
+	uint32 u32Offset = u32Address - FAPI_SIM_BANK_START_ADDRESS;
+
+	if((u32Address >= FAPI_SIM_BANK_START_ADDRESS) && (u32Offset < FAPI_SIM_BANK_SIZE))
+	{
+		u32Offset &= ~7U;
+		FapiSim_LatchErrors(u32Offset, FapiSim_CountErrors(u32Offset));
+	}
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_ClearErrorStatus
+ *********************************************************************************************************************/
+/*! \brief      Write-1-to-clear of error flags, e.g. in EE_STATUS.
+ *  \note       Reached through TI_FEE_CLEAR_ERROR_STATUS.
+ *********************************************************************************************************************/
+void Fapi_Sim_ClearErrorStatus(volatile uint32_t * pu32Register, uint32_t u32Flags)
+{
+	*pu32Register &= ~u32Flags;
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_InjectBitError
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h. Classifies the error like the bank 7 SECDED logic would on the next read.
+ *********************************************************************************************************************/
+void Fapi_Sim_InjectBitError(uint32 u32Address, uint8 u8BitMask)
+{
+	uint32 u32DoubleWord = (u32Address - FAPI_SIM_BANK_START_ADDRESS) & ~7U;
+
+	if(FapiSim_FlipBits(u32Address, u8BitMask) == TRUE)
+	{
+		FapiSim_LatchErrors(u32DoubleWord, FapiSim_CountErrors(u32DoubleWord));
+	}
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_UpsetBits
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_UpsetBits(uint32 u32Address, uint8 u8BitMask)
+{
+	(void)FapiSim_FlipBits(u32Address, u8BitMask);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_CheckEcc
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+uint32 Fapi_Sim_CheckEcc(uint32 * pu32FirstErrorAddress)
+{
+	uint32 u32Errors = 0U;
+	uint32 u32Offset;
+	const volatile uint32 * pu32Data;
+
+	for(u32Offset = 0U; u32Offset < FAPI_SIM_BANK_SIZE; u32Offset += 8U)
+	{
+		pu32Data = (const volatile uint32 *)&Fapi_Sim_pu8Bank[u32Offset];
+		if((Fapi_Sim_pu8Ecc[u32Offset >> 3U] == 0xFFU) && (pu32Data[0] == 0xFFFFFFFFU) && (pu32Data[1] == 0xFFFFFFFFU))
+		{
+			/* Erased */
+		}
+		else if(FapiSim_ComputeEcc(&Fapi_Sim_pu8Bank[u32Offset]) != Fapi_Sim_pu8Ecc[u32Offset >> 3U])
+		{
+			if((u32Errors == 0U) && (pu32FirstErrorAddress != NULL_PTR))
+			{
+				*pu32FirstErrorAddress = FAPI_SIM_BANK_START_ADDRESS + u32Offset;
+			}
+			u32Errors++;
+		}
+		else
+		{
+		}
+	}
+	return(u32Errors);
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_GetCounters
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_GetCounters(Fapi_SimCountersType * poCounters)
+{
+	*poCounters = Fapi_Sim.oCounters;
+}
+
+/**********************************************************************************************************************
+ *  Fapi_Sim_ResetCounters
+ *********************************************************************************************************************/
+/*! \brief      See Fapi_Sim.h.
+ *********************************************************************************************************************/
+void Fapi_Sim_ResetCounters(void)
+{
+	uint64 u64TimeUs = Fapi_Sim.oCounters.u64TimeUs;
+
+	(void)memset(&Fapi_Sim.oCounters, 0, sizeof(Fapi_Sim.oCounters));
+	Fapi_Sim.oCounters.u64TimeUs = u64TimeUs;
+}
+
+/**********************************************************************************************************************
+ *  END OF FILE: Fapi_Sim.c
+ *********************************************************************************************************************/
@@ -0,0 +1,1069 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  fee_sim_main.c
+ *      Project:  Host simulation of the F021 Flash API
+ *       Module:  FEE
+ *    Generator:  None
+ *
+ *  Description:  Host driver for the FEE on the simulated bank 7 (build line in Fapi_Sim.h).
+ *
+ *                fee_sim [writes] [power loss trials]
+ *
+ *                1. Benchmark: boots the FEE, writes the first configured block [writes] times (default 2000)
+ *                   and reads it back, then boots again on the filled bank. Reports host time per call,
+ *                   virtual flash time per job and the worst case write latency in main function calls. Each
+ *                   write is followed by FEE_SIM_IDLE_CALLS main function calls for the internal operations; a
+ *                   write which finds the FEE busy waits, and the wait counts as latency. The writes are then
+ *                   repeated with the budget on a stopped timestamp (Fapi_Sim_StopTimestamp), where every main
+ *                   function call has to take a single step.
+ *                2. Checksum: compares TI_FeeInternal_Fletcher16 with the byte wise reference for all
+ *                   alignments and lengths up to 600 bytes, then reports cycles and nanoseconds per byte of both.
+ *                3. Lookup: checks TI_FeeInternal_GetArrayIndex against the linear search it replaced, for every
+ *                   configured block and data set and every copy index. Then times the linear search and the
+ *                   hash and prefix sums of TI_FeeInternal_BuildBlockIndex on generated configurations of 16 to
+ *                   FEE_SIM_LOOKUP_MAX_BLOCKS blocks, since the configuration of this project has a single block.
+ *                4. Power loss sweep: for n = 1..[power loss trials] (default 1500) cuts the power on the n-th
+ *                   program or erase command while the block is being rewritten, reboots and checks that the
+ *                   block reads back as the last or the interrupted write.
+ *
+ *                5. ECC sweep (built with -DTI_FEE_ECC_SWEEP=STD_ON): upsets bits in bank 7 with
+ *                   Fapi_Sim_UpsetBits, runs two sweep passes and checks the errors counted per sector, then
+ *                   checks the steps per pass at a lower rate and with a budget on a stopped timestamp, and
+ *                   that a step on bank 7 is skipped while the FSM programs.
+ *
+ *                Built with -DTI_FEE_BACKGROUND_COPY=STD_ON, the benchmark also reports the copies started while
+ *                the FEE was idle ("background copies").
+ *
+ *                Reboots run in a forked process: the bank is a shared mapping and the child starts with the
+ *                FEE RAM state of a process that never touched the driver.
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ti_fee.h"
+#include "Fapi_Sim.h"
+
+/**********************************************************************************************************************
+ * LOCAL CONSTANT MACROS
+ *********************************************************************************************************************/
+#define FEE_SIM_MAIN_PERIOD_US      1000U       /* TI_Fee_MainFunction runs from a 1 ms task */
+#define FEE_SIM_MAX_MAIN_CALLS      100000U     /* A job that needs more calls is reported as hung */
+#define FEE_SIM_DEFAULT_WRITES      2000U
+#define FEE_SIM_DEFAULT_TRIALS      1500U
+#define FEE_SIM_TRIAL_WRITES        150U        /* Rewrites after the power loss is armed, enough for a sector copy */
+#define FEE_SIM_IDLE_CALLS          10U         /* Main function calls after each write before the next one is due */
+#define FEE_SIM_MAIN_BUDGET_US      500U        /* Budget of TI_Fee_MainFunction in the second benchmark run */
+#define FEE_SIM_MAX_BLOCK_SIZE      256U
+#define FEE_SIM_CHECKSUM_BYTES      4096U       /* Buffer of the checksum benchmark, one virtual sector */
+#define FEE_SIM_CHECKSUM_RUNS       2000U
+#define FEE_SIM_LOOKUP_MAX_BLOCKS   1024U       /* Largest configuration of the lookup benchmark */
+#define FEE_SIM_LOOKUP_HASH_SIZE    4096U       /* TI_FEE_BLOCK_HASH_SIZE of FEE_SIM_LOOKUP_MAX_BLOCKS blocks */
+#define FEE_SIM_LOOKUP_CALLS        2000000U    /* Lookups timed per configuration */
+
+/* Exit codes of the forked processes */
+#define FEE_SIM_EXIT_OK             0
+#define FEE_SIM_EXIT_NO_POWER_LOSS  1
+#define FEE_SIM_EXIT_HUNG           2
+#define FEE_SIM_EXIT_READ_FAILED    3
+#define FEE_SIM_EXIT_WRONG_DATA     4
+#define FEE_SIM_EXIT_WRITE_FAILED   5
+#define FEE_SIM_EXIT_FEE_ERROR      6           /* TI_FeeErrorCode reports an error after the boot */
+
+/**********************************************************************************************************************
+ * LOCAL DATA
+ *********************************************************************************************************************/
+static uint16 FeeSim_u16BlockNumber;
+static uint16 FeeSim_u16BlockSize;
+static uint8 FeeSim_au8Write[FEE_SIM_MAX_BLOCK_SIZE];
+static uint8 FeeSim_au8Read[FEE_SIM_MAX_BLOCK_SIZE];
+static uint32 FeeSim_u32MainCalls;
+static uint32 FeeSim_u32MaxWriteCalls;
+static uint64 FeeSim_u64FlashStartUs;
+#if (TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
+static uint8 FeeSim_au8Checksum[FEE_SIM_CHECKSUM_BYTES + 8U];
+#endif
+static Fee_BlockConfigType FeeSim_aoLookupConfig[FEE_SIM_LOOKUP_MAX_BLOCKS];
+static uint16 FeeSim_au16LookupHash[FEE_SIM_LOOKUP_HASH_SIZE];
+static uint16 FeeSim_au16LookupStart[FEE_SIM_LOOKUP_MAX_BLOCKS + 1U];
+
+/**********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************************************************************/
+static uint64 FeeSim_NowNs(void)
+{
+	struct timespec oTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &oTime);
+	return(((uint64)oTime.tv_sec * 1000000000U) + (uint64)oTime.tv_nsec);
+}
+
+/* Fills the write buffer with the contents of write number u32Pattern */
+static void FeeSim_FillPattern(uint32 u32Pattern)
+{
+	uint32 u32Index;
+
+	for(u32Index = 0U; u32Index < FeeSim_u16BlockSize; u32Index++)
+	{
+		FeeSim_au8Write[u32Index] = (uint8)((u32Pattern * 31U) + (u32Index * 7U) + 1U);
+	}
+}
+
+/* Calls the main function every FEE_SIM_MAIN_PERIOD_US until the FEE is idle or the power is gone */
+static boolean FeeSim_RunUntilIdle(void)
+{
+	uint32 u32Calls = 0U;
+
+	/* At least one call, like the polling loops in sys_main.c */
+	do
+	{
+		if(u32Calls >= FEE_SIM_MAX_MAIN_CALLS)
+		{
+			return(FALSE);
+		}
+		TI_Fee_MainFunction();
+		Fapi_Sim_AdvanceTime(FEE_SIM_MAIN_PERIOD_US);
+		u32Calls++;
+	}
+	while((TI_Fee_GetStatus(0U) != IDLE) && (Fapi_Sim_IsPowerLost() == FALSE));
+	FeeSim_u32MainCalls += u32Calls;
+	return(TRUE);
+}
+
+/* Calls the main function until the job is done, the internal operations may continue */
+static boolean FeeSim_RunUntilJobDone(void)
+{
+	uint32 u32Calls = 0U;
+
+	do
+	{
+		if(u32Calls >= FEE_SIM_MAX_MAIN_CALLS)
+		{
+			return(FALSE);
+		}
+		TI_Fee_MainFunction();
+		Fapi_Sim_AdvanceTime(FEE_SIM_MAIN_PERIOD_US);
+		u32Calls++;
+	}
+	while((TI_Fee_GetJobResult(0U) == JOB_PENDING) && (Fapi_Sim_IsPowerLost() == FALSE));
+	FeeSim_u32MainCalls += u32Calls;
+	return(TRUE);
+}
+
+/* Calls the main function u32Calls times, the application has nothing to write */
+static void FeeSim_RunIdle(uint32 u32Calls)
+{
+	uint32 u32Call;
+
+	for(u32Call = 0U; (u32Call < u32Calls) && (Fapi_Sim_IsPowerLost() == FALSE); u32Call++)
+	{
+		TI_Fee_MainFunction();
+		Fapi_Sim_AdvanceTime(FEE_SIM_MAIN_PERIOD_US);
+	}
+	FeeSim_u32MainCalls += u32Call;
+}
+
+static boolean FeeSim_Boot(void)
+{
+	TI_Fee_Init();
+	return(FeeSim_RunUntilIdle());
+}
+
+static boolean FeeSim_Write(uint32 u32Pattern)
+{
+	uint32 u32StartCalls = FeeSim_u32MainCalls;
+	boolean bWritten = TRUE;
+
+	FeeSim_FillPattern(u32Pattern);
+	/* Wait for a copy or erase still running from the last write */
+	if(TI_Fee_GetStatus(0U) != IDLE)
+	{
+		bWritten = FeeSim_RunUntilIdle();
+	}
+	if((bWritten == TRUE) && (Fapi_Sim_IsPowerLost() == FALSE))
+	{
+		bWritten = ((TI_Fee_WriteAsync(FeeSim_u16BlockNumber, FeeSim_au8Write) == E_OK) &&
+		            (FeeSim_RunUntilJobDone() == TRUE)) ? TRUE : FALSE;
+	}
+	if((FeeSim_u32MainCalls - u32StartCalls) > FeeSim_u32MaxWriteCalls)
+	{
+		FeeSim_u32MaxWriteCalls = FeeSim_u32MainCalls - u32StartCalls;
+	}
+	if(bWritten == TRUE)
+	{
+		FeeSim_RunIdle(FEE_SIM_IDLE_CALLS);
+	}
+	return(bWritten);
+}
+
+static boolean FeeSim_Read(void)
+{
+	(void)memset(FeeSim_au8Read, 0, sizeof(FeeSim_au8Read));
+	/* TI_Fee_ReadSync is rejected while a copy or erase runs */
+	if((TI_Fee_GetStatus(0U) != IDLE) && (FeeSim_RunUntilIdle() == FALSE))
+	{
+		return(FALSE);
+	}
+	return((TI_Fee_ReadSync(FeeSim_u16BlockNumber, 0U, FeeSim_au8Read, FeeSim_u16BlockSize) == E_OK) &&
+	       (TI_Fee_GetJobResult(0U) == JOB_OK));
+}
+
+static boolean FeeSim_ReadMatches(uint32 u32Pattern)
+{
+	FeeSim_FillPattern(u32Pattern);
+	return((memcmp(FeeSim_au8Read, FeeSim_au8Write, FeeSim_u16BlockSize) == 0) ? TRUE : FALSE);
+}
+
+static int FeeSim_Wait(pid_t oChild)
+{
+	int iStatus = 0;
+
+	(void)waitpid(oChild, &iStatus, 0);
+	return(WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1);
+}
+
+static void FeeSim_ResetCounters(void)
+{
+	Fapi_SimCountersType oCounters;
+
+	Fapi_Sim_ResetCounters();
+	Fapi_Sim_GetCounters(&oCounters);
+	FeeSim_u64FlashStartUs = oCounters.u64TimeUs;
+	FeeSim_u32MainCalls = 0U;
+	FeeSim_u32MaxWriteCalls = 0U;
+	TI_Fee_ClearLatencyStats(0U);
+	TI_Fee_ClearStepStats();
+}
+
+static void FeeSim_PrintCounters(const char * pcLabel, uint32 u32Jobs, uint64 u64HostNs)
+{
+	Fapi_SimCountersType oCounters;
+	TI_Fee_LatencyStatsType oLatency;
+
+	Fapi_Sim_GetCounters(&oCounters);
+	TI_Fee_GetLatencyStats(0U, &oLatency);
+	(void)printf("%-6s jobs %5lu  host %8lu ns/job  flash %7lu us/job  main calls %lu  programs %lu  erases %lu"
+	             "  polls %lu (busy %lu)\n",
+	             pcLabel, (unsigned long)u32Jobs, (unsigned long)(u64HostNs / u32Jobs),
+	             (unsigned long)((oCounters.u64TimeUs - FeeSim_u64FlashStartUs) / u32Jobs), (unsigned long)FeeSim_u32MainCalls,
+	             (unsigned long)oCounters.u32ProgramCount, (unsigned long)oCounters.u32EraseCount,
+	             (unsigned long)oCounters.u32StatusPolls, (unsigned long)oCounters.u32BusyPolls);
+	if(oLatency.u32Jobs != 0U)
+	{
+		/* Worst case job latency and longest internal operation, in main function calls */
+		(void)printf("%-6s max write %lu calls  max job %lu calls  max internal %lu calls  background copies %lu\n",
+		             "", (unsigned long)FeeSim_u32MaxWriteCalls, (unsigned long)oLatency.u32MaxJobCalls,
+		             (unsigned long)oLatency.u32MaxInternalCalls, (unsigned long)oLatency.u32BackgroundCopies);
+	}
+}
+
+/* Cycle statistics per step type, in microseconds of virtual time, and the histogram bins holding steps */
+static void FeeSim_PrintStepStats(void)
+{
+	static const char * const apcStep[TI_FEE_NUMBER_OF_STEP_TYPES] =
+	{
+		"call", "write", "read", "inval", "copy", "erase", "idle"
+	};
+	TI_Fee_StepStatsType oStats;
+	uint32 u32StepType;
+	uint32 u32Bin;
+
+	for(u32StepType = 0U; u32StepType < (uint32)TI_FEE_NUMBER_OF_STEP_TYPES; u32StepType++)
+	{
+		TI_Fee_GetStepStats((TI_Fee_StepType)u32StepType, &oStats);
+		if(oStats.u32Steps == 0U)
+		{
+			continue;
+		}
+		(void)printf("%-6s %-5s %6lu steps  max %6lu us  avg %4lu us  bins", "", apcStep[u32StepType],
+		             (unsigned long)oStats.u32Steps, (unsigned long)oStats.u32MaxTicks,
+		             (unsigned long)(oStats.u64TotalTicks / oStats.u32Steps));
+		for(u32Bin = 0U; u32Bin < TI_FEE_STEP_HISTOGRAM_BINS; u32Bin++)
+		{
+			if(oStats.au32Histogram[u32Bin] != 0U)
+			{
+				(void)printf(" <%lu:%lu", (unsigned long)(1UL << u32Bin), (unsigned long)oStats.au32Histogram[u32Bin]);
+			}
+		}
+		(void)printf("\n");
+	}
+}
+
+/**********************************************************************************************************************
+ *  FeeSim_Benchmark
+ *********************************************************************************************************************/
+static int FeeSim_Benchmark(uint32 u32Writes, uint32 u32Budget)
+{
+	pid_t oChild;
+	uint64 u64Start;
+	uint32 u32Write;
+	uint32 u32Ecc;
+	uint32 u32FirstError = 0U;
+	const uint8 * pu8View;
+	uint16 u16ViewLength;
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	TI_Fee_WriteCacheStatsType oCacheStats;
+	#endif
+
+	oChild = fork();
+	if(oChild == 0)
+	{
+		(void)Fapi_Sim_Init(NULL_PTR);
+		TI_Fee_SetMainFunctionBudget(u32Budget);
+		u64Start = FeeSim_NowNs();
+		if(FeeSim_Boot() == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_HUNG);
+		}
+		FeeSim_PrintCounters("format", 1U, FeeSim_NowNs() - u64Start);
+
+		FeeSim_ResetCounters();
+		u64Start = FeeSim_NowNs();
+		for(u32Write = 1U; u32Write <= u32Writes; u32Write++)
+		{
+			if(FeeSim_Write(u32Write) == FALSE)
+			{
+				(void)printf("write %lu failed\n", (unsigned long)u32Write);
+				_exit(FEE_SIM_EXIT_WRITE_FAILED);
+			}
+		}
+		FeeSim_PrintCounters("write", u32Writes, FeeSim_NowNs() - u64Start);
+		FeeSim_PrintStepStats();
+
+		/* Rewrites of the data in flash are detected and not programmed */
+		FeeSim_ResetCounters();
+		u64Start = FeeSim_NowNs();
+		for(u32Write = 0U; u32Write < u32Writes; u32Write++)
+		{
+			if(FeeSim_Write(u32Writes) == FALSE)
+			{
+				_exit(FEE_SIM_EXIT_WRITE_FAILED);
+			}
+		}
+		FeeSim_PrintCounters("same", u32Writes, FeeSim_NowNs() - u64Start);
+
+		FeeSim_ResetCounters();
+		u64Start = FeeSim_NowNs();
+		for(u32Write = 0U; u32Write < u32Writes; u32Write++)
+		{
+			if(FeeSim_Read() == FALSE)
+			{
+				_exit(FEE_SIM_EXIT_READ_FAILED);
+			}
+		}
+		FeeSim_PrintCounters("read", u32Writes, FeeSim_NowNs() - u64Start);
+		if(FeeSim_ReadMatches(u32Writes) == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_WRONG_DATA);
+		}
+
+		FeeSim_ResetCounters();
+		u64Start = FeeSim_NowNs();
+		for(u32Write = 0U; u32Write < u32Writes; u32Write++)
+		{
+			if(TI_Fee_GetBlockView(FeeSim_u16BlockNumber, &pu8View, &u16ViewLength) != JOB_OK)
+			{
+				_exit(FEE_SIM_EXIT_READ_FAILED);
+			}
+		}
+		FeeSim_PrintCounters("view", u32Writes, FeeSim_NowNs() - u64Start);
+		FeeSim_FillPattern(u32Writes);
+		if((u16ViewLength != FeeSim_u16BlockSize) || (memcmp(pu8View, FeeSim_au8Write, FeeSim_u16BlockSize) != 0))
+		{
+			_exit(FEE_SIM_EXIT_WRONG_DATA);
+		}
+		#if (TI_FEE_WRITE_CACHE == STD_ON)
+		TI_Fee_GetWriteCacheStats(&oCacheStats);
+		(void)printf("write cache: %lu writes, %lu reads, %lu flushes\n", (unsigned long)oCacheStats.u32Writes,
+		             (unsigned long)oCacheStats.u32Reads, (unsigned long)oCacheStats.u32Flushes);
+		#endif
+
+		/* Leave nothing in RAM for the boot below */
+		if(TI_Fee_Shutdown() != E_OK)
+		{
+			_exit(FEE_SIM_EXIT_WRITE_FAILED);
+		}
+		u32Ecc = Fapi_Sim_CheckEcc(&u32FirstError);
+		if(u32Ecc != 0U)
+		{
+			(void)printf("ECC mismatches %lu, first at 0x%08lX\n", (unsigned long)u32Ecc,
+			             (unsigned long)u32FirstError);
+		}
+		_exit(FEE_SIM_EXIT_OK);
+	}
+	if(FeeSim_Wait(oChild) != FEE_SIM_EXIT_OK)
+	{
+		return(1);
+	}
+
+	/* Boot on the bank the writes left behind */
+	oChild = fork();
+	if(oChild == 0)
+	{
+		Fapi_Sim_PowerCycle();
+		TI_Fee_SetMainFunctionBudget(u32Budget);
+		FeeSim_ResetCounters();
+		u64Start = FeeSim_NowNs();
+		if(FeeSim_Boot() == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_HUNG);
+		}
+		FeeSim_PrintCounters("boot", 1U, FeeSim_NowNs() - u64Start);
+		_exit(((FeeSim_Read() == TRUE) && (FeeSim_ReadMatches(u32Writes) == TRUE)) ?
+		      FEE_SIM_EXIT_OK : FEE_SIM_EXIT_WRONG_DATA);
+	}
+	return((FeeSim_Wait(oChild) == FEE_SIM_EXIT_OK) ? 0 : 1);
+}
+
+/**********************************************************************************************************************
+ *  FeeSim_StoppedTimestampTest
+ *********************************************************************************************************************/
+/*! \brief      Writes the block u32Writes times with a main function budget while TI_FEE_GET_TIMESTAMP does not
+ *              advance, as with RTI counter 0 not started. Every call has to take one step, as without a budget.
+ *  \return     0 if the writes succeed and no call took more than one step.
+ *********************************************************************************************************************/
+static int FeeSim_StoppedTimestampTest(uint32 u32Writes)
+{
+	pid_t oChild;
+	uint32 u32Write;
+	uint32 u32StepType;
+	uint32 u32Steps = 0U;
+	boolean bOneStep;
+	TI_Fee_StepStatsType oStats;
+
+	oChild = fork();
+	if(oChild == 0)
+	{
+		(void)Fapi_Sim_Init(NULL_PTR);
+		TI_Fee_SetMainFunctionBudget(FEE_SIM_MAIN_BUDGET_US);
+		Fapi_Sim_StopTimestamp(TRUE);
+		if(FeeSim_Boot() == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_HUNG);
+		}
+		TI_Fee_ClearStepStats();
+		for(u32Write = 1U; u32Write <= u32Writes; u32Write++)
+		{
+			if(FeeSim_Write(u32Write) == FALSE)
+			{
+				_exit(FEE_SIM_EXIT_WRITE_FAILED);
+			}
+		}
+		for(u32StepType = (uint32)TI_FEE_STEP_WRITE; u32StepType < (uint32)TI_FEE_NUMBER_OF_STEP_TYPES; u32StepType++)
+		{
+			TI_Fee_GetStepStats((TI_Fee_StepType)u32StepType, &oStats);
+			u32Steps += oStats.u32Steps;
+		}
+		/* Each call steps every EEP once */
+		TI_Fee_GetStepStats(TI_FEE_STEP_MAIN_FUNCTION, &oStats);
+		bOneStep = (u32Steps == (oStats.u32Steps * TI_FEE_NUMBER_OF_EEPS)) ? TRUE : FALSE;
+		(void)printf("stopped timestamp: %lu calls, %lu steps, %s\n", (unsigned long)oStats.u32Steps,
+		             (unsigned long)u32Steps, (bOneStep == TRUE) ? "ok" : "FAILED");
+		_exit((bOneStep == TRUE) ? FEE_SIM_EXIT_OK : FEE_SIM_EXIT_HUNG);
+	}
+	return((FeeSim_Wait(oChild) == FEE_SIM_EXIT_OK) ? 0 : 1);
+}
+
+#if (TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
+/**********************************************************************************************************************
+ *  FeeSim_Fletcher16Reference
+ *********************************************************************************************************************/
+/*! \brief      Byte wise Fletcher16 as shipped before the word wide kernel. Reference for results and speed.
+ *********************************************************************************************************************/
+static uint32 FeeSim_Fletcher16Reference(uint8 const * pu8data, uint16 u16Length)
+{
+	uint16 u16sum1 = 0xFFU;
+	uint16 u16sum2 = 0xFFU;
+	uint16 u16len;
+
+	while(u16Length > 0U)
+	{
+		u16len = u16Length > 20U ? 20U : u16Length;
+		u16Length -= u16len;
+		do
+		{
+			if(pu8data != NULL_PTR)
+			{
+				u16sum1 += *pu8data;
+				pu8data += 1U;
+			}
+			u16sum2 += u16sum1;
+			u16len -= 1U;
+		}while(u16len > 0U);
+		u16sum1 = (u16sum1 & 0xFFU) + (u16sum1 >> 8U);
+		u16sum2 = (u16sum2 & 0xFFU) + (u16sum2 >> 8U);
+	}
+	u16sum1 = (u16sum1 & 0xFFU) + (u16sum1 >> 8U);
+	u16sum2 = (u16sum2 & 0xFFU) + (u16sum2 >> 8U);
+	return ((uint32)(u16sum2 << 8U) | u16sum1);
+}
+
+/* Time stamp counter of the host, 0 where there is none */
+static uint64 FeeSim_Cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	uint32 u32Lo;
+	uint32 u32Hi;
+
+	__asm__ __volatile__("rdtsc" : "=a"(u32Lo), "=d"(u32Hi));
+	return(((uint64)u32Hi << 32U) | u32Lo);
+#else
+	return(0U);
+#endif
+}
+
+/**********************************************************************************************************************
+ *  FeeSim_ChecksumBenchmark
+ *********************************************************************************************************************/
+static int FeeSim_ChecksumBenchmark(void)
+{
+	typedef uint32 (*FeeSim_ChecksumType)(uint8 const * pu8data, uint16 u16Length);
+	static const FeeSim_ChecksumType aoKernel[2] = {&FeeSim_Fletcher16Reference, &TI_FeeInternal_Fletcher16};
+	static const char * const apcKernel[2] = {"byte", "word"};
+	volatile uint32 u32Sink = 0U;
+	uint32 u32Index;
+	uint32 u32Offset;
+	uint32 u32Length;
+	uint32 u32Run;
+	uint64 u64Ns;
+	uint64 u64Cycles;
+
+	for(u32Index = 0U; u32Index < sizeof(FeeSim_au8Checksum); u32Index++)
+	{
+		FeeSim_au8Checksum[u32Index] = (uint8)((u32Index * 2654435761U) >> 24U);
+	}
+	for(u32Offset = 0U; u32Offset < 8U; u32Offset++)
+	{
+		for(u32Length = 0U; u32Length <= 600U; u32Length++)
+		{
+			if(TI_FeeInternal_Fletcher16(&FeeSim_au8Checksum[u32Offset], (uint16)u32Length) !=
+			   FeeSim_Fletcher16Reference(&FeeSim_au8Checksum[u32Offset], (uint16)u32Length))
+			{
+				(void)printf("checksum mismatch at offset %lu, length %lu\n", (unsigned long)u32Offset,
+				             (unsigned long)u32Length);
+				return(1);
+			}
+		}
+	}
+	/* Largest sums and the NULL pointer convention */
+	(void)memset(FeeSim_au8Checksum, 0xFF, sizeof(FeeSim_au8Checksum));
+	if((TI_FeeInternal_Fletcher16(FeeSim_au8Checksum, FEE_SIM_CHECKSUM_BYTES) !=
+	    FeeSim_Fletcher16Reference(FeeSim_au8Checksum, FEE_SIM_CHECKSUM_BYTES)) ||
+	   (TI_FeeInternal_Fletcher16(NULL_PTR, 0xFFFFU) != FeeSim_Fletcher16Reference(NULL_PTR, 0xFFFFU)))
+	{
+		(void)printf("checksum mismatch on saturated data\n");
+		return(1);
+	}
+
+	for(u32Index = 0U; u32Index < 2U; u32Index++)
+	{
+		for(u32Length = 16U; u32Length <= FEE_SIM_CHECKSUM_BYTES; u32Length <<= 4U)
+		{
+			u64Ns = FeeSim_NowNs();
+			u64Cycles = FeeSim_Cycles();
+			for(u32Run = 0U; u32Run < FEE_SIM_CHECKSUM_RUNS; u32Run++)
+			{
+				u32Sink += aoKernel[u32Index](FeeSim_au8Checksum, (uint16)u32Length);
+			}
+			u64Cycles = FeeSim_Cycles() - u64Cycles;
+			u64Ns = FeeSim_NowNs() - u64Ns;
+			(void)printf("fletcher16 %s %4lu bytes  %4lu.%02lu cycles/byte  %4lu.%02lu ns/byte\n", apcKernel[u32Index],
+			             (unsigned long)u32Length,
+			             (unsigned long)(u64Cycles / (FEE_SIM_CHECKSUM_RUNS * u32Length)),
+			             (unsigned long)(((u64Cycles * 100U) / (FEE_SIM_CHECKSUM_RUNS * u32Length)) % 100U),
+			             (unsigned long)(u64Ns / (FEE_SIM_CHECKSUM_RUNS * u32Length)),
+			             (unsigned long)(((u64Ns * 100U) / (FEE_SIM_CHECKSUM_RUNS * u32Length)) % 100U));
+		}
+	}
+	(void)u32Sink;
+	return(0);
+}
+#endif
+
+/**********************************************************************************************************************
+ *  FeeSim_LinearArrayIndex
+ *********************************************************************************************************************/
+/*! \brief      Linear search of TI_FeeInternal_GetArrayIndex as shipped before the lookup tables. Reference for results
+ *              and speed. With bCallContext FALSE it returns the block owning data set u16CopyIndex.
+ *********************************************************************************************************************/
+static uint16 FeeSim_LinearArrayIndex(const Fee_BlockConfigType * poConfig, uint16 u16Blocks, uint16 BlockNumber,
+                                      uint16 DataSetNumber, uint16 u16CopyIndex, boolean bCallContext)
+{
+	uint16 u16ArrayIndex = 0U;
+	uint16 u16LoopIndex = 0U;
+
+	if(TRUE == bCallContext)
+	{
+		for(u16LoopIndex = 0U; u16LoopIndex < u16Blocks; u16LoopIndex++)
+		{
+			if(BlockNumber == poConfig[u16LoopIndex].FeeBlockNumber)
+			{
+				#if (TI_FEE_VARIABLE_DATASETS == STD_ON)
+				u16ArrayIndex += DataSetNumber;
+				#endif
+				break;
+			}
+			u16ArrayIndex += poConfig[u16LoopIndex].FeeNumberOfDataSets;
+		}
+		return(u16ArrayIndex);
+	}
+	for(u16LoopIndex = 0U; u16LoopIndex < u16Blocks; u16LoopIndex++)
+	{
+		u16ArrayIndex += poConfig[u16LoopIndex].FeeNumberOfDataSets;
+		if(u16ArrayIndex > u16CopyIndex)
+		{
+			break;
+		}
+	}
+	return(u16LoopIndex);
+}
+
+/* TI_FeeInternal_GetArrayIndex in call context, on the tables FeeSim_BuildLookup made for FeeSim_aoLookupConfig */
+static uint16 FeeSim_HashArrayIndex(uint16 u16Blocks, uint16 u16HashSize, uint16 BlockNumber, uint16 DataSetNumber)
+{
+	uint16 u16Slot = BlockNumber & (uint16)(u16HashSize - 1U);
+	uint16 u16Probe;
+
+	for(u16Probe = 0U; u16Probe < u16HashSize; u16Probe++)
+	{
+		if(TI_FEE_BLOCK_HASH_EMPTY == FeeSim_au16LookupHash[u16Slot])
+		{
+			break;
+		}
+		if(BlockNumber == FeeSim_aoLookupConfig[FeeSim_au16LookupHash[u16Slot]].FeeBlockNumber)
+		{
+			#if (TI_FEE_VARIABLE_DATASETS == STD_ON)
+			return(FeeSim_au16LookupStart[FeeSim_au16LookupHash[u16Slot]] + DataSetNumber);
+			#else
+			return(FeeSim_au16LookupStart[FeeSim_au16LookupHash[u16Slot]]);
+			#endif
+		}
+		u16Slot = (u16Slot + 1U) & (uint16)(u16HashSize - 1U);
+	}
+	return(FeeSim_au16LookupStart[u16Blocks]);
+}
+
+/* Generates u16Blocks blocks numbered from 1 with 1 to 3 data sets, and the tables of TI_FeeInternal_BuildBlockIndex */
+static uint16 FeeSim_BuildLookup(uint16 u16Blocks)
+{
+	uint16 u16HashSize = 16U;
+	uint16 u16Block;
+	uint16 u16Slot;
+
+	/* Same sizes as TI_FEE_BLOCK_HASH_SIZE */
+	while((u16HashSize < FEE_SIM_LOOKUP_HASH_SIZE) && (u16HashSize < (2U * u16Blocks)))
+	{
+		u16HashSize <<= 2U;
+	}
+	for(u16Slot = 0U; u16Slot < u16HashSize; u16Slot++)
+	{
+		FeeSim_au16LookupHash[u16Slot] = TI_FEE_BLOCK_HASH_EMPTY;
+	}
+	FeeSim_au16LookupStart[0] = 0U;
+	for(u16Block = 0U; u16Block < u16Blocks; u16Block++)
+	{
+		FeeSim_aoLookupConfig[u16Block].FeeBlockNumber = u16Block + 1U;
+		FeeSim_aoLookupConfig[u16Block].FeeNumberOfDataSets = (uint8)(1U + (u16Block % 3U));
+		FeeSim_au16LookupStart[u16Block + 1U] = FeeSim_au16LookupStart[u16Block] +
+		                                        FeeSim_aoLookupConfig[u16Block].FeeNumberOfDataSets;
+		u16Slot = (u16Block + 1U) & (uint16)(u16HashSize - 1U);
+		while(TI_FEE_BLOCK_HASH_EMPTY != FeeSim_au16LookupHash[u16Slot])
+		{
+			u16Slot = (u16Slot + 1U) & (uint16)(u16HashSize - 1U);
+		}
+		FeeSim_au16LookupHash[u16Slot] = u16Block;
+	}
+	return(u16HashSize);
+}
+
+/**********************************************************************************************************************
+ *  FeeSim_LookupBenchmark
+ *********************************************************************************************************************/
+static int FeeSim_LookupBenchmark(void)
+{
+	volatile uint32 u32Sink = 0U;
+	uint16 u16CopyIndex;
+	uint16 u16Block;
+	uint16 u16DataSet;
+	uint16 u16Blocks;
+	uint16 u16HashSize;
+	uint16 u16Number;
+	uint32 u32Call;
+	uint64 u64LinearNs;
+	uint64 u64HashNs;
+
+	/* The driver against the linear search, on the configuration of this project */
+	TI_FeeInternal_BuildBlockIndex();
+	u16CopyIndex = TI_Fee_GlobalVariables[0].Fee_u16BlockCopyIndex;
+	for(u16Block = 0U; u16Block < TI_FEE_NUMBER_OF_BLOCKS; u16Block++)
+	{
+		u16Number = Fee_BlockConfiguration[u16Block].FeeBlockNumber;
+		for(u16DataSet = 0U; u16DataSet < Fee_BlockConfiguration[u16Block].FeeNumberOfDataSets; u16DataSet++)
+		{
+			if(TI_FeeInternal_GetArrayIndex(u16Number, u16DataSet, 0U, TRUE) !=
+			   FeeSim_LinearArrayIndex(Fee_BlockConfiguration, TI_FEE_NUMBER_OF_BLOCKS, u16Number, u16DataSet, 0U, TRUE))
+			{
+				(void)printf("lookup mismatch for block %u data set %u\n", (unsigned)u16Number, (unsigned)u16DataSet);
+				return(1);
+			}
+		}
+	}
+	if(TI_FeeInternal_GetArrayIndex(0xFFFEU, 0U, 0U, TRUE) !=
+	   FeeSim_LinearArrayIndex(Fee_BlockConfiguration, TI_FEE_NUMBER_OF_BLOCKS, 0xFFFEU, 0U, 0U, TRUE))
+	{
+		(void)printf("lookup mismatch for an unconfigured block\n");
+		return(1);
+	}
+	for(u16Number = 0U; u16Number <= TI_FEE_TOTAL_BLOCKS_DATASETS; u16Number++)
+	{
+		TI_Fee_GlobalVariables[0].Fee_u16BlockCopyIndex = u16Number;
+		if(TI_FeeInternal_GetArrayIndex(0U, 0U, 0U, FALSE) !=
+		   FeeSim_LinearArrayIndex(Fee_BlockConfiguration, TI_FEE_NUMBER_OF_BLOCKS, 0U, 0U, u16Number, FALSE))
+		{
+			TI_Fee_GlobalVariables[0].Fee_u16BlockCopyIndex = u16CopyIndex;
+			(void)printf("lookup mismatch for copy index %u\n", (unsigned)u16Number);
+			return(1);
+		}
+	}
+	TI_Fee_GlobalVariables[0].Fee_u16BlockCopyIndex = u16CopyIndex;
+
+	/* Generated configurations: the last data set of every block is checked, then every block is looked up in turn */
+	for(u16Blocks = 16U; u16Blocks <= FEE_SIM_LOOKUP_MAX_BLOCKS; u16Blocks <<= 2U)
+	{
+		u16HashSize = FeeSim_BuildLookup(u16Blocks);
+		for(u16Block = 0U; u16Block < u16Blocks; u16Block++)
+		{
+			u16DataSet = (uint16)(FeeSim_aoLookupConfig[u16Block].FeeNumberOfDataSets - 1U);
+			if(FeeSim_HashArrayIndex(u16Blocks, u16HashSize, u16Block + 1U, u16DataSet) !=
+			   FeeSim_LinearArrayIndex(FeeSim_aoLookupConfig, u16Blocks, u16Block + 1U, u16DataSet, 0U, TRUE))
+			{
+				(void)printf("lookup mismatch for block %u of %u\n", (unsigned)(u16Block + 1U), (unsigned)u16Blocks);
+				return(1);
+			}
+		}
+
+		u64LinearNs = FeeSim_NowNs();
+		for(u32Call = 0U; u32Call < FEE_SIM_LOOKUP_CALLS; u32Call++)
+		{
+			u32Sink += FeeSim_LinearArrayIndex(FeeSim_aoLookupConfig, u16Blocks, (uint16)((u32Call % u16Blocks) + 1U),
+			                                   0U, 0U, TRUE);
+		}
+		u64LinearNs = FeeSim_NowNs() - u64LinearNs;
+		u64HashNs = FeeSim_NowNs();
+		for(u32Call = 0U; u32Call < FEE_SIM_LOOKUP_CALLS; u32Call++)
+		{
+			u32Sink += FeeSim_HashArrayIndex(u16Blocks, u16HashSize, (uint16)((u32Call % u16Blocks) + 1U), 0U);
+		}
+		u64HashNs = FeeSim_NowNs() - u64HashNs;
+		(void)printf("lookup %4u blocks  linear %6lu.%02lu ns  hash %4lu.%02lu ns\n", (unsigned)u16Blocks,
+		             (unsigned long)(u64LinearNs / FEE_SIM_LOOKUP_CALLS),
+		             (unsigned long)(((u64LinearNs * 100U) / FEE_SIM_LOOKUP_CALLS) % 100U),
+		             (unsigned long)(u64HashNs / FEE_SIM_LOOKUP_CALLS),
+		             (unsigned long)(((u64HashNs * 100U) / FEE_SIM_LOOKUP_CALLS) % 100U));
+	}
+	(void)u32Sink;
+	return(0);
+}
+
+#if (TI_FEE_ECC_SWEEP == STD_ON)
+/* Runs sweep steps until a pass is complete, returns the number of steps */
+static uint32 FeeSim_EccSweepPass(void)
+{
+	uint32 u32Steps = 1U;
+
+	while(TI_Fee_EccSweepStep() == FALSE)
+	{
+		u32Steps++;
+	}
+	return(u32Steps);
+}
+
+/**********************************************************************************************************************
+ *  FeeSim_EccSweepTest
+ *********************************************************************************************************************/
+/*! \brief      Upsets one double word in sector 1 and two in sector 0 with one bit each, and one double word in
+ *              sector 2 with two bits. Every pass has to find 2, 1 and 1 errors in those sectors and none in sector 3.
+ *  \return     0 if the counts match.
+ *********************************************************************************************************************/
+static int FeeSim_EccSweepTest(void)
+{
+	static const uint32 au32PassCorrected[4] = {2U, 1U, 0U, 0U};
+	static const uint32 au32PassUncorrectable[4] = {0U, 0U, 1U, 0U};
+	TI_Fee_EccSweepSectorStatsType oSector;
+	TI_Fee_EccSweepStatsType oStats;
+	uint32 u32Steps;
+	uint32 u32Pass;
+	uint16 u16Sector;
+	int iResult = 0;
+
+	(void)Fapi_Sim_Init(NULL_PTR);
+	if((FeeSim_Boot() == FALSE) || (FeeSim_Write(1U) == FALSE) || (FeeSim_Write(2U) == FALSE))
+	{
+		(void)printf("ecc sweep: write FAILED\n");
+		return(1);
+	}
+
+	TI_Fee_EccSweepInit();
+	u32Steps = FeeSim_EccSweepPass();
+	TI_Fee_GetEccSweepSectorStats(0U, &oSector);
+	if((u32Steps != ((4U * FAPI_SIM_SECTOR_SIZE) / (8U * TI_FEE_ECC_SWEEP_DOUBLEWORDS))) || (oSector.u32Corrected != 0U))
+	{
+		(void)printf("ecc sweep: clean pass took %lu steps, %lu errors\n", (unsigned long)u32Steps,
+		             (unsigned long)oSector.u32Corrected);
+		return(1);
+	}
+
+	/* In different steps: the wrapper latches one address per flag */
+	Fapi_Sim_UpsetBits(FAPI_SIM_BANK_START_ADDRESS + 0x0010U, 0x04U);
+	Fapi_Sim_UpsetBits(FAPI_SIM_BANK_START_ADDRESS + 0x0C03U, 0x80U);
+	Fapi_Sim_UpsetBits(FAPI_SIM_BANK_START_ADDRESS + 0x1F00U, 0x01U);
+	Fapi_Sim_UpsetBits(FAPI_SIM_BANK_START_ADDRESS + 0x2208U, 0x11U);
+
+	/* Flash is not repaired by a read: the second pass finds the same errors */
+	for(u32Pass = 1U; u32Pass <= 2U; u32Pass++)
+	{
+		(void)FeeSim_EccSweepPass();
+		for(u16Sector = 0U; u16Sector < 4U; u16Sector++)
+		{
+			TI_Fee_GetEccSweepSectorStats(u16Sector, &oSector);
+			if((oSector.u32PassCorrected != au32PassCorrected[u16Sector]) ||
+			   (oSector.u32PassUncorrectable != au32PassUncorrectable[u16Sector]) ||
+			   (oSector.u32Corrected != (u32Pass * au32PassCorrected[u16Sector])) ||
+			   (oSector.u32Uncorrectable != (u32Pass * au32PassUncorrectable[u16Sector])))
+			{
+				(void)printf("ecc sweep: pass %lu sector %u: %lu/%lu corrected, %lu/%lu uncorrectable\n",
+				             (unsigned long)u32Pass, (unsigned)u16Sector, (unsigned long)oSector.u32PassCorrected,
+				             (unsigned long)oSector.u32Corrected, (unsigned long)oSector.u32PassUncorrectable,
+				             (unsigned long)oSector.u32Uncorrectable);
+				iResult = 1;
+			}
+		}
+	}
+	TI_Fee_GetEccSweepSectorStats(2U, &oSector);
+	if(oSector.u32LastErrorAddress != (FAPI_SIM_BANK_START_ADDRESS + 0x2208U))
+	{
+		(void)printf("ecc sweep: sector 2 reports 0x%08lX\n", (unsigned long)oSector.u32LastErrorAddress);
+		iResult = 1;
+	}
+
+	/* A slower rate takes proportionally more steps */
+	TI_Fee_SetEccSweepRate(TI_FEE_ECC_SWEEP_DOUBLEWORDS / 4U, 0U);
+	if(FeeSim_EccSweepPass() != (4U * u32Steps))
+	{
+		(void)printf("ecc sweep: rate not applied\n");
+		iResult = 1;
+	}
+
+	/* With a budget on a stopped timestamp a step ends at the first check of the budget, after 32 double words */
+	Fapi_Sim_StopTimestamp(TRUE);
+	TI_Fee_SetEccSweepRate(TI_FEE_ECC_SWEEP_DOUBLEWORDS, 1000U);
+	if(FeeSim_EccSweepPass() != ((4U * FAPI_SIM_SECTOR_SIZE) / (8U * 32U)))
+	{
+		(void)printf("ecc sweep: budget on a stopped timestamp does not end the steps\n");
+		iResult = 1;
+	}
+	Fapi_Sim_StopTimestamp(FALSE);
+
+	/* Bank 7 is not read while the FSM programs */
+	FeeSim_FillPattern(3U);
+	if(TI_Fee_WriteAsync(FeeSim_u16BlockNumber, FeeSim_au8Write) == E_OK)
+	{
+		TI_Fee_MainFunction();
+		(void)TI_Fee_EccSweepStep();
+	}
+	TI_Fee_GetEccSweepStats(&oStats);
+	if(oStats.u32SkippedSteps == 0U)
+	{
+		(void)printf("ecc sweep: step not skipped while programming\n");
+		iResult = 1;
+	}
+	(void)FeeSim_RunUntilIdle();
+
+	(void)printf("ecc sweep: %lu steps/pass, %lu passes, %lu skipped, %s\n", (unsigned long)u32Steps,
+	             (unsigned long)oStats.u32Passes, (unsigned long)oStats.u32SkippedSteps, (iResult == 0) ? "ok" : "FAILED");
+	return(iResult);
+}
+#endif
+
+/**********************************************************************************************************************
+ *  FeeSim_PowerLossTrial
+ *********************************************************************************************************************/
+/*! \brief      Writes the block once, arms a power loss on the u32Operation-th flash command and keeps rewriting.
+ *              After the reboot the block has to hold the last acknowledged or the interrupted write.
+ *  \return     One of the FEE_SIM_EXIT_xxx codes.
+ *********************************************************************************************************************/
+static int FeeSim_PowerLossTrial(uint32 u32Operation)
+{
+	pid_t oChild;
+	uint32 u32Write;
+	int iResult;
+
+	(void)Fapi_Sim_Init(NULL_PTR);
+	oChild = fork();
+	if(oChild == 0)
+	{
+		if((FeeSim_Boot() == FALSE) || (FeeSim_Write(1U) == FALSE))
+		{
+			_exit(FEE_SIM_EXIT_WRITE_FAILED);
+		}
+		Fapi_Sim_ScheduleFault(Fapi_SimFault_PowerLoss, u32Operation);
+		for(u32Write = 2U; u32Write < (2U + FEE_SIM_TRIAL_WRITES); u32Write++)
+		{
+			if(FeeSim_Write(u32Write) == FALSE)
+			{
+				_exit(FEE_SIM_EXIT_HUNG);
+			}
+			if(Fapi_Sim_IsPowerLost() == TRUE)
+			{
+				/* Report the interrupted write, the one before it was acknowledged */
+				_exit(100 + (int)u32Write);
+			}
+		}
+		_exit(FEE_SIM_EXIT_NO_POWER_LOSS);
+	}
+	iResult = FeeSim_Wait(oChild);
+	if(iResult < 100)
+	{
+		return(iResult);
+	}
+
+	u32Write = (uint32)(iResult - 100);
+	oChild = fork();
+	if(oChild == 0)
+	{
+		Fapi_Sim_PowerCycle();
+		if(FeeSim_Boot() == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_HUNG);
+		}
+		if(TI_FeeErrorCode(0U) != Error_Nil)
+		{
+			(void)printf("power loss at command %lu: error code %d after boot\n", (unsigned long)u32Operation,
+			             (int)TI_FeeErrorCode(0U));
+			_exit(FEE_SIM_EXIT_FEE_ERROR);
+		}
+		if(FeeSim_Read() == FALSE)
+		{
+			_exit(FEE_SIM_EXIT_READ_FAILED);
+		}
+		if((FeeSim_ReadMatches(u32Write) == FALSE) && (FeeSim_ReadMatches(u32Write - 1U) == FALSE))
+		{
+			_exit(FEE_SIM_EXIT_WRONG_DATA);
+		}
+		/* The FEE has to stay usable after the recovery */
+		if((FeeSim_Write(0x55U) == FALSE) || (FeeSim_Read() == FALSE) || (FeeSim_ReadMatches(0x55U) == FALSE))
+		{
+			_exit(FEE_SIM_EXIT_WRITE_FAILED);
+		}
+		_exit(FEE_SIM_EXIT_OK);
+	}
+	return(FeeSim_Wait(oChild));
+}
+
+/**********************************************************************************************************************
+ *  main
+ *********************************************************************************************************************/
+int main(int argc, char * argv[])
+{
+	uint32 u32Writes = FEE_SIM_DEFAULT_WRITES;
+	uint32 u32Trials = FEE_SIM_DEFAULT_TRIALS;
+	uint32 u32Trial;
+	uint32 au32Results[7] = {0U, 0U, 0U, 0U, 0U, 0U, 0U};
+	int iResult;
+	int iExit = 0;
+
+	if(argc > 1)
+	{
+		u32Writes = (uint32)strtoul(argv[1], NULL, 0);
+	}
+	if(argc > 2)
+	{
+		u32Trials = (uint32)strtoul(argv[2], NULL, 0);
+	}
+
+	FeeSim_u16BlockNumber = Fee_BlockConfiguration[0].FeeBlockNumber;
+	FeeSim_u16BlockSize = Fee_BlockConfiguration[0].FeeBlockSize;
+	if((FeeSim_u16BlockSize > FEE_SIM_MAX_BLOCK_SIZE) || (u32Writes == 0U))
+	{
+		(void)printf("unsupported configuration\n");
+		return(1);
+	}
+	if(Fapi_Sim_Init(NULL_PTR) == FALSE)
+	{
+		(void)printf("cannot map bank 7 at 0x%08lX, build with -m32\n", (unsigned long)FAPI_SIM_BANK_START_ADDRESS);
+		return(1);
+	}
+
+	(void)printf("block %u, %u bytes\n", (unsigned)FeeSim_u16BlockNumber, (unsigned)FeeSim_u16BlockSize);
+	if(FeeSim_Benchmark(u32Writes, 0U) != 0)
+	{
+		(void)printf("benchmark FAILED\n");
+		iExit = 1;
+	}
+	(void)printf("main function budget %u us\n", (unsigned)FEE_SIM_MAIN_BUDGET_US);
+	if(FeeSim_Benchmark(u32Writes, FEE_SIM_MAIN_BUDGET_US) != 0)
+	{
+		(void)printf("benchmark FAILED\n");
+		iExit = 1;
+	}
+	if(FeeSim_StoppedTimestampTest(u32Writes) != 0)
+	{
+		iExit = 1;
+	}
+	#if (TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
+	if(FeeSim_ChecksumBenchmark() != 0)
+	{
+		iExit = 1;
+	}
+	#endif
+	if(FeeSim_LookupBenchmark() != 0)
+	{
+		iExit = 1;
+	}
+	#if (TI_FEE_ECC_SWEEP == STD_ON)
+	if(FeeSim_EccSweepTest() != 0)
+	{
+		iExit = 1;
+	}
+	#endif
+
+	for(u32Trial = 1U; u32Trial <= u32Trials; u32Trial++)
+	{
+		iResult = FeeSim_PowerLossTrial(u32Trial);
+		if(iResult == FEE_SIM_EXIT_NO_POWER_LOSS)
+		{
+			/* All rewrites finished before the n-th command */
+			break;
+		}
+		if((iResult < 0) || (iResult > FEE_SIM_EXIT_FEE_ERROR))
+		{
+			iResult = FEE_SIM_EXIT_HUNG;
+		}
+		au32Results[iResult]++;
+		if(iResult != FEE_SIM_EXIT_OK)
+		{
+			(void)printf("power loss at command %lu: failure %d\n", (unsigned long)u32Trial, iResult);
+			iExit = 1;
+		}
+	}
+	(void)printf("power loss: %lu trials, %lu ok, %lu hung, %lu FEE error, %lu read failed, %lu wrong data,"
+	             " %lu unusable\n",
+	             (unsigned long)(u32Trial - 1U), (unsigned long)au32Results[FEE_SIM_EXIT_OK],
+	             (unsigned long)au32Results[FEE_SIM_EXIT_HUNG], (unsigned long)au32Results[FEE_SIM_EXIT_FEE_ERROR],
+	             (unsigned long)au32Results[FEE_SIM_EXIT_READ_FAILED],
+	             (unsigned long)au32Results[FEE_SIM_EXIT_WRONG_DATA],
+	             (unsigned long)au32Results[FEE_SIM_EXIT_WRITE_FAILED]);
+	return(iExit);
+}
+
+/**********************************************************************************************************************
+ *  END OF FILE: fee_sim_main.c
+ *********************************************************************************************************************/
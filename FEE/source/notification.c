@@ -50,14 +50,20 @@
 
 #include "esm.h"
 #include "sys_selftest.h"
+#include "rti.h"
 
 /* USER CODE BEGIN (0) */
+#include "ti_fee.h"
 /* USER CODE END */
 #pragma WEAK(esmGroup1Notification)
 void esmGroup1Notification(uint32 channel)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (1) */
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+    /* Get the cached FEE blocks into flash before the error escalates */
+    TI_Fee_FlushWriteCache();
+#endif
 /* USER CODE END */
 }
 
@@ -68,6 +74,10 @@ void esmGroup2Notification(uint32 channel)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (3) */
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+    /* Get the cached FEE blocks into flash before the error escalates */
+    TI_Fee_FlushWriteCache();
+#endif
 /* USER CODE END */
 }
 
@@ -93,6 +103,16 @@ void memoryPort1TestFailNotification(uint32 groupSelect, uint32 dataSelect, uint
 
 /* USER CODE BEGIN (8) */
 /* USER CODE END */
+#pragma WEAK(rtiNotification)
+void rtiNotification(uint32 notification)
+{
+/*  enter user code between the USER CODE BEGIN and USER CODE END. */
+/* USER CODE BEGIN (9) */
+/* USER CODE END */
+}
+
+/* USER CODE BEGIN (10) */
+/* USER CODE END */
 
 
 
@@ -44,6 +44,8 @@
 
 /* USER CODE BEGIN (0) */
 #include "ti_fee.h"
+#include "telemetry.h"
+#include "rti.h"
 /* USER CODE END */
 
 /* Include Files */
@@ -98,7 +100,21 @@ int main(void)
 	unsigned char *Read_Ptr=read_data;
 
 	unsigned int loop;
+	#if (TI_FEE_ECC_SWEEP == STD_ON)
+	TI_Fee_EccSweepSectorStatsType oSectorStats;
+	uint16 u16Sector;
+	#endif
 	
+	/* Report the job results as telemetry records, time stamped with the PMU cycle counter */
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	telemetry_init(TELEMETRY_SOURCE_FEE);
+
+	/* TI_FEE_GET_TIMESTAMP reads the free running counter 0 of the RTI (10 MHz with the prescaler of rtiInit) */
+	rtiInit();
+	rtiStartCounter(rtiCOUNTER_BLOCK0);
+
 	/* Initialize RAM array.*/
 	for(loop=0;loop<100;loop++)SpecialRamBlock[loop] = loop;
 
@@ -112,6 +128,7 @@ int main(void)
 		Status=TI_Fee_GetStatus(0);
 	}
 	while(Status!= IDLE);
+	telemetry_put(TELEMETRY_FEE_JOB, 0U, TELEMETRY_DETAIL(TELEMETRY_FEE_INIT, TI_Fee_GetJobResult(0)));
 
 	/* Write the block into EEP Asynchronously. Block size is configured in ti_fee_cfg.c file. Default Block size is 
 	   8 bytes */
@@ -124,9 +141,11 @@ int main(void)
 		Status=TI_Fee_GetStatus(0);
 	}
 	while(Status!=IDLE);
+	telemetry_put(TELEMETRY_FEE_JOB, BlockNumber, TELEMETRY_DETAIL(TELEMETRY_FEE_WRITE, TI_Fee_GetJobResult(0)));
 
 	/* Write the block into EEP Synchronously. Write will not happen since data is same. */
 	TI_Fee_WriteSync(BlockNumber, &SpecialRamBlock[0]);
+	telemetry_put(TELEMETRY_FEE_JOB, BlockNumber, TELEMETRY_DETAIL(TELEMETRY_FEE_WRITE, TI_Fee_GetJobResult(0)));
 
 	/* Read the block with unknown length */
 	 BlockOffset = 0;
@@ -139,6 +158,7 @@ int main(void)
 		 Status=TI_Fee_GetStatus(0);
 	 }
 	while(Status!=IDLE);
+	telemetry_put(TELEMETRY_FEE_JOB, BlockNumber, TELEMETRY_DETAIL(TELEMETRY_FEE_READ, TI_Fee_GetJobResult(0)));
 
 	/* Invalidate a written block  */
 	TI_Fee_InvalidateBlock(BlockNumber);
@@ -149,11 +169,41 @@ int main(void)
 		Status=TI_Fee_GetStatus(0);
 	}
 	while(Status!=IDLE);
+	telemetry_put(TELEMETRY_FEE_JOB, BlockNumber, TELEMETRY_DETAIL(TELEMETRY_FEE_INVALIDATE, TI_Fee_GetJobResult(0)));
 
 	/* Format bank 7 */
 	TI_Fee_Format(0xA5A5A5A5U);
+	telemetry_put(TELEMETRY_FEE_JOB, 0U, TELEMETRY_DETAIL(TELEMETRY_FEE_FORMAT, TI_Fee_GetJobResult(0)));
+	(void)telemetry_flush();
 
+	#if (TI_FEE_ECC_SWEEP == STD_ON)
+	/* Sweep the flash ECC in the idle loop */
+	TI_Fee_EccSweepInit();
+	while(1)
+	{
+		if(TI_Fee_EccSweepStep() == TRUE)
+		{
+			/* Report the sectors with errors in the pass */
+			for(u16Sector = 0U; u16Sector < TI_FEE_ECC_SWEEP_SECTORS; u16Sector++)
+			{
+				TI_Fee_GetEccSweepSectorStats(u16Sector, &oSectorStats);
+				if(oSectorStats.u32PassCorrected != 0U)
+				{
+					telemetry_put(TELEMETRY_ECC_ERROR, oSectorStats.u32LastErrorAddress,
+					              TELEMETRY_DETAIL(TELEMETRY_ECC_FLASH_SINGLE, (oSectorStats.u32PassCorrected > 255U) ? 255U : oSectorStats.u32PassCorrected));
+				}
+				if(oSectorStats.u32PassUncorrectable != 0U)
+				{
+					telemetry_put(TELEMETRY_ECC_ERROR, oSectorStats.u32LastErrorAddress,
+					              TELEMETRY_DETAIL(TELEMETRY_ECC_FLASH_DOUBLE, (oSectorStats.u32PassUncorrectable > 255U) ? 255U : oSectorStats.u32PassUncorrectable));
+				}
+			}
+			(void)telemetry_flush();
+		}
+	}
+	#else
     while(1);
+	#endif
 /* USER CODE END */
 
     return 0;
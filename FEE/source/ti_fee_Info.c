@@ -135,6 +135,95 @@ TI_FeeJobResultType TI_Fee_GetJobResult(uint8 u8EEPIndex)
 	return(TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error);
 }
 
+/**********************************************************************************************************************
+ *  TI_Fee_GetLatencyStats
+ *********************************************************************************************************************/
+/*! \brief      This function returns the job latency statistics of the EEP, counted in calls of TI_Fee_MainFunction.
+ *  \param[in]  u8EEPIndex
+ *  \param[out] pLatencyStats
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_GetLatencyStats(uint8 u8EEPIndex, TI_Fee_LatencyStatsType * pLatencyStats)
+{
+	if(pLatencyStats != NULL_PTR)
+	{
+		*pLatencyStats = TI_Fee_oLatencyStats[u8EEPIndex];
+	}	
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_ClearLatencyStats
+ *********************************************************************************************************************/
+/*! \brief      This function clears the job latency statistics of the EEP. A job in progress is recorded when it
+ *				completes.
+ *  \param[in]  u8EEPIndex
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_ClearLatencyStats(uint8 u8EEPIndex)
+{
+	TI_Fee_oLatencyStats[u8EEPIndex].u32Jobs = 0U;
+	TI_Fee_oLatencyStats[u8EEPIndex].u32MaxJobCalls = 0U;
+	TI_Fee_oLatencyStats[u8EEPIndex].u32MaxInternalCalls = 0U;
+	TI_Fee_oLatencyStats[u8EEPIndex].u32BackgroundCopies = 0U;
+}
+
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+/**********************************************************************************************************************
+ *  TI_Fee_GetStepStats
+ *********************************************************************************************************************/
+/*! \brief      This function returns the cycle statistics of a step type, in TI_FEE_GET_TIMESTAMP ticks.
+ *  \param[in]  StepType
+ *  \param[out] pStepStats
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_GetStepStats(TI_Fee_StepType StepType, TI_Fee_StepStatsType * pStepStats)
+{
+	if((pStepStats != NULL_PTR) && (StepType < TI_FEE_NUMBER_OF_STEP_TYPES))
+	{
+		*pStepStats = TI_Fee_oStepStats[StepType];
+	}	
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_ClearStepStats
+ *********************************************************************************************************************/
+/*! \brief      This function clears the cycle statistics of all step types. The budget of TI_Fee_MainFunction is 
+ *				then applied from the first step measured again.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_ClearStepStats(void)
+{
+	uint8 u8StepType;
+	uint8 u8Bin;
+
+	for(u8StepType = 0U; u8StepType < (uint8)TI_FEE_NUMBER_OF_STEP_TYPES; u8StepType++)
+	{
+		TI_Fee_oStepStats[u8StepType].u32Steps = 0U;
+		TI_Fee_oStepStats[u8StepType].u32MaxTicks = 0U;
+		TI_Fee_oStepStats[u8StepType].u64TotalTicks = 0U;
+		for(u8Bin = 0U; u8Bin < TI_FEE_STEP_HISTOGRAM_BINS; u8Bin++)
+		{
+			TI_Fee_oStepStats[u8StepType].au32Histogram[u8Bin] = 0U;
+		}
+	}
+}
+#endif
+
 /*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
 #define FEE_STOP_SEC_CODE
 /*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
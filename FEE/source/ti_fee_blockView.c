@@ -0,0 +1,223 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  ti_fee_blockView.c
+ *      Project:  Tms570_TIFEEDriver
+ *       Module:  TIFEEDriver
+ *    Generator:  None
+ *
+ *  Description:  This file implements the TI FEE Api TI_Fee_GetBlockView, which returns the data of a block in place
+ *                instead of copying it.
+ *********************************************************************************************************************/
+
+ /*********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#include "ti_fee.h"
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_START_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+
+/**********************************************************************************************************************
+ *  TI_Fee_GetBlockView
+ *********************************************************************************************************************/
+/*! \brief      This function returns a pointer to the data of a block in the FEE bank, so that the data can be used
+ *				in place. No job is started, the job result of the FEE is not changed.
+ *				The block header has to be valid and the block size in the header has to match the configuration.
+ *				The data is read once to check the checksum in the block header (TI_FEE_FLASH_CHECKSUM_ENABLE) and
+ *				the uncorrectable ECC error flag (TI_FEE_FLASH_ERROR_CORRECTION_ENABLE).
+ *				A block which is only in the write cache (TI_FEE_WRITE_CACHE) is returned from RAM.
+ *				The data stays in place until the virtual sector holding it is erased, which the FEE only does after
+ *				a write, invalidate or erase job, TI_Fee_Format or TI_Fee_ErrorRecovery. Do not use the pointer after
+ *				one of them was called.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[out] ppu8Data : Start of the block data
+ *  \param[out] pu16Length : Size of the block data
+ *  \return     JOB_OK
+ *  \return     JOB_FAILED : Parameters wrong, FEE not initialized or busy with a job or an internal operation
+ *  \return     BLOCK_INVALID : Block was never written or has been invalidated
+ *  \return     BLOCK_INCONSISTENT : Block header, checksum or ECC of the data wrong
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+TI_FeeJobResultType TI_Fee_GetBlockView(uint16 BlockNumber, const uint8 ** ppu8Data, uint16 * pu16Length)
+{
+	TI_FeeJobResultType oResult = JOB_FAILED;
+	TI_Fee_AddressType oBlockAddress = 0U;
+	uint32 au32BlockAddress[2];
+	uint32 au32BlockStatus[2];
+	uint32 **ppu32ReadHeader = 0U;
+	uint16 u16BlockNumber = 0U;
+	uint16 u16BlockIndex = 0U;
+	uint16 u16DataSetNumber = 0U;
+	uint16 u16ArrayIndex = 0U;
+	uint16 u16BlockSize = 0U;
+	uint8 u8EEPIndex = 0U;
+	const uint8 * pu8Data = NULL_PTR;
+	#if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
+	uint32 u32CheckSum = 0U;
+	#elif (STD_ON == TI_FEE_FLASH_ERROR_CORRECTION_ENABLE)
+	volatile uint32 u32Sink = 0U;
+	const uint32 * pu32Data;
+	uint16 u16Word;
+	#endif
+
+	if((ppu8Data != NULL_PTR) && (pu16Length != NULL_PTR))
+	{
+		/* From the block number, remove data selection bits */
+		u16BlockNumber = TI_FeeInternal_GetBlockNumber(BlockNumber);
+		/* Get the index of the block in Fee_BlockConfiguration array */
+		u16BlockIndex = TI_FeeInternal_GetBlockIndex(u16BlockNumber);
+		/*SAFETYMCUSW 91 D MR:16.10 <APPROVED> "Reason - Return value is used in following code."*/
+		u16DataSetNumber = TI_FeeInternal_GetDataSetIndex(BlockNumber);
+		if(u16BlockIndex != 0xFFFFU)
+		{
+			u8EEPIndex = Fee_BlockConfiguration[u16BlockIndex].FeeEEPNumber;
+			u16BlockSize = Fee_BlockConfiguration[u16BlockIndex].FeeBlockSize;
+			#if (TI_FEE_WRITE_CACHE == STD_ON)
+			pu8Data = TI_FeeInternal_WriteCacheView(BlockNumber);
+			#endif
+		}
+		if((u16BlockIndex == 0xFFFFU) || (TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState == UNINIT) ||
+		   ((Fee_BlockConfiguration[u16BlockIndex].FeeNumberOfDataSets > 1U) &&
+		    (u16DataSetNumber >= Fee_BlockConfiguration[u16BlockIndex].FeeNumberOfDataSets)))
+		{
+			/* MISRA C Compliance */
+		}
+		else if(pu8Data != NULL_PTR)
+		{
+			/* Latest data of the block is in the write cache */
+			oResult = JOB_OK;
+		}
+		/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should be fixed
+		  outside of FEE."*/
+		else if((TI_FeeInternal_CheckModuleState(u8EEPIndex) == (uint8)E_OK) &&
+		        (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING))
+		{
+			/* Get the Current Block Address for this Block */
+			u16ArrayIndex = TI_FeeInternal_GetArrayIndex(u16BlockNumber, u16DataSetNumber, u8EEPIndex, TRUE);
+			oBlockAddress = TI_FeeInternal_GetCurrentBlockAddress(u16ArrayIndex, u16DataSetNumber, u8EEPIndex);
+			if(oBlockAddress == 0x00000000U)
+			{
+				oResult = BLOCK_INVALID;
+			}
+			else
+			{
+				/* Wait till FSM is READY */
+				(void)TI_FeeInternal_PollFlashStatus();
+				au32BlockAddress[0] = oBlockAddress;
+				au32BlockAddress[1] = au32BlockAddress[0]+4U;
+				/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				ppu32ReadHeader = (uint32 **)&au32BlockAddress[0];
+				au32BlockStatus[0] = **ppu32ReadHeader;
+				/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				ppu32ReadHeader = (uint32 **)&au32BlockAddress[1];
+				au32BlockStatus[1] = **ppu32ReadHeader;
+				/* If block header is 24 bytes(0-23), 20-21 bytes are block size */
+				au32BlockAddress[1] = oBlockAddress + (((TI_FEE_BLOCK_OVERHEAD >> 2U)-1U) << 2U);
+				/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+				ppu32ReadHeader = (uint32 **)&au32BlockAddress[1];
+
+				if((au32BlockStatus[0] == InvalidBlockLo) && (au32BlockStatus[1] == InvalidBlockHi))
+				{
+					oResult = BLOCK_INVALID;
+				}
+				else if((au32BlockStatus[0] != ValidBlockLo) || (au32BlockStatus[1] != ValidBlockHi))
+				{
+					oResult = BLOCK_INCONSISTENT;
+				}
+				else if((uint16)(((**ppu32ReadHeader) & 0xFFFF0000U) >> 16U) == 0U)
+				{
+					/* Invalidated blocks are written without data */
+					oResult = BLOCK_INVALID;
+				}
+				else if((uint16)(((**ppu32ReadHeader) & 0xFFFF0000U) >> 16U) != u16BlockSize)
+				{
+					oResult = BLOCK_INCONSISTENT;
+				}
+				else
+				{
+					/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here."*/
+					pu8Data = (const uint8 *)(oBlockAddress + TI_FEE_BLOCK_OVERHEAD);
+					oResult = JOB_OK;
+					#if(TI_FEE_CHECK_BANK7_ACCESS == STD_ON)
+					if((oBlockAddress + TI_FEE_BLOCK_OVERHEAD + u16BlockSize) >
+					   (Device_FlashDevice.Device_BankInfo[0].Device_SectorInfo[DEVICE_BANK_MAX_NUMBER_OF_SECTORS-1U].Device_SectorStartAddress +
+					    Device_FlashDevice.Device_BankInfo[0].Device_SectorInfo[DEVICE_BANK_MAX_NUMBER_OF_SECTORS-1U].Device_SectorLength))
+					{
+						oResult = JOB_FAILED;
+					}
+					#endif
+					#ifndef _L2FMC
+					#if (STD_ON == TI_FEE_FLASH_ERROR_CORRECTION_ENABLE)
+					/* Clear multi bit error's before reading the data */
+					if(1U == Device_FlashDevice.Device_BankInfo[0].Device_ControlRegister->EeStatus.EE_STATUS_BITS.EE_UNC_ERR)
+					{
+						Device_FlashDevice.Device_BankInfo[0].Device_ControlRegister->EeStatus.EE_STATUS_BITS.EE_UNC_ERR = 1U;
+					}
+					#endif
+					#endif
+					#if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
+					/* If block header is 24 bytes(0-23), 12-15 bytes are Checksum */
+					au32BlockAddress[1] = oBlockAddress + (((TI_FEE_BLOCK_OVERHEAD >> 2U)-3U) << 2U);
+					u32CheckSum = **ppu32ReadHeader;
+					if((oResult == JOB_OK) &&
+					   ((TI_FeeInternal_Fletcher16(pu8Data, u16BlockSize) | 0xFFFF0000U) != u32CheckSum))
+					{
+						oResult = BLOCK_INCONSISTENT;
+					}
+					#elif (STD_ON == TI_FEE_FLASH_ERROR_CORRECTION_ENABLE)
+					/* Read the data once, so that ECC errors are flagged */
+					/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+					/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+					pu32Data = (const uint32 *)pu8Data;
+					for(u16Word = 0U; (oResult == JOB_OK) && (u16Word < ((u16BlockSize + 3U) >> 2U)); u16Word++)
+					{
+						u32Sink ^= pu32Data[u16Word];
+					}
+					#endif
+					#ifndef _L2FMC
+					#if (STD_ON == TI_FEE_FLASH_ERROR_CORRECTION_ENABLE)
+					/* Check if there is multi bit error/uncorectable error */
+					if((oResult == JOB_OK) &&
+					   (1U == Device_FlashDevice.Device_BankInfo[0].Device_ControlRegister->EeStatus.EE_STATUS_BITS.EE_UNC_ERR))
+					{
+						oResult = BLOCK_INCONSISTENT;
+					}
+					#endif
+					#endif
+				}
+			}
+		}
+		else
+		{
+			/* MISRA C Compliance */
+		}
+		if(oResult == JOB_OK)
+		{
+			*ppu8Data = pu8Data;
+			*pu16Length = u16BlockSize;
+		}
+		else
+		{
+			*ppu8Data = NULL_PTR;
+			*pu16Length = 0U;
+		}
+	}
+	return(oResult);
+}
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_STOP_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+
+/**********************************************************************************************************************
+ *  END OF FILE: ti_fee_blockView.c
+ *********************************************************************************************************************/
@@ -0,0 +1,348 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  ti_fee_eccSweep.c
+ *      Project:  Tms570_TIFEEDriver
+ *       Module:  TIFEEDriver
+ *    Generator:  None
+ *
+ *  Description:  This file implements the flash ECC sweep (TI_FEE_ECC_SWEEP) and the TI FEE Apis
+ *                TI_Fee_EccSweepInit, TI_Fee_EccSweepStep, TI_Fee_SetEccSweepRate, TI_Fee_GetEccSweepStats and
+ *                TI_Fee_GetEccSweepSectorStats.
+ *
+ *                The sweep walks the sectors of TI_FEE_ECC_SWEEP_SECTOR_LIST in order, a slice of double words per
+ *                call of TI_Fee_EccSweepStep. After each slice the error status of bank 0 (FEDACSTATUS) and of bank 7
+ *                (EE_STATUS) is harvested: a corrected error is counted with the error counter of the bank, an
+ *                uncorrectable one once, both for the sector holding the reported address. The wrapper latches a
+ *                single address per flag, so several errors within one slice are all counted for the sector of the
+ *                last one. Flash errors are not repaired by a read; an upset stays and is counted on every pass
+ *                until the sector is reprogrammed.
+ *********************************************************************************************************************/
+
+ /*********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#include "ti_fee.h"
+
+#if (TI_FEE_ECC_SWEEP == STD_ON)
+/**********************************************************************************************************************
+ * LOCAL CONSTANT MACROS
+ *********************************************************************************************************************/
+/* Error flags, at the same position in FEDACSTATUS and EE_STATUS */
+#define TI_FEE_ECC_SWEEP_COR_ERR        0x00000002U     /* Single-bit error corrected */
+#define TI_FEE_ECC_SWEEP_UNC_ERR        0x00000100U     /* Uncorrectable error */
+/* The budget is compared after this number of double words */
+#define TI_FEE_ECC_SWEEP_BUDGET_CHECK   0x1FU
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_START_SEC_CONST_UNSPECIFIED
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+static const TI_Fee_EccSweepSectorType TI_Fee_aoEccSweepSectors[TI_FEE_ECC_SWEEP_SECTORS] =
+	TI_FEE_ECC_SWEEP_SECTOR_LIST;
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_STOP_SEC_CONST_UNSPECIFIED
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_START_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_EccSweepCount
+ *********************************************************************************************************************/
+/*! \brief      This function counts errors for the swept sector which holds the reported address.
+ *  \param[in]  u32Address : Address reported by the wrapper
+ *  \param[in]  u32Errors : Number of errors
+ *  \param[in]  bUncorrectable
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_EccSweepCount(uint32 u32Address, uint32 u32Errors, boolean bUncorrectable)
+{
+	uint16 u16Sector = 0U;
+	uint32 u32DoubleWord = u32Address & ~7U;
+
+	while((u16Sector < TI_FEE_ECC_SWEEP_SECTORS) &&
+	      ((u32DoubleWord < TI_Fee_aoEccSweepSectors[u16Sector].u32StartAddress) ||
+	       ((u32DoubleWord - TI_Fee_aoEccSweepSectors[u16Sector].u32StartAddress) >=
+	        TI_Fee_aoEccSweepSectors[u16Sector].u32Length)))
+	{
+		u16Sector++;
+	}
+
+	if(u16Sector == TI_FEE_ECC_SWEEP_SECTORS)
+	{
+		TI_Fee_oEccSweepStats.u32Unattributed += u32Errors;
+	}
+	else
+	{
+		if(bUncorrectable == TRUE)
+		{
+			TI_Fee_aoEccSweepSectorStats[u16Sector].u32Uncorrectable += u32Errors;
+			TI_Fee_au32EccSweepPassUncorrectable[u16Sector] += u32Errors;
+		}
+		else
+		{
+			TI_Fee_aoEccSweepSectorStats[u16Sector].u32Corrected += u32Errors;
+			TI_Fee_au32EccSweepPassCorrected[u16Sector] += u32Errors;
+		}
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32LastErrorAddress = u32DoubleWord;
+	}
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_EccSweepHarvestBank
+ *********************************************************************************************************************/
+/*! \brief      This function counts and clears the error flags of one bank.
+ *  \param[in]  poStatus : FEDACSTATUS or EE_STATUS
+ *  \param[in]  poCount : FCOR_ERR_CNT or EE_COR_ERR_CNT
+ *  \param[in]  poCorrectedAddress : FCOR_ERR_ADD or EE_COR_ERR_ADD
+ *  \param[in]  poUncorrectableAddress : FUNC_ERR_ADD or EE_UNC_ERR_ADD
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_EccSweepHarvestBank(Fapi_FmcRegisterType * poStatus, Fapi_FmcRegisterType * poCount,
+                                               Fapi_FmcRegisterType * poCorrectedAddress,
+                                               Fapi_FmcRegisterType * poUncorrectableAddress)
+{
+	uint32 u32Flags = poStatus->u32Register & (TI_FEE_ECC_SWEEP_COR_ERR | TI_FEE_ECC_SWEEP_UNC_ERR);
+	uint32 u32Count;
+
+	if((u32Flags & TI_FEE_ECC_SWEEP_COR_ERR) != 0U)
+	{
+		/* The counter only counts with a threshold set; the flag alone is one error */
+		u32Count = poCount->u32Register;
+		TI_FeeInternal_EccSweepCount(poCorrectedAddress->u32Register, (u32Count > 1U) ? u32Count : 1U, FALSE);
+		poCount->u32Register = 0U;
+	}
+	if((u32Flags & TI_FEE_ECC_SWEEP_UNC_ERR) != 0U)
+	{
+		TI_FeeInternal_EccSweepCount(poUncorrectableAddress->u32Register, 1U, TRUE);
+	}
+	if(u32Flags != 0U)
+	{
+		TI_FEE_CLEAR_ERROR_STATUS(&poStatus->u32Register, u32Flags);
+	}
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_EccSweepHarvest
+ *********************************************************************************************************************/
+/*! \brief      This function counts and clears the error flags of bank 0 and bank 7.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_EccSweepHarvest(void)
+{
+	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  ( pFapi_FmcRegistersType ) ( 0xFFF87000U ) ) casting
+	 is done in F021 library.*/
+	Fapi_FmcRegistersType * poRegisters = Device_FlashDevice.Device_BankInfo[0].Device_ControlRegister;
+
+	TI_FeeInternal_EccSweepHarvestBank(&poRegisters->FedAcStatus, &poRegisters->FcorErrCnt, &poRegisters->FcorErrAdd,
+	                                   &poRegisters->FuncErrAdd);
+	TI_FeeInternal_EccSweepHarvestBank(&poRegisters->EeStatus, &poRegisters->EeCorErrCnt, &poRegisters->EeCorErrAdd,
+	                                   &poRegisters->EeUncErrAdd);
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_EccSweepInit
+ *********************************************************************************************************************/
+/*! \brief      This function starts a new pass at the first sector, clears the statistics and sets the rate to
+ *				TI_FEE_ECC_SWEEP_DOUBLEWORDS and TI_FEE_ECC_SWEEP_BUDGET. Errors still flagged, e.g. the one which
+ *				caused a reset, are counted for the current pass.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_EccSweepInit(void)
+{
+	uint16 u16Sector;
+
+	for(u16Sector = 0U; u16Sector < TI_FEE_ECC_SWEEP_SECTORS; u16Sector++)
+	{
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32Corrected = 0U;
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32Uncorrectable = 0U;
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32PassCorrected = 0U;
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32PassUncorrectable = 0U;
+		TI_Fee_aoEccSweepSectorStats[u16Sector].u32LastErrorAddress = 0U;
+		TI_Fee_au32EccSweepPassCorrected[u16Sector] = 0U;
+		TI_Fee_au32EccSweepPassUncorrectable[u16Sector] = 0U;
+	}
+	TI_Fee_oEccSweepStats.u32Passes = 0U;
+	TI_Fee_oEccSweepStats.u32PassTicks = 0U;
+	TI_Fee_oEccSweepStats.u32StepMaxTicks = 0U;
+	TI_Fee_oEccSweepStats.u32SkippedSteps = 0U;
+	TI_Fee_oEccSweepStats.u32Unattributed = 0U;
+	TI_Fee_u16EccSweepSector = 0U;
+	TI_Fee_u32EccSweepOffset = 0U;
+	TI_Fee_SetEccSweepRate(TI_FEE_ECC_SWEEP_DOUBLEWORDS, TI_FEE_ECC_SWEEP_BUDGET);
+
+	TI_FeeInternal_EccSweepHarvest();
+	TI_Fee_u32EccSweepPassStart = TI_FEE_GET_TIMESTAMP();
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_EccSweepStep
+ *********************************************************************************************************************/
+/*! \brief      This function reads the next slice of the sweep and harvests the error flags. A step does not
+ *				cross a sector boundary. A step on a bank 7 sector does nothing while the FSM is busy. With a budget
+ *				set, a step ends after TI_FEE_ECC_SWEEP_BUDGET_CHECK + 1 reads if TI_FEE_GET_TIMESTAMP did not
+ *				advance.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     TRUE if the step completed a pass over all sectors
+ *  \context    Function could be called from task level, e.g. next to TI_Fee_MainFunction
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+boolean TI_Fee_EccSweepStep(void)
+{
+	const TI_Fee_EccSweepSectorType * poSector = &TI_Fee_aoEccSweepSectors[TI_Fee_u16EccSweepSector];
+	uint32 u32Start = TI_FEE_GET_TIMESTAMP();
+	uint32 u32Address = poSector->u32StartAddress + TI_Fee_u32EccSweepOffset;
+	uint32 u32End = poSector->u32StartAddress + poSector->u32Length;
+	uint32 u32Read = 0U;
+	uint32 u32Now;
+	uint32 u32Ticks;
+	uint16 u16Sector;
+	boolean bBudgetSpent = FALSE;
+	boolean bPassDone = FALSE;
+
+	/*SAFETYMCUSW 114 S MR:12.6,13.2 <APPROVED> "Reason -  LDRA does not understand macro
+	  FAPI_CHECK_FSM_READY_BUSY."*/
+	if((poSector->oBank == Fapi_FlashBank7) && (FAPI_CHECK_FSM_READY_BUSY == Fapi_Status_FsmBusy))
+	{
+		TI_Fee_oEccSweepStats.u32SkippedSteps++;
+	}
+	else
+	{
+		while((u32Address < u32End) && (u32Read < TI_Fee_u32EccSweepDoubleWords) && (bBudgetSpent == FALSE))
+		{
+			TI_FEE_ECC_SWEEP_READ(u32Address);
+			u32Address += 8U;
+			u32Read++;
+			if(((u32Read & TI_FEE_ECC_SWEEP_BUDGET_CHECK) == 0U) && (TI_Fee_u32EccSweepBudget != 0U))
+			{
+				u32Now = TI_FEE_GET_TIMESTAMP();
+				/* A timestamp that did not move over TI_FEE_ECC_SWEEP_BUDGET_CHECK + 1 reads comes from a stopped 
+				   counter, which would never end the step */
+				if((u32Now == u32Start) || ((u32Now - u32Start) >= TI_Fee_u32EccSweepBudget))
+				{
+					bBudgetSpent = TRUE;
+				}
+			}
+		}
+		TI_Fee_u32EccSweepOffset = u32Address - poSector->u32StartAddress;
+		TI_FeeInternal_EccSweepHarvest();
+
+		if(u32Address >= u32End)
+		{
+			TI_Fee_u32EccSweepOffset = 0U;
+			TI_Fee_u16EccSweepSector++;
+			if(TI_Fee_u16EccSweepSector >= TI_FEE_ECC_SWEEP_SECTORS)
+			{
+				TI_Fee_u16EccSweepSector = 0U;
+				for(u16Sector = 0U; u16Sector < TI_FEE_ECC_SWEEP_SECTORS; u16Sector++)
+				{
+					TI_Fee_aoEccSweepSectorStats[u16Sector].u32PassCorrected = TI_Fee_au32EccSweepPassCorrected[u16Sector];
+					TI_Fee_aoEccSweepSectorStats[u16Sector].u32PassUncorrectable =
+						TI_Fee_au32EccSweepPassUncorrectable[u16Sector];
+					TI_Fee_au32EccSweepPassCorrected[u16Sector] = 0U;
+					TI_Fee_au32EccSweepPassUncorrectable[u16Sector] = 0U;
+				}
+				TI_Fee_oEccSweepStats.u32Passes++;
+				TI_Fee_oEccSweepStats.u32PassTicks = TI_FEE_GET_TIMESTAMP() - TI_Fee_u32EccSweepPassStart;
+				TI_Fee_u32EccSweepPassStart = TI_FEE_GET_TIMESTAMP();
+				bPassDone = TRUE;
+			}
+		}
+	}
+
+	u32Ticks = TI_FEE_GET_TIMESTAMP() - u32Start;
+	if(u32Ticks > TI_Fee_oEccSweepStats.u32StepMaxTicks)
+	{
+		TI_Fee_oEccSweepStats.u32StepMaxTicks = u32Ticks;
+	}
+	return(bPassDone);
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_SetEccSweepRate
+ *********************************************************************************************************************/
+/*! \brief      This function sets the double words read per step and the budget of a step. A full pass takes the
+ *				sum of the sector lengths / (8 * u32DoubleWords) steps, or more when the budget ends steps early.
+ *  \param[in]  u32DoubleWords : Maximum double words per step, at least 1
+ *  \param[in]  u32BudgetTicks : Budget of a step in TI_FEE_GET_TIMESTAMP ticks, 0 for none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_SetEccSweepRate(uint32 u32DoubleWords, uint32 u32BudgetTicks)
+{
+	TI_Fee_u32EccSweepDoubleWords = (u32DoubleWords == 0U) ? 1U : u32DoubleWords;
+	TI_Fee_u32EccSweepBudget = u32BudgetTicks;
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_GetEccSweepStats
+ *********************************************************************************************************************/
+/*! \brief      This function returns the statistics of the ECC sweep.
+ *  \param[in]  none
+ *  \param[out] pEccSweepStats
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_GetEccSweepStats(TI_Fee_EccSweepStatsType * pEccSweepStats)
+{
+	if(pEccSweepStats != NULL_PTR)
+	{
+		*pEccSweepStats = TI_Fee_oEccSweepStats;
+	}
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_GetEccSweepSectorStats
+ *********************************************************************************************************************/
+/*! \brief      This function returns the error counts of a swept sector. The error density of the sector is
+ *				u32PassCorrected and u32PassUncorrectable over the length of the sector.
+ *  \param[in]  u16Sector : Index into TI_FEE_ECC_SWEEP_SECTOR_LIST
+ *  \param[out] pSectorStats
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_GetEccSweepSectorStats(uint16 u16Sector, TI_Fee_EccSweepSectorStatsType * pSectorStats)
+{
+	if((pSectorStats != NULL_PTR) && (u16Sector < TI_FEE_ECC_SWEEP_SECTORS))
+	{
+		*pSectorStats = TI_Fee_aoEccSweepSectorStats[u16Sector];
+	}
+}
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_STOP_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+#endif
+
+/**********************************************************************************************************************
+ *  END OF FILE: ti_fee_eccSweep.c
+ *********************************************************************************************************************/
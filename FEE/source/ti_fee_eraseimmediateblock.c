@@ -233,6 +233,15 @@ Std_ReturnType TI_Fee_EraseImmediateBlock(uint16 BlockNumber)
 	TI_Fee_oStatusWord_Global.Fee_u16StatusWord = ((TI_Fee_oStatusWord[0].Fee_u16StatusWord) |
 												   (TI_Fee_oStatusWord[1].Fee_u16StatusWord));
 	#endif  
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should be fixed 
+	  outside of FEE."*/
+	if(oResult == (uint8)E_OK)
+	{
+		/* The job supersedes data of the block which is not flushed yet */
+		TI_FeeInternal_WriteCacheDiscard(BlockNumber);
+	}
+	#endif
     return(oResult);	
 }
 
@@ -174,6 +174,38 @@ uint16 TI_Fee_u16NumberOfUnconfiguredBlocks[TI_FEE_NUMBER_OF_EEPS];
 TI_Fee_StatusWordType_UN TI_Fee_oStatusWord_Global;
 #endif
 boolean TI_Fee_FapiInitCalled; 
+uint16 TI_Fee_au16BlockHash[TI_FEE_BLOCK_HASH_SIZE];
+uint16 TI_Fee_au16DataSetStart[TI_FEE_NUMBER_OF_BLOCKS + 1U];
+uint16 TI_Fee_au16ArrayToBlockIndex[TI_FEE_TOTAL_BLOCKS_DATASETS];
+TI_Fee_LatencyStatsType TI_Fee_oLatencyStats[TI_FEE_NUMBER_OF_EEPS];
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+TI_Fee_StepStatsType TI_Fee_oStepStats[TI_FEE_NUMBER_OF_STEP_TYPES];
+uint32 TI_Fee_u32MainFunctionBudget = TI_FEE_MAIN_FUNCTION_BUDGET;
+#endif
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+TI_Fee_WriteCacheEntryType TI_Fee_aoWriteCache[TI_FEE_WRITE_CACHE_BLOCKS];
+uint32 TI_Fee_au32WriteCacheData[(TI_FEE_WRITE_CACHE_SIZE + 3U) / 4U];
+uint32 TI_Fee_au32WriteCacheDirty[(TI_FEE_WRITE_CACHE_BLOCKS + 31U) / 32U];
+uint16 TI_Fee_u16WriteCacheFlushEntry;
+volatile boolean TI_Fee_bWriteCacheFlushRequest;
+TI_Fee_WriteCacheStatsType TI_Fee_oWriteCacheStats;
+#endif
+#if (TI_FEE_ECC_SWEEP == STD_ON)
+TI_Fee_EccSweepSectorStatsType TI_Fee_aoEccSweepSectorStats[TI_FEE_ECC_SWEEP_SECTORS];
+uint32 TI_Fee_au32EccSweepPassCorrected[TI_FEE_ECC_SWEEP_SECTORS];
+uint32 TI_Fee_au32EccSweepPassUncorrectable[TI_FEE_ECC_SWEEP_SECTORS];
+TI_Fee_EccSweepStatsType TI_Fee_oEccSweepStats;
+uint16 TI_Fee_u16EccSweepSector;
+uint32 TI_Fee_u32EccSweepOffset;
+uint32 TI_Fee_u32EccSweepDoubleWords;
+uint32 TI_Fee_u32EccSweepBudget;
+uint32 TI_Fee_u32EccSweepPassStart;
+#endif
+
+#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+uint16 TI_Fee_au16SnapshotStep[TI_FEE_NUMBER_OF_EEPS];
+uint32 TI_Fee_au32SnapshotAddress[TI_FEE_NUMBER_OF_EEPS];
+#endif
 
 #define	TI_FEE_GET_DEVICE_TYPE	(*(volatile uint32*) (0xFFF87400U))
 
@@ -226,6 +258,9 @@ void TI_Fee_Init(void)
 	TI_Fee_u32FletcherChecksum = 0xFFFFFFFFU;
 	#endif
 	TI_Fee_bEraseSuspended = FALSE;
+	#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+	TI_Fee_ClearStepStats();
+	#endif
 	
 	#if (TI_FEE_GENERATE_DEVICEANDVIRTUALSECTORSTRUC == STD_ON)	
 	if((((TI_FEE_GET_DEVICE_TYPE) & 0xFFF00000U) >> 20U) > 73U)
@@ -240,11 +275,22 @@ void TI_Fee_Init(void)
 	}	
 	#endif
 
+	/* Build the block number lookup used by every job before scanning the virtual sectors */
+	TI_FeeInternal_BuildBlockIndex();
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	TI_FeeInternal_WriteCacheInit();
+	#endif
+
 	while(u8EEPIndex<TI_FEE_NUMBER_OF_EEPS)
 	{	
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_oVirtualSectorStartAddress=0xFFFFFFFFU;		
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockIndex=0U;
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockCopyIndex=0xFFFFU;
+		#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+		/* A snapshot interrupted by the reinitialization is left like one interrupted by a power loss */
+		TI_Fee_au16SnapshotStep[u8EEPIndex]=0U;
+		TI_Fee_au32SnapshotAddress[u8EEPIndex]=0U;
+		#endif
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16DataSetIndex=0U;
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize=0U;
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector=0U;
@@ -270,6 +316,7 @@ void TI_Fee_Init(void)
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_bWriteStartProgram = FALSE;	
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_bWritePartialBlockHeader	= FALSE;	
 		TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress = 0xFFFFFFFFU;
+		TI_Fee_ClearLatencyStats(u8EEPIndex);
 		
 		bActiveVSScanned[u8EEPIndex] = FALSE;
 		bFoundActiveVS[u8EEPIndex] = FALSE;
@@ -114,21 +114,203 @@ boolean Fee_bSingleBitError;
 /*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
 #include "MemMap.h"
 /***********************************************************************************************************************
- *  TI_Fee_MainFunction
+ *  TI_FeeInternal_UpdateLatencyStats
  **********************************************************************************************************************/
-/*! \brief      This function is a cyclic function. It will Write data, Read Data, Invalidate Block, Erase Block,
- *				Copy blocks, Erase Sectors. 
+/*! \brief      This function counts the calls of TI_Fee_MainFunction a job stays pending, and the calls spent in 
+ *				BUSY_INTERNAL without a job, and records the maximum of both.
+ *  \param[in]  u8EEPIndex
+ *  \param[in]  bJobPending : TRUE if the job result was JOB_PENDING when TI_Fee_MainFunction was called
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_MainFunction.
+ *  \note       TI FEE Internal API.
+ **********************************************************************************************************************/
+static void TI_FeeInternal_UpdateLatencyStats(uint8 u8EEPIndex, boolean bJobPending)
+{
+	static uint32 au32JobCalls[TI_FEE_NUMBER_OF_EEPS];
+	static uint32 au32InternalCalls[TI_FEE_NUMBER_OF_EEPS];
+
+	if(bJobPending == TRUE)
+	{
+		au32JobCalls[u8EEPIndex]++;
+		if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING)
+		{
+			TI_Fee_oLatencyStats[u8EEPIndex].u32Jobs++;
+			if(au32JobCalls[u8EEPIndex] > TI_Fee_oLatencyStats[u8EEPIndex].u32MaxJobCalls)
+			{
+				TI_Fee_oLatencyStats[u8EEPIndex].u32MaxJobCalls = au32JobCalls[u8EEPIndex];
+			}
+			au32JobCalls[u8EEPIndex] = 0U;
+		}
+	}
+	else if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState == BUSY_INTERNAL)
+	{
+		au32InternalCalls[u8EEPIndex]++;
+		if(au32InternalCalls[u8EEPIndex] > TI_Fee_oLatencyStats[u8EEPIndex].u32MaxInternalCalls)
+		{
+			TI_Fee_oLatencyStats[u8EEPIndex].u32MaxInternalCalls = au32InternalCalls[u8EEPIndex];
+		}
+	}
+	else
+	{
+		au32InternalCalls[u8EEPIndex] = 0U;
+	}
+}
+
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+/***********************************************************************************************************************
+ *  TI_FeeInternal_GetStepType
+ **********************************************************************************************************************/
+/*! \brief      This function returns the type of the step the state machine of the EEP takes next.
+ *  \param[in]  u8EEPIndex
+ *  \param[out] none
+ *  \return     Step type
+ *  \context    Internal Function, called by TI_FeeInternal_MainFunctionStep.
+ *  \note       TI FEE Internal API.
+ **********************************************************************************************************************/
+static TI_Fee_StepType TI_FeeInternal_GetStepType(uint8 u8EEPIndex)
+{
+	TI_Fee_StepType oStepType = TI_FEE_STEP_IDLE;
+
+	if(TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.WriteAsync==1U)
+	{
+		oStepType = TI_FEE_STEP_WRITE;
+	}
+	else if((TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.InvalidateBlock==1U) ||
+	        (TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.EraseImmediate==1U))
+	{
+		oStepType = TI_FEE_STEP_INVALIDATE;
+	}
+	else if(TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.Read==1U)
+	{
+		oStepType = TI_FEE_STEP_READ;
+	}
+	else if((TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.Copy==1U) ||
+	        (TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.SingleBitError==1U))
+	{
+		oStepType = TI_FEE_STEP_COPY;
+	}
+	else if((TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.Erase==1U) ||
+	        (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32InternalEraseQueue != 0U))
+	{
+		oStepType = TI_FEE_STEP_ERASE;
+	}
+	else
+	{
+		/* MISRA C Compliance */
+	}
+	return(oStepType);
+}
+
+/***********************************************************************************************************************
+ *  TI_FeeInternal_RecordStep
+ **********************************************************************************************************************/
+/*! \brief      This function adds the duration of a step to the cycle statistics of its type.
+ *  \param[in]  StepType
+ *  \param[in]  u32Ticks : Duration in TI_FEE_GET_TIMESTAMP ticks
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_MainFunction and TI_FeeInternal_MainFunctionStep.
+ *  \note       TI FEE Internal API.
+ **********************************************************************************************************************/
+static void TI_FeeInternal_RecordStep(TI_Fee_StepType StepType, uint32 u32Ticks)
+{
+	uint32 u32Bin = 0U;
+	uint32 u32Remaining = u32Ticks;
+
+	/* Number of significant bits, limited to the last bin */
+	while((u32Remaining != 0U) && (u32Bin < (TI_FEE_STEP_HISTOGRAM_BINS - 1U)))
+	{
+		u32Remaining >>= 1U;
+		u32Bin++;
+	}
+	TI_Fee_oStepStats[StepType].u32Steps++;
+	TI_Fee_oStepStats[StepType].u64TotalTicks += u32Ticks;
+	TI_Fee_oStepStats[StepType].au32Histogram[u32Bin]++;
+	if(u32Ticks > TI_Fee_oStepStats[StepType].u32MaxTicks)
+	{
+		TI_Fee_oStepStats[StepType].u32MaxTicks = u32Ticks;
+	}
+}
+
+/***********************************************************************************************************************
+ *  TI_FeeInternal_NextStepFits
+ **********************************************************************************************************************/
+/*! \brief      This function decides if TI_Fee_MainFunction takes another step. It does, if a budget is set, an EEP 
+ *				is busy without erasing a virtual sector, and the longest step measured so far fits into the rest 
+ *				of the budget. Erasing is left to later calls, since its steps only poll the Flash State Machine.
+ *				A step always takes time on the device, so a timestamp which did not advance across the last step
+ *				comes from a counter which does not run, e.g. RTI counter 0 not started: the budget cannot be 
+ *				kept and the call ends after one step.
+ *  \param[in]  u32CallStart : TI_FEE_GET_TIMESTAMP at the start of the call
+ *  \param[in]  u32StepStart : TI_FEE_GET_TIMESTAMP at the start of the last step
+ *  \param[in]  u32Steps : Steps taken in this call
+ *  \param[out] none
+ *  \return     TRUE if another step is to be taken
+ *  \context    Internal Function, called by TI_Fee_MainFunction.
+ *  \note       TI FEE Internal API.
+ **********************************************************************************************************************/
+static boolean TI_FeeInternal_NextStepFits(uint32 u32CallStart, uint32 u32StepStart, uint32 u32Steps)
+{
+	boolean bBusy = FALSE;
+	boolean bErasing = FALSE;
+	uint32 u32MaxStepTicks = 0U;
+	uint32 u32Now;
+	uint32 u32Elapsed;
+	uint8 u8EEPIndex;
+	uint8 u8StepType;
+
+	if((TI_Fee_u32MainFunctionBudget == 0U) || (u32Steps >= TI_FEE_MAIN_FUNCTION_MAX_STEPS))
+	{
+		return(FALSE);
+	}
+	for(u8EEPIndex = 0U; u8EEPIndex < TI_FEE_NUMBER_OF_EEPS; u8EEPIndex++)
+	{
+		if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState != IDLE)
+		{
+			bBusy = TRUE;
+		}
+		if(TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.Erase==1U)
+		{
+			bErasing = TRUE;
+		}
+	}
+	if((bBusy == FALSE) || (bErasing == TRUE))
+	{
+		return(FALSE);
+	}
+	for(u8StepType = (uint8)TI_FEE_STEP_WRITE; u8StepType < (uint8)TI_FEE_NUMBER_OF_STEP_TYPES; u8StepType++)
+	{
+		if(TI_Fee_oStepStats[u8StepType].u32MaxTicks > u32MaxStepTicks)
+		{
+			u32MaxStepTicks = TI_Fee_oStepStats[u8StepType].u32MaxTicks;
+		}
+	}
+	/* Steps of both EEPs are taken together */
+	u32MaxStepTicks *= TI_FEE_NUMBER_OF_EEPS;
+	u32Now = TI_FEE_GET_TIMESTAMP();
+	if(u32Now == u32StepStart)
+	{
+		return(FALSE);
+	}
+	u32Elapsed = u32Now - u32CallStart;
+	return(((u32Elapsed < TI_Fee_u32MainFunctionBudget) && 
+	        (u32MaxStepTicks <= (TI_Fee_u32MainFunctionBudget - u32Elapsed))) ? TRUE : FALSE);
+}
+#endif
+
+/***********************************************************************************************************************
+ *  TI_FeeInternal_MainFunctionStep
+ **********************************************************************************************************************/
+/*! \brief      This function runs one step of the state machine of each EEP: it writes data, reads data, 
+ *				invalidates blocks, erases blocks, copies blocks or erases sectors.
  *  \param[in]  none
  *  \param[out] none
- *  \return     None 
- *  \context    Function could be called from task level
- *  \note       TI FEE API.
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_MainFunction.
+ *  \note       TI FEE Internal API.
  **********************************************************************************************************************/
-/* SourceId : HL_Fee_SourceId_4 */
-/* DesignId : HL_FEE_DesignId_28 */
-/* Requirements : HL_FEE_SR9, HL_FEE_SR10, HL_FEE_SR23, HL_FEE_SR68, HL_FEE_SR69, HL_FEE_SR70 */
-/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
- void TI_Fee_MainFunction(void)
+static void TI_FeeInternal_MainFunctionStep(void)
 {
 	uint8 u8EEPIndex = 0U;
 	uint8 u8WriteCount=0U;	
@@ -143,9 +325,17 @@ boolean Fee_bSingleBitError;
 	uint32 u32WriteAddressTemp=0U;
 	uint8 * u8WriteDataptrTemp=0U;
 	uint8 u8loopindex = 0U;
+	#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+	TI_Fee_StepType oStepType;
+	uint32 u32StepStart;
+	#endif
 
 	while(u8EEPIndex<TI_FEE_NUMBER_OF_EEPS)
 	{
+		#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+		oStepType = TI_FeeInternal_GetStepType(u8EEPIndex);
+		u32StepStart = TI_FEE_GET_TIMESTAMP();
+		#endif
 		/* Write the remaining of the VS header */
 		/*SAFETYMCUSW 114 S MR:21.1 <APPROVED> "Reason -  Eventhough expression is not boolean, we check for the 
 		  function return value."*/
@@ -340,7 +530,7 @@ boolean Fee_bSingleBitError;
 							             (uint16)TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize, u8EEPIndex);
 							/* To avoid MISRA warning */
 							u8WriteCount=u8WriteCount;				
-							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= 0x08U)
+							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= u8WriteCount)
 							{
 								TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize = 0x0U;
 								TI_Fee_GlobalVariables[u8EEPIndex].Fee_bWriteData=FALSE;
@@ -599,6 +789,9 @@ boolean Fee_bSingleBitError;
 		{
 			/* MISRA C Compliance */
 		}	
+		#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+		TI_FeeInternal_RecordStep(oStepType, TI_FEE_GET_TIMESTAMP() - u32StepStart);
+		#endif
 		u8EEPIndex++;
 	}	
 	#if(TI_FEE_NUMBER_OF_EEPS==2U)
@@ -606,6 +799,77 @@ boolean Fee_bSingleBitError;
 			 									   (TI_Fee_oStatusWord[1].Fee_u16StatusWord));
 	#endif	
 }
+/***********************************************************************************************************************
+ *  TI_Fee_MainFunction
+ **********************************************************************************************************************/
+/*! \brief      This function is a cyclic function. It will Write data, Read Data, Invalidate Block, Erase Block,
+ *				Copy blocks, Erase Sectors. With a budget set by TI_Fee_SetMainFunctionBudget it takes steps 
+ *				until the budget is used up, else one step per call.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     None 
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ **********************************************************************************************************************/
+/* SourceId : HL_Fee_SourceId_4 */
+/* DesignId : HL_FEE_DesignId_28 */
+/* Requirements : HL_FEE_SR9, HL_FEE_SR10, HL_FEE_SR23, HL_FEE_SR68, HL_FEE_SR69, HL_FEE_SR70 */
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+ void TI_Fee_MainFunction(void)
+{
+	uint8 u8EEPIndex = 0U;
+	boolean abJobPending[TI_FEE_NUMBER_OF_EEPS];
+	#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+	uint32 u32CallStart = TI_FEE_GET_TIMESTAMP();
+	uint32 u32StepStart;
+	uint32 u32Steps = 0U;
+	#endif
+
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/* Start the flush of a cached block which is due, it is processed like any other write job */
+	TI_FeeInternal_WriteCacheFlush();
+	#endif
+	for(u8EEPIndex = 0U; u8EEPIndex < TI_FEE_NUMBER_OF_EEPS; u8EEPIndex++)
+	{
+		abJobPending[u8EEPIndex] = (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult == JOB_PENDING) ? TRUE : FALSE;
+	}
+	#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+	do
+	{
+		u32StepStart = TI_FEE_GET_TIMESTAMP();
+		TI_FeeInternal_MainFunctionStep();
+		u32Steps++;
+	}
+	while(TRUE == TI_FeeInternal_NextStepFits(u32CallStart, u32StepStart, u32Steps));
+	TI_FeeInternal_RecordStep(TI_FEE_STEP_MAIN_FUNCTION, TI_FEE_GET_TIMESTAMP() - u32CallStart);
+	#else
+	TI_FeeInternal_MainFunctionStep();
+	#endif
+	for(u8EEPIndex = 0U; u8EEPIndex < TI_FEE_NUMBER_OF_EEPS; u8EEPIndex++)
+	{
+		TI_FeeInternal_UpdateLatencyStats(u8EEPIndex, abJobPending[u8EEPIndex]);
+	}
+}
+
+#if (TI_FEE_CYCLE_ACCOUNTING == STD_ON)
+/***********************************************************************************************************************
+ *  TI_Fee_SetMainFunctionBudget
+ **********************************************************************************************************************/
+/*! \brief      This function sets the time TI_Fee_MainFunction may run per call, in TI_FEE_GET_TIMESTAMP ticks. 
+ *				A call takes another step only if the longest step measured so far still fits. 0 runs one step 
+ *				per call.
+ *  \param[in]  u32Ticks
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ **********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_SetMainFunctionBudget(uint32 u32Ticks)
+{
+	TI_Fee_u32MainFunctionBudget = u32Ticks;
+}
+#endif
 /*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
 #define FEE_STOP_SEC_CODE
 /*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
@@ -120,6 +120,7 @@ Std_ReturnType TI_Fee_Read(uint16 BlockNumber,uint16 BlockOffset,uint8* DataBuff
 	uint8 u8EEPIndex=0U;
 	uint16 u16BlockNumber=0U;		
 	TI_FeeModuleStatusType ModuleState=IDLE;		
+	boolean bCached=FALSE;
 	
 	TI_Fee_u8DeviceIndex = 0U;		
 
@@ -167,7 +168,11 @@ Std_ReturnType TI_Fee_Read(uint16 BlockNumber,uint16 BlockOffset,uint8* DataBuff
 		}
 	}
 	
-	if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil)
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/* The latest data of a block which is not flushed yet is in the write cache */
+	bCached = TI_FeeInternal_WriteCacheLoad(BlockNumber, BlockOffset, DataBufferPtr, Length);
+	#endif
+	if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil) && (FALSE == bCached))
 	{
 		/* Store the module state */
 		ModuleState = TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState;
@@ -109,6 +109,7 @@ Std_ReturnType TI_Fee_ReadSync(uint16 BlockNumber,uint16 BlockOffset,uint8* Data
 	uint16 u16BlockNumber=0U;	
 	uint16 u16ArrayIndex = 0U;	
 	TI_FeeModuleStatusType ModuleState=IDLE;		
+	boolean bCached=FALSE;
 	
 	TI_Fee_u8DeviceIndex = 0U;		
 
@@ -156,7 +157,11 @@ Std_ReturnType TI_Fee_ReadSync(uint16 BlockNumber,uint16 BlockOffset,uint8* Data
 		}
 	}
 	
-	if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil)
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/* The latest data of a block which is not flushed yet is in the write cache */
+	bCached = TI_FeeInternal_WriteCacheLoad(BlockNumber, BlockOffset, DataBufferPtr, Length);
+	#endif
+	if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil) && (FALSE == bCached))
 	{
 		/* Store the module state */
 		ModuleState = TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState;
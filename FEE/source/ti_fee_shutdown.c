@@ -147,7 +147,7 @@ Std_ReturnType TI_Fee_Shutdown(void)
 										   (uint16)TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize,u8EEPIndex);
 				/* To avoid MISRA warning */
 				Fee_WriteCount=Fee_WriteCount;
-				if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= 0x8U)
+				if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= Fee_WriteCount)
 				{
 					TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize = 0x0U;
 				}
@@ -251,6 +251,15 @@ Std_ReturnType TI_Fee_Shutdown(void)
 		}	
 		u8EEPIndex++;	
 	}
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/* Write the blocks which are only in the write cache */
+	/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should
+      be fixed outside of FEE."*/
+	if(TI_FeeInternal_WriteCacheFlushSync() != (uint8)E_OK)
+	{
+		oResult = (uint8)E_NOT_OK;
+	}
+	#endif
 	return(oResult);
 }
 #endif
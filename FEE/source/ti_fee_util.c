@@ -154,8 +154,15 @@ static void TI_FeeInternal_CopyInitialize(boolean bBlockStatus, TI_Fee_AddressTy
                                           uint8 u8SingleBitError);
 static void TI_FeeInternal_ConfigureBlockHeader(uint8 u8EEPIndex, uint8 u8BlockState,uint16 Fee_BlockSize_u16,
                                                 uint16 u16BlockNumber);
+#if(TI_FEE_WIDE_WRITE == STD_ON)
+static uint8 TI_FeeInternal_GetWriteSize(TI_Fee_AddressType oWriteAddress, uint16 u16WriteSize);
+#endif
 static void TI_FeeInternal_ConfigureVirtualSectorHeader(uint8  FeeVirtualSectorNumber,
                                                         VirtualSectorStatesType VsState,  uint8 u8EEPIndex);
+#if (TI_FEE_BACKGROUND_COPY == STD_ON)
+static boolean TI_FeeInternal_BackgroundCopyDue(uint8 u8EEPIndex);
+static void TI_FeeInternal_StartBackgroundCopy(uint8 u8EEPIndex);
+#endif
 														
 /*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
 #define FEE_START_SEC_VAR_INIT_UNSPECIFIED  
@@ -366,6 +373,31 @@ static void TI_FeeInternal_ConfigureVirtualSectorHeader(uint8  FeeVirtualSectorN
 	}
 }
 
+/**********************************************************************************************************************
+ *  TI_FeeInternal_GetWriteSize
+ *********************************************************************************************************************/
+/*! \brief      This function returns the number of bytes one program command writes at an address.
+ *  \param[in]	TI_Fee_AddressType oWriteAddress
+ *  \param[in]	uint16 u16WriteSize
+ *  \param[out] none 
+ *  \return 	16 if the whole FWPWRITE buffer can be used, else 8
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+#if(TI_FEE_WIDE_WRITE == STD_ON)
+static uint8 TI_FeeInternal_GetWriteSize(TI_Fee_AddressType oWriteAddress, uint16 u16WriteSize)
+{
+	uint8 u8WriteSize = 0x8U;
+
+	/* Only full buffers are written wide, a block end always goes through the 8 byte path */
+	if(((uint32)WIDTH_EEPROM_BANK >= 16U) && ((oWriteAddress & 0x0FU) == 0U) && (u16WriteSize >= 16U))
+	{
+		u8WriteSize = 16U;
+	}
+	return(u8WriteSize);
+}
+#endif
+
 /**********************************************************************************************************************
  *  TI_FeeInternal_WriteDataF021
  *********************************************************************************************************************/
@@ -377,6 +409,8 @@ static void TI_FeeInternal_ConfigureVirtualSectorHeader(uint8  FeeVirtualSectorN
  *  \return 	Number of bytes written onto Flash.
  *  \context    Internal Function.
  *  \note       TI FEE Internal API.
+ *				With TI_FEE_WIDE_WRITE, a write of 16 bytes or more to a 16 byte aligned address fills the whole
+ *				FWPWRITE buffer and programs two double words with one command. 16 is returned in that case.
  *********************************************************************************************************************/
 uint8 TI_FeeInternal_WriteDataF021(boolean bCopy,uint16 u16WriteSize, uint8 u8EEPIndex)
 {	
@@ -384,31 +418,27 @@ uint8 TI_FeeInternal_WriteDataF021(boolean bCopy,uint16 u16WriteSize, uint8 u8EE
 	uint8 u8ActualWriteSize = 0x8U;	
 	uint8 u8Offset = 0U;
 	TI_Fee_AddressType Fee_WriteAddress=0U;
-	uint32 u32FwpWriteDwordAccessor_temp = 0U;
+	/* The FWPWRITE buffer has fixed addresses, it is accessed through its base addresses */
 	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
 	/*SAFETYMCUSW 93 S MR:6.1,6.2,10.1,10.2,10.3,10.4 <APPROVED> "Reason -  FWPWRITE_BYTE_ACCESSOR_ADDRESS is macro."*/
-	FwpWriteByteAccessorType * oFwpWriteByteAccessor[16];	
+	FwpWriteByteAccessorType * const oFwpWriteByteAccessor = FWPWRITE_BYTE_ACCESSOR_ADDRESS;	
 	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
 	/*SAFETYMCUSW 93 S MR:6.1,6.2,10.1,10.2,10.3,10.4 <APPROVED> "Reason -  FWPWRITE_ECC_BYTE_ACCESSOR_ADDRESS is macro."*/
 	#ifndef _L2FMC
-	FwpWriteByteAccessorType * oFwpWriteEccByteAccessor = FWPWRITE_ECC_BYTE_ACCESSOR_ADDRESS;
+	FwpWriteByteAccessorType * const oFwpWriteEccByteAccessor = FWPWRITE_ECC_BYTE_ACCESSOR_ADDRESS;
 	#endif	
-	FwpWriteDWordAccessorType * oFwpWriteDwordAccessor[4];	
+	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
+	/*SAFETYMCUSW 93 S MR:6.1,6.2,10.1,10.2,10.3,10.4 <APPROVED> "Reason -  FWPWRITE_DWORD_ACCESSOR_ADDRESS is macro."*/
+	FwpWriteDWordAccessorType * const oFwpWriteDwordAccessor = FWPWRITE_DWORD_ACCESSOR_ADDRESS;	
 	uint32 u32Index=0U;	
-	
-	for(u32Index=0U;u32Index<4U;u32Index++)
-	{
-		oFwpWriteDwordAccessor[u32Index] = FWPWRITE_DWORD_ACCESSOR_ADDRESS+u32Index;
-	}			
-	
-	for(u32Index=0U;u32Index<16U;u32Index++)
-	{
-		oFwpWriteByteAccessor[u32Index] = FWPWRITE_BYTE_ACCESSOR_ADDRESS+u32Index;
-	}
+	uint32 u32DoubleWord=0U;	
 			
 	if((bCopy == TRUE))
 	{
 		Fee_WriteAddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCopyWriteAddress;									
+		#if(TI_FEE_WIDE_WRITE == STD_ON)
+		u8ActualWriteSize = TI_FeeInternal_GetWriteSize(Fee_WriteAddress, u16WriteSize);
+		#endif
 		/*SAFETYMCUSW 45 D MR:21.1 <APPROVED> "Reason -  Fee_pu8CopyData is assigned a value and it can't be NULL."*/
 		/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
 		if(NULL_PTR != TI_Fee_GlobalVariables[u8EEPIndex].Fee_pu8CopyData)
@@ -433,6 +463,9 @@ uint8 TI_FeeInternal_WriteDataF021(boolean bCopy,uint16 u16WriteSize, uint8 u8EE
 	else
 	{
 		Fee_WriteAddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oWriteAddress;						
+		#if(TI_FEE_WIDE_WRITE == STD_ON)
+		u8ActualWriteSize = TI_FeeInternal_GetWriteSize(Fee_WriteAddress, u16WriteSize);
+		#endif
 		/*SAFETYMCUSW 45 D MR:21.1 <APPROVED> "Reason -  Fee_pu8Data is assigned a value and it can't be NULL."*/
 		/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
 		if(NULL_PTR != TI_Fee_GlobalVariables[u8EEPIndex].Fee_pu8Data)
@@ -493,7 +526,7 @@ uint8 TI_FeeInternal_WriteDataF021(boolean bCopy,uint16 u16WriteSize, uint8 u8EE
 			/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
 			u8Offset = (uint8)(Fee_WriteAddress & 0x08U) * (WIDTH_EEPROM_BANK >> 0x04U);
 		
-			/* Check if the number of bytes to write are less than 8. */
+			/* Check if the number of bytes to write are less than the write size. */
 			u16WriteSize = (u16WriteSize < u8ActualWriteSize) ? u16WriteSize : u8ActualWriteSize;
 
 			#ifdef _L2FMC
@@ -507,81 +540,38 @@ uint8 TI_FeeInternal_WriteDataF021(boolean bCopy,uint16 u16WriteSize, uint8 u8EE
 				/*SAFETYMCUSW 45 D MR:21.1 <APPROVED> "Reason -  pu8Data is assigned a value and it can't be NULL."*/
 				/*SAFETYMCUSW 436 S MR:17.1,17.4 <APPROVED> "Reason - Only limited index's at oFwpWriteDwordAccessor
 				  are accessed."*/
-				*oFwpWriteByteAccessor[L2EI8(u32Index+u8Offset)] = pu8Data[u32Index];
+				oFwpWriteByteAccessor[L2EI8(u32Index+u8Offset)] = pu8Data[u32Index];
 				#else
 				/*SAFETYMCUSW 45 D MR:21.1 <APPROVED> "Reason -  pu8Data is assigned a value and it can't be NULL."*/			
 				/*SAFETYMCUSW 436 S MR:17.1,17.4 <APPROVED> "Reason - Only limited index's at oFwpWriteDwordAccessor 
 				  are accessed."*/			  
-				*oFwpWriteByteAccessor[u32Index+u8Offset] = pu8Data[u32Index];
+				oFwpWriteByteAccessor[u32Index+u8Offset] = pu8Data[u32Index];
 				#endif
 			}	
 			
-			/* Supply the address where ECC is being calculated */
-			/*SAFETYMCUSW 184 S LDRA adding spaces causes this rule to fail."*/	
-			/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
-			FLASH_CONTROL_REGISTER->FemuAddr.u32Register = Fee_WriteAddress;
-
-			#ifdef _LITTLE_ENDIAN
-			/* Supply the upper 32bit word */			
-			if(u8Offset != 0U)
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[2];
-			}
-			else
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[0];
-			}
-			FLASH_CONTROL_REGISTER->FemuDlsw.u32Register = u32FwpWriteDwordAccessor_temp;		
-			/* Supply the lower 32bit word */			
-			if(u8Offset != 0U)
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[3];
-			}
-			else
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[1];
-			}
-			FLASH_CONTROL_REGISTER->FemuDmsw.u32Register = u32FwpWriteDwordAccessor_temp;			
-			#else
-			/* Supply the upper 32bit word */					
-			if(u8Offset != 0U)
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[2];
-			}
-			else
-			{
-				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[0];
-			}
-			FLASH_CONTROL_REGISTER->FemuDlsw.u32Register = u32FwpWriteDwordAccessor_temp;
-			/* Supply the lower 32bit word */					
-			if(u8Offset != 0U)
+			/* Let the wrapper calculate the ECC of each double word in the FWPWRITE buffer */
+			for(u32DoubleWord=0U;u32DoubleWord<((uint32)u8ActualWriteSize >> 3U);u32DoubleWord++)
 			{
+				u32Index = ((uint32)u8Offset >> 3U) + u32DoubleWord;
+				/* Supply the address where ECC is being calculated */
+				/*SAFETYMCUSW 184 S LDRA adding spaces causes this rule to fail."*/	
+				/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
+				FLASH_CONTROL_REGISTER->FemuAddr.u32Register = Fee_WriteAddress + (u32DoubleWord << 3U);
+				/* Supply the upper 32bit word */			
 				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[3];
-			}
-			else
-			{
+				FLASH_CONTROL_REGISTER->FemuDlsw.u32Register = oFwpWriteDwordAccessor[u32Index << 1U];
+				/* Supply the lower 32bit word */			
 				/*SAFETYMCUSW 134 S MR:11.3 <APPROVED> "Reason -  Volatile variable usage is required here  */	
-				u32FwpWriteDwordAccessor_temp = *oFwpWriteDwordAccessor[1];
+				FLASH_CONTROL_REGISTER->FemuDmsw.u32Register = oFwpWriteDwordAccessor[(u32Index << 1U) + 1U];
+				#ifndef _L2FMC
+				/* Place the Wrapper calculated ECC into FWPWRITE_ECC */
+				/*SAFETYMCUSW 184 S LDRA adding spaces causes this rule to fail."*/	
+				/*SAFETYMCUSW 436 S MR:17.1,17.4 <APPROVED> "Reason - Only limited index's at oFwpWriteEccByteAccessor 
+				  are accessed."*/			  
+				/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
+				oFwpWriteEccByteAccessor[EI8(u32Index)] = FLASH_CONTROL_REGISTER->FemuEcc.FEMU_ECC_BITS.EMU_ECC;
+				#endif
 			}
-			FLASH_CONTROL_REGISTER->FemuDmsw.u32Register = u32FwpWriteDwordAccessor_temp;
-			#endif			
-			#ifndef _L2FMC
-			/* Place the Wrapper calculated ECC into FWPWRITE_ECC */
-			/*SAFETYMCUSW 184 S LDRA adding spaces causes this rule to fail."*/	
-			/*SAFETYMCUSW 114 S MR:12.6,13.2 <APPROVED> "Reason -  Eventhough expression is not boolean, 
-			  we check for the function return value."*/
-			/*SAFETYMCUSW 436 S MR:17.1,17.4 <APPROVED> "Reason - Only limited index's at oFwpWriteEccByteAccessor 
-			  are accessed."*/			  
-			/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
-			oFwpWriteEccByteAccessor[EI8(u8Offset?1:0)] = FLASH_CONTROL_REGISTER->FemuEcc.FEMU_ECC_BITS.EMU_ECC;
-			#endif
 			/* Set command to "Program" */
 			/*SAFETYMCUSW 184 S LDRA adding spaces causes this rule to fail."*/	
 			/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
@@ -1345,17 +1335,24 @@ void TI_FeeInternal_GetVirtualSectorIndex(Fapi_FlashSectorType oSectorStart, Fap
 uint16 TI_FeeInternal_GetBlockIndex(uint16 BlockNumber)
 {
 	uint16 u16BlockIndex = 0xFFFFU;
-	uint16 u16LoopIndex =0U;
+	uint16 u16Slot = 0U;
+	uint16 u16Probe = 0U;
 
-	/* find out the index of Block Number in the Block Configuration */
-	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_NUMBER_OF_BLOCKS ; u16LoopIndex++)	
+	/* find out the index of Block Number in the hash built by TI_FeeInternal_BuildBlockIndex */
+	u16Slot = BlockNumber & (uint16)(TI_FEE_BLOCK_HASH_SIZE - 1U);
+	for(u16Probe=0U ; u16Probe<TI_FEE_BLOCK_HASH_SIZE ; u16Probe++)
 	{
-		if(BlockNumber == Fee_BlockConfiguration[u16LoopIndex].FeeBlockNumber)
+		if(TI_FEE_BLOCK_HASH_EMPTY == TI_Fee_au16BlockHash[u16Slot])
 		{
-			u16BlockIndex = u16LoopIndex;
 			break;
-		}		
-	}	
+		}
+		if(BlockNumber == Fee_BlockConfiguration[TI_Fee_au16BlockHash[u16Slot]].FeeBlockNumber)
+		{
+			u16BlockIndex = TI_Fee_au16BlockHash[u16Slot];
+			break;
+		}
+		u16Slot = (u16Slot + 1U) & (uint16)(TI_FEE_BLOCK_HASH_SIZE - 1U);
+	}
 	return(u16BlockIndex);
 }
 
@@ -1390,40 +1387,426 @@ uint16 TI_FeeInternal_GetBlockIndex(uint16 BlockNumber)
 uint16 TI_FeeInternal_GetArrayIndex(uint16 BlockNumber, uint16 DataSetNumber, uint8 u8EEPIndex, boolean bCallContext)
 {
 	uint16 u16ArrayIndex = 0U;
-	uint16 u16LoopIndex = 0U;
+	uint16 u16BlockIndex = 0U;
 	uint16 u16RetValue = 0U;
 
 	if(TRUE == bCallContext)
 	{
-		/* find out the index of Block Number in the Block Configuration */
-		for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_NUMBER_OF_BLOCKS ; u16LoopIndex++)	
-		{			
-			if(BlockNumber == Fee_BlockConfiguration[u16LoopIndex].FeeBlockNumber)
+		/* first data set of the block, from the prefix sums of FeeNumberOfDataSets */
+		u16BlockIndex = TI_FeeInternal_GetBlockIndex(BlockNumber);
+		if(0xFFFFU == u16BlockIndex)
+		{
+			u16ArrayIndex = TI_Fee_au16DataSetStart[TI_FEE_NUMBER_OF_BLOCKS];
+		}
+		else
+		{
+			u16ArrayIndex = TI_Fee_au16DataSetStart[u16BlockIndex];
+			#if (TI_FEE_VARIABLE_DATASETS == STD_ON)
+			u16ArrayIndex += DataSetNumber;
+			#endif
+		}
+		u16RetValue=u16ArrayIndex;	
+	}
+	else
+	{
+		/* block owning the data set being copied */
+		u16ArrayIndex = TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockCopyIndex;
+		if(u16ArrayIndex < TI_Fee_au16DataSetStart[TI_FEE_NUMBER_OF_BLOCKS])
+		{
+			u16RetValue = TI_Fee_au16ArrayToBlockIndex[u16ArrayIndex];
+		}
+		else
+		{
+			u16RetValue = TI_FEE_NUMBER_OF_BLOCKS;
+		}
+	}
+	return(u16RetValue);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_BuildBlockIndex
+ *********************************************************************************************************************/
+/*! \brief      This function builds the lookup tables used by TI_FeeInternal_GetBlockIndex and 
+ *				TI_FeeInternal_GetArrayIndex: an open addressing hash of the configured block numbers, the index of
+ *				the first data set of each block and the block owning each data set.
+ *  \param[in]	none
+ *  \param[out] none 
+ *  \return 	none
+ *  \context    Internal Function, called by TI_Fee_Init.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+void TI_FeeInternal_BuildBlockIndex(void)
+{
+	uint16 u16LoopIndex = 0U;
+	uint16 u16DataSet = 0U;
+	uint16 u16ArrayIndex = 0U;
+	uint16 u16Slot = 0U;
+	uint16 u16BlockNumber = 0U;
+
+	for(u16Slot=0U ; u16Slot<TI_FEE_BLOCK_HASH_SIZE ; u16Slot++)
+	{
+		TI_Fee_au16BlockHash[u16Slot] = TI_FEE_BLOCK_HASH_EMPTY;
+	}
+
+	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_NUMBER_OF_BLOCKS ; u16LoopIndex++)
+	{
+		/* a block number configured twice keeps its first index, as the linear search did */
+		u16BlockNumber = Fee_BlockConfiguration[u16LoopIndex].FeeBlockNumber;
+		u16Slot = u16BlockNumber & (uint16)(TI_FEE_BLOCK_HASH_SIZE - 1U);
+		while((TI_FEE_BLOCK_HASH_EMPTY != TI_Fee_au16BlockHash[u16Slot]) && 
+		      (u16BlockNumber != Fee_BlockConfiguration[TI_Fee_au16BlockHash[u16Slot]].FeeBlockNumber))
+		{
+			u16Slot = (u16Slot + 1U) & (uint16)(TI_FEE_BLOCK_HASH_SIZE - 1U);
+		}
+		if(TI_FEE_BLOCK_HASH_EMPTY == TI_Fee_au16BlockHash[u16Slot])
+		{
+			TI_Fee_au16BlockHash[u16Slot] = u16LoopIndex;
+		}
+
+		TI_Fee_au16DataSetStart[u16LoopIndex] = u16ArrayIndex;
+		for(u16DataSet=0U ; u16DataSet<Fee_BlockConfiguration[u16LoopIndex].FeeNumberOfDataSets ; u16DataSet++)
+		{
+			if(u16ArrayIndex < TI_FEE_TOTAL_BLOCKS_DATASETS)
 			{
-				#if (TI_FEE_VARIABLE_DATASETS == STD_ON)
-				u16ArrayIndex += DataSetNumber;
-				#endif
+				TI_Fee_au16ArrayToBlockIndex[u16ArrayIndex] = u16LoopIndex;
+			}
+			u16ArrayIndex++;
+		}
+	}
+	TI_Fee_au16DataSetStart[TI_FEE_NUMBER_OF_BLOCKS] = u16ArrayIndex;
+}
+
+#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+/**********************************************************************************************************************
+ *  TI_FeeInternal_SnapshotSignature
+ *********************************************************************************************************************/
+/*! \brief      This function returns a signature of the block configuration, so that a snapshot written with another
+ *				configuration is not loaded.
+ *  \param[in]	none
+ *  \param[out] none 
+ *  \return 	uint32 signature
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static uint32 TI_FeeInternal_SnapshotSignature(void)
+{
+	uint32 u32Signature = TI_FEE_TOTAL_BLOCKS_DATASETS;
+	uint16 u16LoopIndex = 0U;
+
+	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_NUMBER_OF_BLOCKS ; u16LoopIndex++)
+	{
+		u32Signature = (u32Signature << 5U) | (u32Signature >> 27U);
+		u32Signature ^= (uint32)Fee_BlockConfiguration[u16LoopIndex].FeeBlockNumber;
+		u32Signature ^= (uint32)Fee_BlockConfiguration[u16LoopIndex].FeeBlockSize << 16U;
+		u32Signature += (uint32)Fee_BlockConfiguration[u16LoopIndex].FeeNumberOfDataSets;
+	}
+	return(u32Signature);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_SnapshotOffset
+ *********************************************************************************************************************/
+/*! \brief      This function returns the offset stored in the snapshot for a data set. Only the offsets of valid
+ *				blocks are stored, other states are stored as 0x0BAD.
+ *  \param[in]	uint8 u8EEPIndex
+ *  \param[in]	uint16 u16ArrayIndex
+ *  \param[out] none 
+ *  \return 	uint16 offset
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static uint16 TI_FeeInternal_SnapshotOffset(uint8 u8EEPIndex, uint16 u16ArrayIndex)
+{
+	uint16 u16Offset = 0x0BADU;
+
+	if(u16ArrayIndex < TI_FEE_TOTAL_BLOCKS_DATASETS)
+	{
+		u16Offset = TI_Fee_GlobalVariables[u8EEPIndex].Fee_au16BlockOffset[u16ArrayIndex];
+		if(0xABCDU == u16Offset)
+		{
+			u16Offset = 0x0BADU;
+		}
+	}
+	return(u16Offset);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_SnapshotChecksum
+ *********************************************************************************************************************/
+/*! \brief      This function returns a Fletcher checksum of the offsets stored in the snapshot.
+ *  \param[in]	uint8 u8EEPIndex
+ *  \param[out] none 
+ *  \return 	uint32 checksum
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static uint32 TI_FeeInternal_SnapshotChecksum(uint8 u8EEPIndex)
+{
+	uint32 u32Sum1 = 0xFFFFU;
+	uint32 u32Sum2 = 0xFFFFU;
+	uint16 u16LoopIndex = 0U;
+
+	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_TOTAL_BLOCKS_DATASETS ; u16LoopIndex++)
+	{
+		u32Sum1 = (u32Sum1 + TI_FeeInternal_SnapshotOffset(u8EEPIndex, u16LoopIndex)) % 0xFFFFU;
+		u32Sum2 = (u32Sum2 + u32Sum1) % 0xFFFFU;
+	}
+	return((u32Sum2 << 16U) | u32Sum1);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_ProgramSnapshotData
+ *********************************************************************************************************************/
+/*! \brief      This function issues the program command for 8 bytes at an address, if the FSM is ready. It does not
+ *				wait for the command to complete. The current write address and data pointer are restored afterwards.
+ *  \param[in]	uint8 u8EEPIndex
+ *  \param[in]	uint32 u32Address
+ *  \param[in]	uint32 *pu32Data
+ *  \param[out] none 
+ *  \return 	TRUE if the command was issued
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static boolean TI_FeeInternal_ProgramSnapshotData(uint8 u8EEPIndex, uint32 u32Address, uint32 *pu32Data)
+{
+	uint32 u32WriteAddressTemp = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oWriteAddress;
+	uint8 *pu8WriteDataTemp = TI_Fee_GlobalVariables[u8EEPIndex].Fee_pu8Data;
+
+	/*SAFETYMCUSW 114 S MR:12.6,13.2 <APPROVED> "Reason -  LDRA does not understand macro 
+	  FAPI_CHECK_FSM_READY_BUSY."*/
+	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  ( pFapi_FmcRegistersType ) ( 0xFFF87000U ) ) casting 
+	  is done in F021 library.*/
+	if(FAPI_CHECK_FSM_READY_BUSY != Fapi_Status_FsmReady)
+	{
+		return(FALSE);
+	}
+	TI_Fee_GlobalVariables[u8EEPIndex].Fee_oWriteAddress = u32Address;
+	/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+	/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+	TI_Fee_GlobalVariables[u8EEPIndex].Fee_pu8Data = (uint8 *)pu32Data;
+	(void)TI_FeeInternal_WriteDataF021(FALSE,(uint16)8U,u8EEPIndex);
+	TI_Fee_GlobalVariables[u8EEPIndex].Fee_oWriteAddress = u32WriteAddressTemp;
+	TI_Fee_GlobalVariables[u8EEPIndex].Fee_pu8Data = pu8WriteDataTemp;
+	return(TRUE);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteBlockOffsetSnapshot
+ *********************************************************************************************************************/
+/*! \brief      This function writes the block offset array of the active virtual sector as a snapshot block at the
+ *				next write address, and records its address in the virtual sector header. It is called once the
+ *				valid blocks have been copied, while the block offsets describe the whole virtual sector. Nothing is
+ *				written if the snapshot does not fit or the virtual sector already records one.
+ *				Like the copy of a block, the snapshot is written one program command per call:
+ *				TI_Fee_au16SnapshotStep counts the commands issued, the caller calls again on the next main function
+ *				cycle until the function returns TRUE.
+ *  \param[in]	uint8 u8EEPIndex
+ *  \param[out] none 
+ *  \return 	TRUE when the snapshot is complete or not written
+ *  \context    Internal Function, called by TI_FeeInternal_FeeManager.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+boolean TI_FeeInternal_WriteBlockOffsetSnapshot(uint8 u8EEPIndex)
+{
+	uint32 au32Data[2];
+	uint32 u32VirtualSectorStartAddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oActiveVirtualSectorAddress;
+	uint32 u32VirtualSectorEndAddress = 0U;
+	uint32 u32SnapshotAddress = TI_Fee_au32SnapshotAddress[u8EEPIndex];
+	uint32 u32Address = 0U;
+	uint16 u16Step = TI_Fee_au16SnapshotStep[u8EEPIndex];
+	uint16 u16Index = 0U;
+	uint16 u16Index1 = 0U;
+	uint16 u16LoopIndex = 0U;
+	uint16 u16OffsetSteps = (uint16)((TI_FEE_TOTAL_BLOCKS_DATASETS + 3U) >> 2U);
+	boolean bDone = FALSE;
+	Fapi_FlashSectorType oSectorEnd = Fapi_FlashSector63;
+
+	if(0U == u16Step)
+	{
+		if(0U==u8EEPIndex)
+		{
+			u16Index = 0U;
+			u16Index1 = (uint16)(TI_FEE_NUMBER_OF_VIRTUAL_SECTORS - TI_FEE_NUMBER_OF_VIRTUAL_SECTORS_EEP1);
+		}
+		else
+		{
+			u16Index = TI_FEE_NUMBER_OF_VIRTUAL_SECTORS_EEP1;
+			u16Index1 = TI_FEE_NUMBER_OF_VIRTUAL_SECTORS;
+		}
+		for(; u16Index < u16Index1 ; u16Index++)	
+		{
+			if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector == Fee_VirtualSectorConfiguration[u16Index].FeeVirtualSectorNumber)
+			{
+				oSectorEnd = Fee_VirtualSectorConfiguration[u16Index].FeeEndSector;
 				break;
 			}
-			u16ArrayIndex += Fee_BlockConfiguration[u16LoopIndex].FeeNumberOfDataSets;
 		}
-		u16RetValue=u16ArrayIndex;	
+		u32VirtualSectorEndAddress = TI_FeeInternal_GetVirtualSectorParameter(oSectorEnd,(uint16)FEE_BANK,(boolean)TRUE, u8EEPIndex);
+		u32VirtualSectorEndAddress += TI_FeeInternal_GetVirtualSectorParameter(oSectorEnd,(uint16)FEE_BANK,(boolean)FALSE, u8EEPIndex);
+
+		u32SnapshotAddress = TI_FeeInternal_AlignAddressForECC(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress);
+
+		/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Casting is required here."*/
+		if(((u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD + TI_FEE_SNAPSHOT_SIZE) >= u32VirtualSectorEndAddress) ||
+		   (0xFFFFFFFFU != *(volatile uint32 *)(u32VirtualSectorStartAddress + TI_FEE_SNAPSHOT_POINTER_OFFSET)))
+		{
+			return(TRUE);
+		}
+		TI_Fee_au32SnapshotAddress[u8EEPIndex] = u32SnapshotAddress;
+
+		/* Start program status */
+		au32Data[0] = StartProgramBlockLo;
+		au32Data[1] = StartProgramBlockHi;
+		u32Address = u32SnapshotAddress;
+	}
+	else if(1U == u16Step)
+	{
+		/* Block number and size */
+		au32Data[0] = 0xFFFFFFFFU;
+		au32Data[1] = ((uint32)TI_FEE_SNAPSHOT_SIZE << 16U) | (uint32)TI_FEE_SNAPSHOT_BLOCK_NUMBER;
+		u32Address = u32SnapshotAddress + 16U;
+	}
+	else if(2U == u16Step)
+	{
+		/* Snapshot data */
+		au32Data[0] = TI_FEE_SNAPSHOT_MAGIC;
+		au32Data[1] = TI_FeeInternal_SnapshotSignature();
+		u32Address = u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD;
+	}
+	else if(3U == u16Step)
+	{
+		au32Data[0] = TI_FeeInternal_SnapshotChecksum(u8EEPIndex);
+		au32Data[1] = 0xFFFFFFFFU;
+		u32Address = u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD + 8U;
+	}
+	else if(u16Step < (4U + u16OffsetSteps))
+	{
+		/* Four offsets per command */
+		u16LoopIndex = (uint16)((u16Step - 4U) << 2U);
+		/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		((uint16 *)au32Data)[0] = TI_FeeInternal_SnapshotOffset(u8EEPIndex, u16LoopIndex);
+		((uint16 *)au32Data)[1] = TI_FeeInternal_SnapshotOffset(u8EEPIndex, u16LoopIndex + 1U);
+		((uint16 *)au32Data)[2] = TI_FeeInternal_SnapshotOffset(u8EEPIndex, u16LoopIndex + 2U);
+		((uint16 *)au32Data)[3] = TI_FeeInternal_SnapshotOffset(u8EEPIndex, u16LoopIndex + 3U);
+		u32Address = u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD + 16U + ((uint32)u16LoopIndex << 1U);
+	}
+	else if(u16Step == (4U + u16OffsetSteps))
+	{
+		/* Mark the block as valid */
+		au32Data[0] = ValidBlockLo;
+		au32Data[1] = ValidBlockHi;
+		u32Address = u32SnapshotAddress;
 	}
 	else
 	{
-		for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_NUMBER_OF_BLOCKS ; u16LoopIndex++)	
-		{					
-			u16ArrayIndex += Fee_BlockConfiguration[u16LoopIndex].FeeNumberOfDataSets;	
-			
-			if(u16ArrayIndex > TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockCopyIndex)
+		/* Record it in the virtual sector header */
+		au32Data[0] = u32SnapshotAddress;
+		au32Data[1] = ~u32SnapshotAddress;
+		u32Address = u32VirtualSectorStartAddress + TI_FEE_SNAPSHOT_POINTER_OFFSET;
+		bDone = TRUE;
+	}
+
+	if(FALSE == TI_FeeInternal_ProgramSnapshotData(u8EEPIndex, u32Address, au32Data))
+	{
+		/* FSM busy, the same command is issued on the next call */
+		return(FALSE);
+	}
+
+	if(TRUE == bDone)
+	{
+		/* Next block is written after the snapshot */
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress = u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD + TI_FEE_SNAPSHOT_SIZE;
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextwriteaddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress;
+		TI_Fee_au16SnapshotStep[u8EEPIndex] = 0U;
+	}
+	else
+	{
+		TI_Fee_au16SnapshotStep[u8EEPIndex] = u16Step + 1U;
+	}
+	return(bDone);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_LoadBlockOffsetSnapshot
+ *********************************************************************************************************************/
+/*! \brief      This function loads the block offset snapshot recorded in the header of a virtual sector. Only the 
+ *				offsets whose block header is still valid are taken, blocks invalidated after the snapshot are left
+ *				to the scan.
+ *  \param[in]	uint8 u8EEPIndex
+ *  \param[in]	uint32 u32VirtualSectorStartAddress
+ *  \param[in]	uint32 u32VirtualSectorEndAddress
+ *  \param[out] none 
+ *  \return 	Address of the snapshot block, where the scan resumes, or 0 if no valid snapshot was found.
+ *  \context    Internal Function, called by TI_FeeInternal_UpdateBlockOffsetArray.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+uint32 TI_FeeInternal_LoadBlockOffsetSnapshot(uint8 u8EEPIndex, uint32 u32VirtualSectorStartAddress, 
+                                              uint32 u32VirtualSectorEndAddress)
+{
+	/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Casting is required here."*/
+	volatile uint32 *pu32Pointer = (volatile uint32 *)(u32VirtualSectorStartAddress + TI_FEE_SNAPSHOT_POINTER_OFFSET);
+	volatile uint32 *pu32Snapshot;
+	volatile uint16 *pu16Offsets;
+	volatile uint32 *pu32Header;
+	uint32 u32SnapshotAddress = pu32Pointer[0];
+	uint32 u32Sum1 = 0xFFFFU;
+	uint32 u32Sum2 = 0xFFFFU;
+	uint16 u16LoopIndex = 0U;
+	uint16 u16Offset = 0U;
+	uint16 u16BlockNumber = 0U;
+
+	/* Pointer is written once per erase of the virtual sector */
+	if((u32SnapshotAddress != ~pu32Pointer[1]) || ((u32SnapshotAddress & 0x7U) != 0U) ||
+	   (u32SnapshotAddress < (u32VirtualSectorStartAddress + TI_FEE_VIRTUAL_SECTOR_OVERHEAD + 16U)) ||
+	   ((u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD + TI_FEE_SNAPSHOT_SIZE) >= u32VirtualSectorEndAddress))
+	{
+		return(0U);
+	}
+
+	/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Casting is required here."*/
+	pu32Header = (volatile uint32 *)u32SnapshotAddress;
+	pu32Snapshot = (volatile uint32 *)(u32SnapshotAddress + TI_FEE_BLOCK_OVERHEAD);
+	/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+	pu16Offsets = (volatile uint16 *)(&pu32Snapshot[4]);
+
+	if((pu32Header[0] != ValidBlockLo) || (pu32Header[1] != ValidBlockHi) ||
+	   (pu32Header[5] != (((uint32)TI_FEE_SNAPSHOT_SIZE << 16U) | (uint32)TI_FEE_SNAPSHOT_BLOCK_NUMBER)) ||
+	   (pu32Snapshot[0] != TI_FEE_SNAPSHOT_MAGIC) || (pu32Snapshot[1] != TI_FeeInternal_SnapshotSignature()))
+	{
+		return(0U);
+	}
+
+	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_TOTAL_BLOCKS_DATASETS ; u16LoopIndex++)
+	{
+		u32Sum1 = (u32Sum1 + pu16Offsets[u16LoopIndex]) % 0xFFFFU;
+		u32Sum2 = (u32Sum2 + u32Sum1) % 0xFFFFU;
+	}
+	if(pu32Snapshot[2] != ((u32Sum2 << 16U) | u32Sum1))
+	{
+		return(0U);
+	}
+
+	for(u16LoopIndex=0U ; u16LoopIndex<TI_FEE_TOTAL_BLOCKS_DATASETS ; u16LoopIndex++)
+	{
+		u16Offset = pu16Offsets[u16LoopIndex];
+		if((0x0BADU != u16Offset) && ((u32VirtualSectorStartAddress + u16Offset + TI_FEE_BLOCK_OVERHEAD) <= u32SnapshotAddress))
+		{
+			/* Take the offset only if the header there is still a valid header of this data set */
+			/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Casting is required here."*/
+			pu32Header = (volatile uint32 *)(u32VirtualSectorStartAddress + u16Offset);
+			u16BlockNumber = (uint16)pu32Header[5];
+			if((pu32Header[0] == ValidBlockLo) && (pu32Header[1] == ValidBlockHi) &&
+			   (u16LoopIndex == TI_FeeInternal_GetArrayIndex(TI_FeeInternal_GetBlockNumber(u16BlockNumber),
+			                                                 TI_FeeInternal_GetDataSetIndex(u16BlockNumber), u8EEPIndex, TRUE)))
 			{
-				break;
+				TI_Fee_GlobalVariables[u8EEPIndex].Fee_au16BlockOffset[u16LoopIndex] = u16Offset;
+				TI_Fee_GlobalVariables[u8EEPIndex].Fee_au8BlockCopyStatus[u16LoopIndex] = 0U;
 			}
 		}
-		u16RetValue=u16LoopIndex;	
 	}
-	return(u16RetValue);
+	return(u32SnapshotAddress);
 }
+#endif
 /**********************************************************************************************************************
  *  TI_FeeInternal_UpdateBlockOffsetArray
  *********************************************************************************************************************/
@@ -1496,6 +1879,19 @@ void TI_FeeInternal_UpdateBlockOffsetArray(uint8 u8EEPIndex, boolean bActCpyVS,
 
 	/* First block starts after VS header */
 	u32BlockStartAddress  =  u32VirtualSectorStartAddress+TI_FEE_VIRTUAL_SECTOR_OVERHEAD + 16U; 	
+	#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+	/* Blocks before the snapshot of the Active VS are known. Scan only the block headers written after it. */
+	if(bActCpyVS == TRUE)
+	{
+		u32BlockStartAddresstemp = TI_FeeInternal_LoadBlockOffsetSnapshot(u8EEPIndex, u32VirtualSectorStartAddress,
+		                                                                  u32VirtualSectorEndAddress);
+		if(0U != u32BlockStartAddresstemp)
+		{
+			u32BlockStartAddress = u32BlockStartAddresstemp;
+		}
+		u32BlockStartAddresstemp = 0U;
+	}
+	#endif
 	
 	/* Scan the sector until empty block is found and update the block offset array */
 	while(u32BlockStartAddress < u32VirtualSectorEndAddress)
@@ -2171,6 +2567,123 @@ void TI_FeeInternal_SanityCheck(uint16 BlockSize, uint8 u8EEPIndex)
 }
 
 
+#if (TI_FEE_BACKGROUND_COPY == STD_ON)
+/**********************************************************************************************************************
+ *  TI_FeeInternal_BackgroundCopyDue
+ *********************************************************************************************************************/
+/*! \brief      This function checks if the copy of the valid blocks into the next virtual sector should be started 
+ *				while the FEE is idle. The active VS must be filled to TI_FEE_BACKGROUND_COPY_THRESHOLD percent, the
+ *				copy must free TI_FEE_BACKGROUND_COPY_MIN_RECLAIM percent of the VS and an empty VS must be available,
+ *				so that no erase is needed to start the copy.
+ *  \param[in]	uint8 u8EEPIndex  
+ *  \param[out] none 
+ *  \return 	TRUE if the copy should be started
+ *  \context    Internal Function, called by TI_FeeInternal_FeeManager.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static boolean TI_FeeInternal_BackgroundCopyDue(uint8 u8EEPIndex)
+{
+	uint32 u32VirtualSectorSize = 0U;
+	uint32 u32UsedSize = 0U;
+	uint32 u32ValidSize = 0U;
+	uint16 u16LoopIndex = 0U;
+	uint16 u16LoopIndex1 = 0U;
+	boolean bCopyDue = FALSE;
+
+	if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState == IDLE) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_oStatus == TI_FEE_OK) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32InternalEraseQueue == 0U) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector != 0U) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8CopyVirtualSector == 0U) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_bWriteVSHeader == FALSE) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_oVirtualSectorEndAddress > TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress) &&
+	   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress > TI_Fee_GlobalVariables[u8EEPIndex].Fee_oActiveVirtualSectorAddress))
+	{
+		u32VirtualSectorSize = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oVirtualSectorEndAddress - 
+		                       TI_Fee_GlobalVariables[u8EEPIndex].Fee_oActiveVirtualSectorAddress;
+		u32UsedSize = TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextActiveVSwriteaddress - 
+		              TI_Fee_GlobalVariables[u8EEPIndex].Fee_oActiveVirtualSectorAddress;
+		if((u32UsedSize * 100U) >= (u32VirtualSectorSize * TI_FEE_BACKGROUND_COPY_THRESHOLD))
+		{
+			/* Size of the copy if every data set of the EEP holds a valid block */
+			u32ValidSize = TI_FEE_VIRTUAL_SECTOR_OVERHEAD + 16U;
+			#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+			u32ValidSize += TI_FEE_BLOCK_OVERHEAD + TI_FEE_SNAPSHOT_SIZE;
+			#endif
+			for(u16LoopIndex = 0U; u16LoopIndex < TI_FEE_NUMBER_OF_BLOCKS; u16LoopIndex++)
+			{
+				if(Fee_BlockConfiguration[u16LoopIndex].FeeEEPNumber == u8EEPIndex)
+				{
+					u32ValidSize += TI_FeeInternal_AlignAddressForECC(TI_FeeInternal_GetBlockSize(u16LoopIndex)) *
+					                Fee_BlockConfiguration[u16LoopIndex].FeeNumberOfDataSets;
+				}
+			}
+			if((u32UsedSize > u32ValidSize) &&
+			   (((u32UsedSize - u32ValidSize) * 100U) >= (u32VirtualSectorSize * TI_FEE_BACKGROUND_COPY_MIN_RECLAIM)))
+			{
+				if(0U == u8EEPIndex)
+				{
+					u16LoopIndex = 0U;	
+					u16LoopIndex1 = (uint16)(TI_FEE_NUMBER_OF_VIRTUAL_SECTORS - TI_FEE_NUMBER_OF_VIRTUAL_SECTORS_EEP1);	
+				}
+				else
+				{
+					u16LoopIndex = TI_FEE_NUMBER_OF_VIRTUAL_SECTORS_EEP1;
+					u16LoopIndex1 = TI_FEE_NUMBER_OF_VIRTUAL_SECTORS;	
+				}
+				for(; u16LoopIndex<u16LoopIndex1 ; u16LoopIndex++)
+				{
+					if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_au8VirtualSectorState[u16LoopIndex] == VsState_Empty)
+					{
+						bCopyDue = TRUE;
+						break;
+					}
+				}
+			}
+		}
+	}
+	return(bCopyDue);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_StartBackgroundCopy
+ *********************************************************************************************************************/
+/*! \brief      This function marks the next virtual sector as Copy VS and starts the copy of all valid blocks into
+ *				it, like a write which does not fit into the active VS, but without a block to write.
+ *  \param[in]	uint8 u8EEPIndex  
+ *  \param[out] none 
+ *  \return 	none
+ *  \context    Internal Function, called by TI_FeeInternal_FeeManager.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_StartBackgroundCopy(uint8 u8EEPIndex)
+{
+	uint8 u8CopyVirtualSector = 0U;
+
+	/* Find the next Virtual Sector to copy to */
+	u8CopyVirtualSector = TI_FeeInternal_FindNextVirtualSector(u8EEPIndex);
+	if((u8CopyVirtualSector != 0U) && (TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil))
+	{
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8CopyVirtualSector = u8CopyVirtualSector;
+		/* Immediately Update the VS state to COPY */
+		TI_FeeInternal_WriteVirtualSectorHeader(u8CopyVirtualSector, VsState_Copy, u8EEPIndex);
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCopyVirtualSectorAddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oVirtualSectorStartAddress;
+		/* Next data write happens after VS Header */
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextCopyVSwriteaddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_oVirtualSectorStartAddress+TI_FEE_VIRTUAL_SECTOR_OVERHEAD+16U;
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextwriteaddress = TI_Fee_GlobalVariables[u8EEPIndex].Fee_u32nextCopyVSwriteaddress;
+		/* Clear the block copy status of all blocks. All blocks need to be copied in background */
+		TI_FeeInternal_SetClearCopyBlockState(u8EEPIndex,(boolean)FALSE);
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockCopyIndex = 0xFFFFU;
+		/* The blocks are copied by the next calls of TI_FeeInternal_FeeManager */
+		TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.Copy = 1U;
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState = BUSY_INTERNAL;
+		TI_Fee_oLatencyStats[u8EEPIndex].u32BackgroundCopies++;
+	}
+}
+#endif
+
 /**********************************************************************************************************************
  *  TI_FeeInternal_FeeManager
  *********************************************************************************************************************/
@@ -2526,6 +3039,13 @@ TI_Fee_StatusType TI_FeeInternal_FeeManager(uint8 u8EEPIndex)
 						(void)TI_FeeInternal_WriteDataF021(FALSE,(uint16)8U,u8EEPIndex);
 					}
 				}
+				#if (TI_FEE_BLOCK_OFFSET_SNAPSHOT == STD_ON)
+				else if(FALSE == TI_FeeInternal_WriteBlockOffsetSnapshot(u8EEPIndex))
+				{
+					/* All valid blocks are in the new Active VS. Their offsets are persisted for the next
+					   TI_Fee_Init, one program command per call. */
+				}
+				#endif
 				else
 				{
 					TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8WriteCopyVSHeader = 0U;
@@ -2598,7 +3118,7 @@ TI_Fee_StatusType TI_FeeInternal_FeeManager(uint8 u8EEPIndex)
 												               u8EEPIndex);
 							/* To avoid MISRA warning */
 							u8CopyWriteCount = u8CopyWriteCount;									
-							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16CopyBlockSize <= 8U)
+							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16CopyBlockSize <= u8CopyWriteCount)
 							{							
 								TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16CopyBlockSize = 0U;
 								break;								
@@ -2797,6 +3317,13 @@ TI_Fee_StatusType TI_FeeInternal_FeeManager(uint8 u8EEPIndex)
 			}				
 		}
 		#endif
+		#if (TI_FEE_BACKGROUND_COPY == STD_ON)
+		else if(TRUE == TI_FeeInternal_BackgroundCopyDue(u8EEPIndex))
+		{
+			/* Make room while the FEE is idle, instead of in the write which does not fit anymore */
+			TI_FeeInternal_StartBackgroundCopy(u8EEPIndex);
+		}
+		#endif
 		#if(TI_FEE_NUMBER_OF_EEPS==2U)
 		else if(((0U == u8EEPIndex) && ((TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector == (uint8)(TI_FEE_NUMBER_OF_VIRTUAL_SECTORS - TI_FEE_NUMBER_OF_VIRTUAL_SECTORS_EEP1)) ||(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector == (uint8)1U)))
                 || ((1U == u8EEPIndex) && ((TI_Fee_GlobalVariables[u8EEPIndex].Fee_u8ActiveVirtualSector == (uint8)TI_FEE_NUMBER_OF_VIRTUAL_SECTORS) ||
@@ -3589,38 +4116,150 @@ void TI_FeeInternal_CheckForError(uint8 u8EEPIndex)
  *  \return 	16bit checksum
  *  \context    Internal Function.
  *  \note       TI FEE Internal API.
+ *				The aligned part of the data is read one word at a time into 32 bit sums, which are folded
+ *				every TI_FEE_FLETCHER_WORDS_PER_FOLD words. Both sums are returned in the range 1..255, as the
+ *				byte wise implementation did, so checksums already stored in flash stay valid.
+ *				A NULL data pointer is summed as u16Length zero bytes.
  *********************************************************************************************************************/
  #if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
 uint32 TI_FeeInternal_Fletcher16( uint8 const *pu8data, uint16 u16Length)
 {
-	uint16 u16sum1 = 0xFFU;
-	uint16 u16sum2 = 0xFFU;	
+	uint32 u32sum1 = 0xFFU;
+	uint32 u32sum2 = 0xFFU;	
+	uint32 u32Word;
+	uint32 u32Byte0, u32Byte1, u32Byte2, u32Byte3;
 	uint16 u16len;		
+	uint32 const *pu32data;
 	 
-	while(u16Length > 0U) 
+	if(pu8data == NULL_PTR)
+	{
+		/* Every byte adds the unchanged first sum to the second sum */
+		u32sum2 += (uint32)u16Length * 0xFFU;
+		u16Length = 0U;
+	}
+	/* Bytes up to the first word boundary */
+	/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Cast is required to check alignment."*/
+	while((u16Length > 0U) && (((uint32)pu8data & 3U) != 0U))
+	{
+		u32sum1 += *pu8data;
+		u32sum2 += u32sum1;
+		pu8data += 1U;
+		u16Length -= 1U;
+	}
+	/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+	/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+	pu32data = (uint32 const *)pu8data;
+	while(u16Length >= 4U) 
 	{
-		u16len = u16Length > 20U ? 20U : u16Length;
+		u16len = (u16Length > (TI_FEE_FLETCHER_WORDS_PER_FOLD << 2U)) ? (uint16)(TI_FEE_FLETCHER_WORDS_PER_FOLD << 2U) :
+		                                                                (uint16)(u16Length & 0xFFFCU);
 		u16Length -= u16len;
 		do 
 		{
-			if(pu8data != 0U)
-			{
-				u16sum1 += *pu8data;
-				pu8data += 1U;
-			}	
-			u16sum2 += u16sum1;
-			u16len -= 1U;
-			
+			u32Word = *pu32data;
+			pu32data += 1U;
+			/* Byte 0 is the byte at the lowest address */
+			#ifdef _BIG_ENDIAN
+			u32Byte0 = u32Word >> 24U;
+			u32Byte1 = (u32Word >> 16U) & 0xFFU;
+			u32Byte2 = (u32Word >> 8U) & 0xFFU;
+			u32Byte3 = u32Word & 0xFFU;
+			#else
+			u32Byte0 = u32Word & 0xFFU;
+			u32Byte1 = (u32Word >> 8U) & 0xFFU;
+			u32Byte2 = (u32Word >> 16U) & 0xFFU;
+			u32Byte3 = u32Word >> 24U;
+			#endif
+			/* Four byte steps: sum2 gains 4*sum1 and each byte once per remaining step */
+			u32sum2 += (u32sum1 << 2U) + (u32Byte0 << 2U) + (u32Byte1 * 3U) + (u32Byte2 << 1U) + u32Byte3;
+			u32sum1 += u32Byte0 + u32Byte1 + u32Byte2 + u32Byte3;
+			u16len -= 4U;
 		}while(u16len > 0U);
-		u16sum1 = (u16sum1 & 0xFFU) + (u16sum1 >> 8U);
-		u16sum2 = (u16sum2 & 0xFFU) + (u16sum2 >> 8U);
+		/* Fold the sums back below 0x300, the value modulo 255 is kept */
+		u32sum1 = (u32sum1 & 0xFFFFU) + (u32sum1 >> 16U);
+		u32sum1 = (u32sum1 & 0xFFU) + (u32sum1 >> 8U);
+		u32sum2 = (u32sum2 & 0xFFFFU) + (u32sum2 >> 16U);
+		u32sum2 = (u32sum2 & 0xFFU) + (u32sum2 >> 8U);
 	}
-	/* Second reduction step to reduce sums to 8 bits */
-	u16sum1 = (u16sum1 & 0xFFU) + (u16sum1 >> 8U);
-	u16sum2 = (u16sum2 & 0xFFU) + (u16sum2 >> 8U);
-	return ((u16sum2 << 8U) | u16sum1);
+	pu8data = (uint8 const *)pu32data;
+	/* Remaining bytes */
+	while(u16Length > 0U)
+	{
+		u32sum1 += *pu8data;
+		u32sum2 += u32sum1;
+		pu8data += 1U;
+		u16Length -= 1U;
+	}
+	/* Reduce sums to 8 bits. A sum is never 0, so 255 stands for 0 modulo 255 */
+	u32sum1 = (u32sum1 & 0xFFFFU) + (u32sum1 >> 16U);
+	u32sum1 = (u32sum1 & 0xFFU) + (u32sum1 >> 8U);
+	u32sum1 = (u32sum1 & 0xFFU) + (u32sum1 >> 8U);
+	u32sum1 = (u32sum1 & 0xFFU) + (u32sum1 >> 8U);
+	u32sum2 = (u32sum2 & 0xFFFFU) + (u32sum2 >> 16U);
+	u32sum2 = (u32sum2 & 0xFFU) + (u32sum2 >> 8U);
+	u32sum2 = (u32sum2 & 0xFFU) + (u32sum2 >> 8U);
+	u32sum2 = (u32sum2 & 0xFFU) + (u32sum2 >> 8U);
+	return ((u32sum2 << 8U) | u32sum1);
 }
 #endif
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_BlockDataMatches
+ *********************************************************************************************************************/
+/*! \brief      This function compares the data of a block in flash with the data to be written.
+ *  \param[in]	oBlockAddress : Address of the block header
+ *  \param[in]	pu8Data
+ *  \param[in]	u16Length
+ *  \param[out] none 
+ *  \return 	TRUE if the data is equal
+ *  \context    Internal Function.
+ *  \note       TI FEE Internal API.
+ *				The block data starts on a word boundary. If the source is word aligned too, the data is compared
+ *				one word at a time.
+ *********************************************************************************************************************/
+boolean TI_FeeInternal_BlockDataMatches(TI_Fee_AddressType oBlockAddress, uint8 const *pu8Data, uint16 u16Length)
+{
+	uint8 const *pu8FlashData;
+	uint32 const *pu32FlashData;
+	uint32 const *pu32Data;
+	boolean bMatch = TRUE;
+
+	/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
+	pu8FlashData = (uint8 const *)(oBlockAddress + TI_FEE_BLOCK_OVERHEAD);
+	/*SAFETYMCUSW 439 S MR:11.3 <APPROVED> "Reason -  Cast is required to check alignment."*/
+	if((((uint32)pu8Data | (uint32)pu8FlashData) & 3U) == 0U)
+	{
+		/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		pu32FlashData = (uint32 const *)pu8FlashData;
+		/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		/*SAFETYMCUSW 95 S MR:11.1,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		pu32Data = (uint32 const *)pu8Data;
+		while((u16Length >= 4U) && (bMatch == TRUE))
+		{
+			if(*pu32FlashData != *pu32Data)
+			{
+				bMatch = FALSE;
+			}
+			pu32FlashData += 1U;
+			pu32Data += 1U;
+			u16Length -= 4U;
+		}
+		pu8FlashData = (uint8 const *)pu32FlashData;
+		pu8Data = (uint8 const *)pu32Data;
+	}
+	while((u16Length > 0U) && (bMatch == TRUE))
+	{
+		if(*pu8FlashData != *pu8Data)
+		{
+			bMatch = FALSE;
+		}
+		pu8FlashData += 1U;
+		pu8Data += 1U;
+		u16Length -= 1U;
+	}
+	return(bMatch);
+}
 /**********************************************************************************************************************
  *  TI_Fee_ErrorRecovery
  *********************************************************************************************************************/
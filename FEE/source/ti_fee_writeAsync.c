@@ -113,10 +113,6 @@ Std_ReturnType TI_Fee_WriteAsync(uint16 BlockNumber,uint8* DataBufferPtr)
 	uint16 u16ArrayIndex = 0U;
 	#if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)	
 	uint32 u32CheckSum = 0U;
-	#else
-	uint8 * pu8ReadData;
-	uint8 * pu8ReadSourceData;
-	uint16 u16LoopIndex;
 	#endif
 	uint8 u8EEPIndex = 0U;
 	boolean bDoNotWrite = FALSE;
@@ -125,6 +121,7 @@ Std_ReturnType TI_Fee_WriteAsync(uint16 BlockNumber,uint8* DataBufferPtr)
 	#endif	
 	TI_FeeModuleStatusType ModuleState=IDLE;	
 	boolean bError=FALSE;
+	boolean bCached=FALSE;
 	
 	TI_Fee_u8DeviceIndex = 0U;	
 	
@@ -144,11 +141,18 @@ Std_ReturnType TI_Fee_WriteAsync(uint16 BlockNumber,uint8* DataBufferPtr)
 		TI_Fee_GlobalVariables[u8EEPIndex+1U].Fee_u16JobResult=JOB_FAILED;
 		#endif
 	}	
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	else
+	{
+		/* A write of a cached block completes in RAM */
+		bCached = TI_FeeInternal_WriteCacheStore(BlockNumber, DataBufferPtr);
+	}
+	#endif
 	/*SAFETYMCUSW 139 S MR:13.7 <APPROVED> "Reason - bError is set to TRUE in above lines."*/	
 	/*SAFETYMCUSW 433 S MR:6.1,6.2,10.1,10.2,10.3,10.4  <APPROVED> "Reason - LDRA Version
       problem. Latest version do not have this warning."*/
 	/*SAFETYMCUSW 96 S MR:6.2,10.1,10.2,12.6 <APPROVED> "Macro comes from compiler files."*/
-	if(FALSE == bError) 
+	if((FALSE == bError) && (FALSE == bCached))
 	{
 		/* Determine the Block number & Block index */
 		/* From the block number, remove data selection bits */
@@ -278,7 +282,11 @@ Std_ReturnType TI_Fee_WriteAsync(uint16 BlockNumber,uint8* DataBufferPtr)
 							ppu32ReadHeader = (uint32 **)&TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress;
 							u32CheckSum = **ppu32ReadHeader;
 							TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress -= (((TI_FEE_BLOCK_OVERHEAD >> 2U)-3U) << 2U);
-							if(TI_Fee_u32FletcherChecksum == u32CheckSum)
+							/* A checksum match is confirmed on the data, so that a Fletcher16 collision is not taken for a 
+							   redundant write */
+							if((TI_Fee_u32FletcherChecksum == u32CheckSum) &&
+							   (TRUE == TI_FeeInternal_BlockDataMatches(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress,
+							                                            DataBufferPtr, TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD)))
 							{
 								bDoNotWrite = TRUE;
 								/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This 
@@ -301,24 +309,10 @@ Std_ReturnType TI_Fee_WriteAsync(uint16 BlockNumber,uint8* DataBufferPtr)
 							/* MISRA C Compliance */
 						}	
 						#else						
-						/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
-						pu8ReadData = (uint8 *)(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress + TI_FEE_BLOCK_OVERHEAD);
-						pu8ReadSourceData = DataBufferPtr;
-						bDoNotWrite = TRUE;
-						for(u16LoopIndex = 0U; u16LoopIndex < (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD); u16LoopIndex++)
+						if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error != Error_CurrentAddress)
 						{
-							if(*pu8ReadData != *pu8ReadSourceData)
-							{
-								bDoNotWrite = FALSE;
-								break;
-							}
-							else
-							{
-								/*SAFETYMCUSW 567 S MR:17.1,17.4 <APPROVED> "Reason -  Pointer Arithmatic is necessary here."*/
-								pu8ReadData++;
-								/*SAFETYMCUSW 567 S MR:17.1,17.4 <APPROVED> "Reason -  Pointer Arithmatic is necessary here."*/
-								pu8ReadSourceData++;
-							}							
+							bDoNotWrite = TI_FeeInternal_BlockDataMatches(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress,
+							                            DataBufferPtr, TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD);
 						}
 						/*SAFETYMCUSW 433 S MR:6.1,6.2,10.1,10.2,10.3,10.4  <APPROVED> "Reason - LDRA Version
                           problem. Latest version do not have this warning."*/
@@ -0,0 +1,455 @@
+/**********************************************************************************************************************
+ *  FILE DESCRIPTION
+ *  -------------------------------------------------------------------------------------------------------------------
+ *         File:  ti_fee_writeCache.c
+ *      Project:  Tms570_TIFEEDriver
+ *       Module:  TIFEEDriver
+ *    Generator:  None
+ *
+ *  Description:  This file implements the RAM write-back cache of the TI FEE driver (TI_FEE_WRITE_CACHE) and the
+ *                TI FEE Apis TI_Fee_FlushWriteCache and TI_Fee_GetWriteCacheStats.
+ *
+ *                TI_Fee_WriteAsync of a cached block copies the data into the entry of the block and marks it
+ *                dirty. TI_Fee_MainFunction writes a dirty block with TI_Fee_WriteAsync when its flush is due, one
+ *                block at a time, and only while the FEE is idle. While the flush of a block runs, its entry is
+ *                not changed: further writes of the block are rejected like any write while the FEE is busy.
+ *                TI_Fee_Read and TI_Fee_ReadSync of a dirty or flushing block copy from the entry.
+ *********************************************************************************************************************/
+
+ /*********************************************************************************************************************
+ * INCLUDES
+ *********************************************************************************************************************/
+#include "ti_fee.h"
+
+#if (TI_FEE_WRITE_CACHE == STD_ON)
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_START_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheGetEntry
+ *********************************************************************************************************************/
+/*! \brief      This function returns the write cache entry of a block.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[out] none
+ *  \return     Index of the entry, TI_FEE_WRITE_CACHE_BLOCKS if the block is not cached
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static uint16 TI_FeeInternal_WriteCacheGetEntry(uint16 BlockNumber)
+{
+	uint16 u16Entry = 0U;
+
+	while((u16Entry < TI_FEE_WRITE_CACHE_BLOCKS) &&
+	      ((TI_Fee_aoWriteCache[u16Entry].u16BlockNumber != BlockNumber) ||
+	       (TI_Fee_aoWriteCache[u16Entry].u16Size == 0U)))
+	{
+		u16Entry++;
+	}
+	return(u16Entry);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheIsDirty
+ *********************************************************************************************************************/
+/*! \brief      This function returns the dirty bit of a write cache entry.
+ *  \param[in]  u16Entry
+ *  \param[out] none
+ *  \return     TRUE if the entry holds data not written to flash
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static boolean TI_FeeInternal_WriteCacheIsDirty(uint16 u16Entry)
+{
+	return(((TI_Fee_au32WriteCacheDirty[u16Entry >> 5U] & ((uint32)1U << (u16Entry & 0x1FU))) != 0U) ? TRUE : FALSE);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheClean
+ *********************************************************************************************************************/
+/*! \brief      This function clears the dirty bit and the flush policy counters of a write cache entry.
+ *  \param[in]  u16Entry
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_WriteCacheClean(uint16 u16Entry)
+{
+	TI_Fee_au32WriteCacheDirty[u16Entry >> 5U] &= ~((uint32)1U << (u16Entry & 0x1FU));
+	TI_Fee_aoWriteCache[u16Entry].u32Writes = 0U;
+	TI_Fee_aoWriteCache[u16Entry].u32DirtyCalls = 0U;
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheJobEnd
+ *********************************************************************************************************************/
+/*! \brief      This function completes a job served by the write cache. The job result is left alone while a job
+ *				of the FEE is pending; it is reported when that job completes.
+ *  \param[in]  u8EEPIndex
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+static void TI_FeeInternal_WriteCacheJobEnd(uint8 u8EEPIndex)
+{
+	if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING)
+	{
+		TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult = JOB_OK;
+		#if(STD_OFF == TI_FEE_POLLING_MODE)
+		TI_FEE_NVM_JOB_END_NOTIFICATION();
+		#endif
+	}
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheInit
+ *********************************************************************************************************************/
+/*! \brief      This function assigns the blocks of TI_FEE_WRITE_CACHE_BLOCK_LIST their space in the write cache
+ *				and clears all entries. Blocks which are not configured or do not fit are not cached.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_Init after TI_FeeInternal_BuildBlockIndex.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+void TI_FeeInternal_WriteCacheInit(void)
+{
+	static const uint16 au16CachedBlocks[TI_FEE_WRITE_CACHE_BLOCKS] = TI_FEE_WRITE_CACHE_BLOCK_LIST;
+	uint16 u16Entry;
+	uint16 u16BlockIndex;
+	uint16 u16Size;
+	uint32 u32Offset = 0U;
+
+	for(u16Entry = 0U; u16Entry < TI_FEE_WRITE_CACHE_BLOCKS; u16Entry++)
+	{
+		TI_Fee_aoWriteCache[u16Entry].u16BlockNumber = au16CachedBlocks[u16Entry];
+		TI_Fee_aoWriteCache[u16Entry].u16Offset = 0U;
+		TI_Fee_aoWriteCache[u16Entry].u16Size = 0U;
+		TI_Fee_aoWriteCache[u16Entry].u8EEPIndex = 0U;
+		u16BlockIndex = TI_FeeInternal_GetBlockIndex(TI_FeeInternal_GetBlockNumber(au16CachedBlocks[u16Entry]));
+		if(u16BlockIndex != 0xFFFFU)
+		{
+			u16Size = Fee_BlockConfiguration[u16BlockIndex].FeeBlockSize;
+			/* Entries start on a word boundary */
+			if((u32Offset + u16Size) <= TI_FEE_WRITE_CACHE_SIZE)
+			{
+				TI_Fee_aoWriteCache[u16Entry].u16Offset = (uint16)u32Offset;
+				TI_Fee_aoWriteCache[u16Entry].u16Size = u16Size;
+				TI_Fee_aoWriteCache[u16Entry].u8EEPIndex = Fee_BlockConfiguration[u16BlockIndex].FeeEEPNumber;
+				u32Offset = (u32Offset + u16Size + 3U) & 0xFFFFFFFCU;
+			}
+		}
+		TI_FeeInternal_WriteCacheClean(u16Entry);
+	}
+	TI_Fee_u16WriteCacheFlushEntry = TI_FEE_WRITE_CACHE_BLOCKS;
+	TI_Fee_bWriteCacheFlushRequest = FALSE;
+	TI_Fee_oWriteCacheStats.u32Writes = 0U;
+	TI_Fee_oWriteCacheStats.u32Reads = 0U;
+	TI_Fee_oWriteCacheStats.u32Flushes = 0U;
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheStore
+ *********************************************************************************************************************/
+/*! \brief      This function takes a write of a cached block. It copies the data into the entry of the block,
+ *				marks it dirty and completes the job.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[in]  DataBufferPtr
+ *  \param[out] none
+ *  \return     TRUE if the cache took the write, FALSE if it has to be written to flash
+ *  \context    Internal Function, called by TI_Fee_WriteAsync.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+boolean TI_FeeInternal_WriteCacheStore(uint16 BlockNumber, const uint8 * DataBufferPtr)
+{
+	boolean bStored = FALSE;
+	uint16 u16Entry = TI_FeeInternal_WriteCacheGetEntry(BlockNumber);
+	uint16 u16Index;
+	uint8 u8EEPIndex;
+	uint8 * pu8Entry;
+
+	/* The entry being flushed is programmed from, it must not change */
+	if((u16Entry < TI_FEE_WRITE_CACHE_BLOCKS) && (u16Entry != TI_Fee_u16WriteCacheFlushEntry))
+	{
+		u8EEPIndex = TI_Fee_aoWriteCache[u16Entry].u8EEPIndex;
+		if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState != UNINIT)
+		{
+			/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+			pu8Entry = (uint8 *)TI_Fee_au32WriteCacheData + TI_Fee_aoWriteCache[u16Entry].u16Offset;
+			for(u16Index = 0U; u16Index < TI_Fee_aoWriteCache[u16Entry].u16Size; u16Index++)
+			{
+				pu8Entry[u16Index] = DataBufferPtr[u16Index];
+			}
+			TI_Fee_au32WriteCacheDirty[u16Entry >> 5U] |= ((uint32)1U << (u16Entry & 0x1FU));
+			TI_Fee_aoWriteCache[u16Entry].u32Writes++;
+			TI_Fee_oWriteCacheStats.u32Writes++;
+			TI_FeeInternal_WriteCacheJobEnd(u8EEPIndex);
+			bStored = TRUE;
+		}
+	}
+	return(bStored);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheLoad
+ *********************************************************************************************************************/
+/*! \brief      This function serves a read of a block whose latest data is in the write cache, i.e. a dirty block
+ *				or the block being flushed.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[in]  BlockOffset
+ *  \param[in]  Length : 0xFFFF reads the whole block
+ *  \param[out] DataBufferPtr
+ *  \return     TRUE if the cache served the read, FALSE if it has to be read from flash
+ *  \context    Internal Function, called by TI_Fee_Read and TI_Fee_ReadSync.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+boolean TI_FeeInternal_WriteCacheLoad(uint16 BlockNumber, uint16 BlockOffset, uint8 * DataBufferPtr, uint16 Length)
+{
+	boolean bLoaded = FALSE;
+	uint16 u16Entry = TI_FeeInternal_WriteCacheGetEntry(BlockNumber);
+	uint16 u16Length = Length;
+	uint16 u16Index;
+	uint8 u8EEPIndex;
+	const uint8 * pu8Entry;
+
+	if((u16Entry < TI_FEE_WRITE_CACHE_BLOCKS) && (DataBufferPtr != NULL_PTR) &&
+	   ((TRUE == TI_FeeInternal_WriteCacheIsDirty(u16Entry)) || (u16Entry == TI_Fee_u16WriteCacheFlushEntry)))
+	{
+		u8EEPIndex = TI_Fee_aoWriteCache[u16Entry].u8EEPIndex;
+		if(u16Length == 0xFFFFU)
+		{
+			u16Length = TI_Fee_aoWriteCache[u16Entry].u16Size - BlockOffset;
+		}
+		/* Reads outside the block are left to the flash path, which reports them */
+		if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error == Error_Nil) &&
+		   (BlockOffset < TI_Fee_aoWriteCache[u16Entry].u16Size) &&
+		   ((uint32)u16Length <= (uint32)(TI_Fee_aoWriteCache[u16Entry].u16Size - BlockOffset)))
+		{
+			/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+			pu8Entry = (const uint8 *)TI_Fee_au32WriteCacheData + TI_Fee_aoWriteCache[u16Entry].u16Offset + BlockOffset;
+			for(u16Index = 0U; u16Index < u16Length; u16Index++)
+			{
+				DataBufferPtr[u16Index] = pu8Entry[u16Index];
+			}
+			TI_Fee_oWriteCacheStats.u32Reads++;
+			TI_FeeInternal_WriteCacheJobEnd(u8EEPIndex);
+			bLoaded = TRUE;
+		}
+	}
+	return(bLoaded);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheView
+ *********************************************************************************************************************/
+/*! \brief      This function returns the data of a block whose latest data is in the write cache.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[out] none
+ *  \return     Start of the data in the write cache, NULL_PTR if the data in flash is the latest
+ *  \context    Internal Function, called by TI_Fee_GetBlockView.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+const uint8 * TI_FeeInternal_WriteCacheView(uint16 BlockNumber)
+{
+	const uint8 * pu8Entry = NULL_PTR;
+	uint16 u16Entry = TI_FeeInternal_WriteCacheGetEntry(BlockNumber);
+
+	if((u16Entry < TI_FEE_WRITE_CACHE_BLOCKS) &&
+	   ((TRUE == TI_FeeInternal_WriteCacheIsDirty(u16Entry)) || (u16Entry == TI_Fee_u16WriteCacheFlushEntry)))
+	{
+		/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+		pu8Entry = (const uint8 *)TI_Fee_au32WriteCacheData + TI_Fee_aoWriteCache[u16Entry].u16Offset;
+	}
+	return(pu8Entry);
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheDiscard
+ *********************************************************************************************************************/
+/*! \brief      This function drops the unflushed data of a block, which a later job has superseded.
+ *  \param[in]  BlockNumber : Block number including the data set bits
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_WriteSync, TI_Fee_InvalidateBlock and
+ *				TI_Fee_EraseImmediateBlock when they accepted the job.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+void TI_FeeInternal_WriteCacheDiscard(uint16 BlockNumber)
+{
+	uint16 u16Entry = TI_FeeInternal_WriteCacheGetEntry(BlockNumber);
+
+	if(u16Entry < TI_FEE_WRITE_CACHE_BLOCKS)
+	{
+		TI_FeeInternal_WriteCacheClean(u16Entry);
+	}
+}
+
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheFlush
+ *********************************************************************************************************************/
+/*! \brief      This function completes the running flush and starts the next one which is due. A block is due
+ *				after TI_FEE_WRITE_CACHE_FLUSH_WRITES writes, TI_FEE_WRITE_CACHE_FLUSH_CALLS calls after the first
+ *				of them, or when TI_Fee_FlushWriteCache was called. A flush which fails leaves the block dirty.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Internal Function, called by TI_Fee_MainFunction.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+void TI_FeeInternal_WriteCacheFlush(void)
+{
+	uint16 u16Entry;
+	uint16 u16Due = TI_FEE_WRITE_CACHE_BLOCKS;
+	uint8 u8EEPIndex;
+	boolean bDirty = FALSE;
+
+	u16Entry = TI_Fee_u16WriteCacheFlushEntry;
+	if(u16Entry < TI_FEE_WRITE_CACHE_BLOCKS)
+	{
+		u8EEPIndex = TI_Fee_aoWriteCache[u16Entry].u8EEPIndex;
+		if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING) &&
+		   (TI_Fee_oStatusWord[u8EEPIndex].Fee_StatusWordType_ST.WriteAsync == 0U))
+		{
+			if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_OK)
+			{
+				TI_Fee_au32WriteCacheDirty[u16Entry >> 5U] |= ((uint32)1U << (u16Entry & 0x1FU));
+			}
+			TI_Fee_u16WriteCacheFlushEntry = TI_FEE_WRITE_CACHE_BLOCKS;
+		}
+	}
+
+	for(u16Entry = 0U; u16Entry < TI_FEE_WRITE_CACHE_BLOCKS; u16Entry++)
+	{
+		if(TRUE == TI_FeeInternal_WriteCacheIsDirty(u16Entry))
+		{
+			bDirty = TRUE;
+			TI_Fee_aoWriteCache[u16Entry].u32DirtyCalls++;
+			if((u16Due == TI_FEE_WRITE_CACHE_BLOCKS) &&
+			   ((TI_Fee_bWriteCacheFlushRequest == TRUE) ||
+			    (TI_Fee_aoWriteCache[u16Entry].u32Writes >= TI_FEE_WRITE_CACHE_FLUSH_WRITES) ||
+			    (TI_Fee_aoWriteCache[u16Entry].u32DirtyCalls >= TI_FEE_WRITE_CACHE_FLUSH_CALLS)))
+			{
+				u16Due = u16Entry;
+			}
+		}
+	}
+	if((bDirty == FALSE) && (TI_Fee_u16WriteCacheFlushEntry == TI_FEE_WRITE_CACHE_BLOCKS))
+	{
+		TI_Fee_bWriteCacheFlushRequest = FALSE;
+	}
+
+	/* Flush one block at a time, and leave copies and erases of virtual sectors alone */
+	if((u16Due < TI_FEE_WRITE_CACHE_BLOCKS) && (TI_Fee_u16WriteCacheFlushEntry == TI_FEE_WRITE_CACHE_BLOCKS))
+	{
+		u8EEPIndex = TI_Fee_aoWriteCache[u16Due].u8EEPIndex;
+		if((TI_Fee_GlobalVariables[u8EEPIndex].Fee_ModuleState == IDLE) &&
+		   (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16JobResult != JOB_PENDING))
+		{
+			/* Marking the entry as flushing makes TI_Fee_WriteAsync write it to flash */
+			TI_Fee_u16WriteCacheFlushEntry = u16Due;
+			/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+			if(E_OK == TI_Fee_WriteAsync(TI_Fee_aoWriteCache[u16Due].u16BlockNumber,
+			                             (uint8 *)TI_Fee_au32WriteCacheData + TI_Fee_aoWriteCache[u16Due].u16Offset))
+			{
+				TI_FeeInternal_WriteCacheClean(u16Due);
+				TI_Fee_oWriteCacheStats.u32Flushes++;
+			}
+			else
+			{
+				TI_Fee_u16WriteCacheFlushEntry = TI_FEE_WRITE_CACHE_BLOCKS;
+			}
+		}
+	}
+}
+
+#if(TI_FEE_DRIVER == 1U)
+/**********************************************************************************************************************
+ *  TI_FeeInternal_WriteCacheFlushSync
+ *********************************************************************************************************************/
+/*! \brief      This function writes all dirty blocks to flash with TI_Fee_WriteSync.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     E_OK if all blocks were written
+ *  \return     E_NOT_OK
+ *  \context    Internal Function, called by TI_Fee_Shutdown after the running job has been completed.
+ *  \note       TI FEE Internal API.
+ *********************************************************************************************************************/
+Std_ReturnType TI_FeeInternal_WriteCacheFlushSync(void)
+{
+	Std_ReturnType oResult = E_OK;
+	uint16 u16Entry;
+
+	/* TI_Fee_Shutdown has completed the running flush */
+	TI_Fee_u16WriteCacheFlushEntry = TI_FEE_WRITE_CACHE_BLOCKS;
+	for(u16Entry = 0U; u16Entry < TI_FEE_WRITE_CACHE_BLOCKS; u16Entry++)
+	{
+		if(TRUE == TI_FeeInternal_WriteCacheIsDirty(u16Entry))
+		{
+			/* TI_Fee_WriteSync cleans the entry when it accepts the write */
+			/*SAFETYMCUSW 94 S MR:11.1,11.2,11.4 <APPROVED> "Reason -  Casting is required here."*/
+			if(E_OK == TI_Fee_WriteSync(TI_Fee_aoWriteCache[u16Entry].u16BlockNumber,
+			                            (uint8 *)TI_Fee_au32WriteCacheData + TI_Fee_aoWriteCache[u16Entry].u16Offset))
+			{
+				TI_Fee_oWriteCacheStats.u32Flushes++;
+			}
+			else
+			{
+				/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should be fixed
+				  outside of FEE."*/
+				oResult = E_NOT_OK;
+			}
+		}
+	}
+	return(oResult);
+}
+#endif
+
+/**********************************************************************************************************************
+ *  TI_Fee_FlushWriteCache
+ *********************************************************************************************************************/
+/*! \brief      This function requests the flush of all dirty blocks of the write cache. TI_Fee_MainFunction writes
+ *				them one after the other. Only a flag is set, the function may be called from an interrupt, e.g.
+ *				from esmGroup1Notification on an ESM error.
+ *  \param[in]  none
+ *  \param[out] none
+ *  \return     none
+ *  \context    Function could be called from task level or interrupt level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_FlushWriteCache(void)
+{
+	TI_Fee_bWriteCacheFlushRequest = TRUE;
+}
+
+/**********************************************************************************************************************
+ *  TI_Fee_GetWriteCacheStats
+ *********************************************************************************************************************/
+/*! \brief      This function returns the write cache statistics.
+ *  \param[in]  none
+ *  \param[out] pWriteCacheStats
+ *  \return     none
+ *  \context    Function could be called from task level
+ *  \note       TI FEE API.
+ *********************************************************************************************************************/
+/*SAFETYMCUSW 61 D MR:8.10,8.11 <APPROVED> "Reason -  This API will be called by application."*/
+void TI_Fee_GetWriteCacheStats(TI_Fee_WriteCacheStatsType * pWriteCacheStats)
+{
+	if(pWriteCacheStats != NULL_PTR)
+	{
+		*pWriteCacheStats = TI_Fee_oWriteCacheStats;
+	}
+}
+
+/*SAFETYMCUSW 580 S MR:1.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#define FEE_STOP_SEC_CODE
+/*SAFETYMCUSW 338 S MR:19.1 <APPROVED> "Reason - This is the format to use for specifying memorysections."*/
+#include "MemMap.h"
+#endif
+
+/**********************************************************************************************************************
+ *  END OF FILE: ti_fee_writeCache.c
+ *********************************************************************************************************************/
@@ -125,10 +125,6 @@ Std_ReturnType TI_Fee_WriteSync(uint16 BlockNumber,uint8* DataBufferPtr)
 	boolean bDoNotWrite = FALSE;
 	#if(TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON)
 	uint32 u32CheckSum = 0U;
-	#else
-	uint8 * pu8ReadData;
-	uint8 * pu8ReadSourceData;
-	uint16 u16LoopIndex;
 	#endif	
 	boolean bError=FALSE;
 	#if((TI_FEE_FLASH_WRITECOUNTER_SAVE == STD_ON) || (TI_FEE_FLASH_CHECKSUM_ENABLE == STD_ON))
@@ -278,7 +274,11 @@ Std_ReturnType TI_Fee_WriteSync(uint16 BlockNumber,uint8* DataBufferPtr)
 							ppu32ReadHeader = (uint32 **)&TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress;
 							u32CheckSum = **ppu32ReadHeader;
 							TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress -= (((TI_FEE_BLOCK_OVERHEAD >> 2U)-3U) << 2U);
-							if(TI_Fee_u32FletcherChecksum == u32CheckSum)
+							/* A checksum match is confirmed on the data, so that a Fletcher16 collision is not taken for a 
+							   redundant write */
+							if((TI_Fee_u32FletcherChecksum == u32CheckSum) &&
+							   (TRUE == TI_FeeInternal_BlockDataMatches(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress,
+							                                            DataBufferPtr, TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD)))
 							{
 								bDoNotWrite = TRUE;
 								/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should be fixed outside of FEE."*/
@@ -300,24 +300,10 @@ Std_ReturnType TI_Fee_WriteSync(uint16 BlockNumber,uint8* DataBufferPtr)
 							/* MISRA C Compliance */
 						}
 						#else						
-						/*SAFETYMCUSW 440 S MR:11.3 <APPROVED> "Reason -  Casting is required here.*/
-						pu8ReadData = (uint8 *)(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress + TI_FEE_BLOCK_OVERHEAD);
-						pu8ReadSourceData = DataBufferPtr;
-						bDoNotWrite = TRUE;
-						for(u16LoopIndex = 0U; u16LoopIndex < (TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD); u16LoopIndex++)
+						if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_Error != Error_CurrentAddress)
 						{
-							if(*pu8ReadData != *pu8ReadSourceData)
-							{
-								bDoNotWrite = FALSE;
-								break;
-							}
-							else
-							{
-								/*SAFETYMCUSW 567 S MR:17.1,17.4 <APPROVED> "Reason -  Pointer Arithmatic is necessary here."*/
-								pu8ReadData++;
-								/*SAFETYMCUSW 567 S MR:17.1,17.4 <APPROVED> "Reason -  Pointer Arithmatic is necessary here."*/
-								pu8ReadSourceData++;
-							}							
+							bDoNotWrite = TI_FeeInternal_BlockDataMatches(TI_Fee_GlobalVariables[u8EEPIndex].Fee_oCurrentStartAddress,
+							                            DataBufferPtr, TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize-TI_FEE_BLOCK_OVERHEAD);
 						}
 						/*SAFETYMCUSW 433 S MR:6.1,6.2,10.1,10.2,10.3,10.4  <APPROVED> "Reason - LDRA Version
                           problem. Latest version do not have this warning."*/
@@ -448,7 +434,7 @@ Std_ReturnType TI_Fee_WriteSync(uint16 BlockNumber,uint8* DataBufferPtr)
 							u8WriteCount=u8WriteCount;
 							/*SAFETYMCUSW 91 D MR:16.10 <APPROVED> "Reason - Return value is not required."*/
 							(void)TI_FeeInternal_PollFlashStatus();
-							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= 0x8U)
+							if(TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize <= u8WriteCount)
 							{	
 								TI_Fee_GlobalVariables[u8EEPIndex].Fee_u16BlockSize = 0x0U;
 							}	
@@ -574,6 +560,15 @@ Std_ReturnType TI_Fee_WriteSync(uint16 BlockNumber,uint8* DataBufferPtr)
 													   (TI_Fee_oStatusWord[1].Fee_u16StatusWord));
 		#endif
   }
+	#if (TI_FEE_WRITE_CACHE == STD_ON)
+	/*SAFETYMCUSW 331 S MR:10.1 <APPROVED> "Reason - Std_ReturnType is not part of FEE.This should be fixed 
+	  outside of FEE."*/
+	if(oResult == (uint8)E_OK)
+	{
+		/* The job supersedes data of the block which is not flushed yet */
+		TI_FeeInternal_WriteCacheDiscard(BlockNumber);
+	}
+	#endif
   return(oResult);
 }
 #endif
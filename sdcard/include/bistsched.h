@@ -0,0 +1,97 @@
+/*
+ * bistsched.h
+ *
+ *  Scheduler that re-runs PBIST tests in the field, between the work of the
+ *  main loop.
+ *
+ *  The startup sequence of sys_startup.c runs PBIST once and busy-waits for
+ *  it. bistsched_step() instead starts one test of the table in bistsched.c
+ *  every BISTSCHED_PERIOD ticks and polls it on the following calls, so the
+ *  application keeps running while the controller works. The tests take turns
+ *  among the ones selected with bistsched_init().
+ *
+ *  The algorithms overwrite the RAM under test. When a table entry names an
+ *  address, that much RAM is copied to a buffer before the test and written
+ *  back after it; the owner of the RAM is stopped meanwhile (HET1). The VIM
+ *  RAM is read by every interrupt, so its test runs to completion inside
+ *  bistsched_step() with IRQ and FIQ masked. So does the MibSPI1 buffer RAM,
+ *  whose test is postponed while a background transfer of usdcard.c
+ *  (usd_xfer_...) uses it.
+ *
+ *  The CPU RAM and the STC are not scheduled: both destroy the state of the
+ *  running program and can only be tested from the startup sequence.
+ *
+ *  Time stamps are BISTSCHED_TIMESTAMP() ticks, the PMU cycle counter by
+ *  default like ramscrub.h; it must be started before bistsched_init().
+ */
+
+#ifndef INCLUDE_BISTSCHED_H_
+#define INCLUDE_BISTSCHED_H_
+
+#include "hal_stdtypes.h"
+#include "sys_pmu.h"
+
+#define BISTSCHED_PERIOD			80000000U	// ticks from the end of a test to the start of the next, 1 s at 80 MHz
+#define BISTSCHED_TIMEOUT			8000000U	// ticks after which a test is stopped and counted as failed
+#define BISTSCHED_SAVE_WORDS		640U		// size of the save buffer, the largest RAM saved (HET1)
+
+#ifndef BISTSCHED_TIMESTAMP
+#define BISTSCHED_TIMESTAMP()		_pmuGetCycleCount_()
+#endif
+
+// Tests of the table, bit n of the mask given to bistsched_init() selects test n
+#define BISTSCHED_PBIST_ROM			0U
+#define BISTSCHED_STC_ROM			1U
+#define BISTSCHED_VIM_RAM			2U
+#define BISTSCHED_MIBSPI1_RAM		3U
+#define BISTSCHED_ADC1_RAM			4U
+#define BISTSCHED_CAN1_RAM			5U
+#define BISTSCHED_CAN2_RAM			6U
+#define BISTSCHED_HET1_RAM			7U
+#define BISTSCHED_HTU1_RAM			8U
+#define BISTSCHED_TESTS				9U
+
+#define BISTSCHED_ALL				((1U << BISTSCHED_TESTS) - 1U)
+
+typedef struct
+{
+	uint32 runs;			// completed runs
+	uint32 passed;
+	uint32 failed;			// timeouts included
+	uint32 timeouts;
+	uint32 last_ticks;		// duration of the last run, from pbistRun() to the completion
+	uint32 max_ticks;		// longest run
+	uint32 fail_address;	// FSRA0 of the last failure
+	uint32 fail_data;		// FSRDL0 of the last failure
+}
+bistsched_stats;
+
+/**
+ * 	@brief Selects the tests and clears the statistics.
+ *
+ *  @param tests mask of the tests to run, bit BISTSCHED_... set for each.
+ *  Tests that save more RAM than BISTSCHED_SAVE_WORDS are left out.
+ */
+void bistsched_init(uint32 tests);
+
+/**
+ * 	@brief Starts the next test when the period has elapsed, or polls the one running.
+ *
+ *  Call from the main loop, with IRQ and FIQ either both enabled or both
+ *  masked, and never while sys_startup.c or another caller uses the PBIST.
+ *
+ *  @return TRUE when the step completed a test.
+ */
+boolean bistsched_step(void);
+
+/**
+ * 	@brief Changes the ticks between two tests; 0 runs them back to back.
+ */
+void bistsched_set_period(uint32 ticks);
+
+/**
+ * 	@brief Copy the statistics of a test.
+ */
+void bistsched_get_stats(uint32 test, bistsched_stats* stats);
+
+#endif /* INCLUDE_BISTSCHED_H_ */
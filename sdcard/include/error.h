@@ -12,6 +12,10 @@
 #define USD_ERROR_READ_OCR        		0x04
 #define USD_ERROR_OLD_VERSION_NOT_CARD  0x05
 #define USD_ERROR_CARD_NOT_DETECTED     0x06
+#define USD_ERROR_CRC_ON_OFF            0x07
+#define USD_ERROR_DATA_CRC              0x08
+#define USD_ERROR_QUEUE_FULL            0x09
+#define USD_ERROR_XFER_BUSY             0x0A
 
 //#define USD_ERROR_OP_COND_TIMEOUT 				0x02
 //#define USD_ERROR_SET_BLOCKLEN_TIMEOUT 			0x03
@@ -0,0 +1,105 @@
+/*
+ * esmlog.h
+ *
+ *  Ring of ESM events.
+ *
+ *  esmGroup1Notification() and esmGroup2Notification() append a record with
+ *  esmlog_push(); the logger takes them from the main loop with esmlog_peek()
+ *  and esmlog_release(), or esmlog_pop().
+ *
+ *  The ring is single producer single consumer and lock free. In this project
+ *  the only producer is esmHighInterrupt() (FIQ), which does not nest, so the
+ *  interrupt never waits and nothing is allocated. When the ring is full the
+ *  new event is dropped and counted; the gap also shows in the sequence
+ *  numbers of the records that follow.
+ *
+ *  esmlog_encode() gives the payload of the logbin record of an event,
+ *  ESMLOG_PAYLOAD_SIZE bytes, big-endian like logbin.h:
+ *
+ *   0  timestamp (4)
+ *   4  status    (4)
+ *   8  sequence  (2)
+ *  10  group     (1)
+ *  11  channel   (1)
+ *
+ *  Time stamps are ESMLOG_TIMESTAMP() ticks, the PMU cycle counter by default,
+ *  like ramscrub.h. ESMLOG_BARRIER() orders the record and the index between
+ *  cores; it is empty for the single core target.
+ */
+
+#ifndef INCLUDE_ESMLOG_H_
+#define INCLUDE_ESMLOG_H_
+
+#include "hal_stdtypes.h"
+
+#define ESMLOG_SIZE				64U		// records in the ring, power of two
+#define ESMLOG_RECORD_TYPE		0x45	// logbin record type of an ESM event
+#define ESMLOG_PAYLOAD_SIZE		12U		// bytes written by esmlog_encode()
+
+// Sectors of the card that hold the log of ESM events (logbin.h)
+#ifndef ESMLOG_LOG_FIRST_BLOCK
+#define ESMLOG_LOG_FIRST_BLOCK	4096U
+#endif
+#ifndef ESMLOG_LOG_BLOCKS
+#define ESMLOG_LOG_BLOCKS		256U
+#endif
+
+#ifndef ESMLOG_TIMESTAMP
+#include "sys_pmu.h"
+#define ESMLOG_TIMESTAMP()		_pmuGetCycleCount_()
+#endif
+
+#ifndef ESMLOG_BARRIER
+#define ESMLOG_BARRIER()
+#endif
+
+//
+// An ESM channel event. 12 bytes.
+//
+typedef struct
+{
+	uint32 timestamp;		// ESMLOG_TIMESTAMP() in the interrupt
+	uint32 status;			// status register of the group, after the channel was cleared
+	uint16 sequence;		// counts every push, dropped ones included
+	uint8 group;			// 1 or 2
+	uint8 channel;			// 0 to 63 for group 1, 0 to 31 for group 2
+}
+esmlog_event;
+
+/**
+ * 	@brief Appends an event. Call from the producer only.
+ */
+void esmlog_push(uint8 group, uint8 channel, uint32 status);
+
+/**
+ * 	@brief Copies the oldest event without taking it. Call from the consumer only.
+ *
+ *  @return TRUE when an event was copied to *event.
+ */
+boolean esmlog_peek(esmlog_event* event);
+
+/**
+ * 	@brief Takes the oldest event, after a successful esmlog_peek().
+ */
+void esmlog_release(void);
+
+/**
+ * 	@brief Takes the oldest event. Call from the consumer only.
+ *
+ *  @return TRUE when an event was copied to *event.
+ */
+boolean esmlog_pop(esmlog_event* event);
+
+/**
+ * 	@brief Encodes an event as the payload of its logbin record.
+ *
+ *	@param payload - Receives ESMLOG_PAYLOAD_SIZE bytes.
+ */
+void esmlog_encode(const esmlog_event* event, uint8* payload);
+
+/**
+ * 	@brief Number of events dropped because the ring was full.
+ */
+uint32 esmlog_dropped(void);
+
+#endif /* INCLUDE_ESMLOG_H_ */
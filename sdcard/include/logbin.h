@@ -0,0 +1,118 @@
+/*
+ * logbin.h
+ *
+ *  Append-only binary log on the uSDCARD.
+ *
+ *  The log uses a fixed range of sectors as a ring. Every sector starts with
+ *  a header carrying the generation of the ring (incremented at each wrap),
+ *  followed by records packed back-to-back:
+ *
+ *  Sector header (16 bytes)        Record (12 bytes + payload + 2 bytes)
+ *   0  magic       (4)              0  sync 0xA5  (1)
+ *   4  generation  (4)              1  type       (1)
+ *   8  first seq   (4)              2  length     (2)
+ *  12  reserved    (2)              4  sequence   (4)
+ *  14  CRC16       (2)              8  timestamp  (4)
+ *                                  12  payload    (length)
+ *                                   .  CRC16 of header and payload (2)
+ *
+ *  All fields are big-endian. Records never cross a sector, the unused tail
+ *  of a sector is zero. Written sectors of the current generation always
+ *  form a prefix of the range, so the mount finds the tail by binary search.
+ */
+
+#ifndef INCLUDE_LOGBIN_H_
+#define INCLUDE_LOGBIN_H_
+
+#include "hal_stdtypes.h"
+
+#define LOGBIN_MAGIC				0x524C4F47U	// "RLOG"
+#define LOGBIN_SECTOR_HEADER_SIZE	16U
+#define LOGBIN_RECORD_HEADER_SIZE	12U
+#define LOGBIN_RECORD_SYNC			0xA5U
+#define LOGBIN_MAX_PAYLOAD			(512U - LOGBIN_SECTOR_HEADER_SIZE - LOGBIN_RECORD_HEADER_SIZE - 2U)
+
+#define LOGBIN_OK					0x00
+#define LOGBIN_ERROR_CARD			0x01	// the card returned an error
+#define LOGBIN_ERROR_TOO_LONG		0x02	// payload above LOGBIN_MAX_PAYLOAD
+#define LOGBIN_ERROR_NOT_MOUNTED	0x03
+
+//
+// Position of the log after logbin_mount().
+//
+typedef struct
+{
+	uint32 blkaddr_first;	// first sector of the log range
+	uint32 blocks;			// number of sectors of the range
+	uint32 generation;		// current pass over the range
+	uint32 sector;			// index (in the range) of the sector being filled
+	uint32 offset;			// first free byte of that sector
+	uint32 sequence;		// sequence number of the next record
+	uint32 mount_reads;		// sectors read by the last mount
+}
+logbin_info;
+
+//
+// A record decoded by logbin_parse_record(). payload points into the sector.
+//
+typedef struct
+{
+	uint8 type;
+	uint16 length;
+	uint32 sequence;
+	uint32 timestamp;
+	const uint8* payload;
+}
+logbin_record;
+
+/**
+ * 	@brief Locates the tail of the log and prepares to append after it.
+ *
+ *  Reads about log2(blocks) sector headers plus the last written sector, so
+ *  logging resumes right away after a reset. An empty range starts a new log;
+ *  so does an invalid sector 0, with a generation above those of sector 1 and
+ *  the last sector.
+ *
+ *	@param blkaddr_first - First sector of the log range.
+ *	@param blocks - Number of sectors of the range.
+ *
+ *  @return LOGBIN_OK, LOGBIN_ERROR_CARD
+ */
+uint8 logbin_mount(uint32 blkaddr_first, uint32 blocks);
+
+/**
+ * 	@brief Appends a record. Full sectors are written to the card at once.
+ *
+ *	@param type - Free record type.
+ *	@param timestamp - Time of the event, in the caller's time base.
+ *	@param payload - Record data.
+ *	@param length - Bytes of payload, at most LOGBIN_MAX_PAYLOAD.
+ *
+ *  @return LOGBIN_OK, LOGBIN_ERROR_CARD, LOGBIN_ERROR_TOO_LONG, LOGBIN_ERROR_NOT_MOUNTED
+ */
+uint8 logbin_append(uint8 type, uint32 timestamp, const uint8* payload, uint16 length);
+
+/**
+ * 	@brief Writes the partially filled sector, so its records survive a reset.
+ *
+ *  @return LOGBIN_OK, LOGBIN_ERROR_CARD, LOGBIN_ERROR_NOT_MOUNTED
+ */
+uint8 logbin_flush(void);
+
+/**
+ * 	@brief Decodes and checks the record at *offset of a sector.
+ *
+ *	@param sector - The 512 bytes of a log sector.
+ *	@param offset - Position of the record, moved past it on success.
+ *	@param record - Receives the decoded record.
+ *
+ *  @return TRUE when a valid record was found, FALSE at the end of the records.
+ */
+boolean logbin_parse_record(const uint8* sector, uint32* offset, logbin_record* record);
+
+/**
+ * 	@brief Copy the position of the log.
+ */
+void logbin_get_info(logbin_info* info);
+
+#endif /* INCLUDE_LOGBIN_H_ */
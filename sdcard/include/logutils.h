@@ -8,9 +8,58 @@
 #ifndef INCLUDE_LOGUTILS_H_
 #define INCLUDE_LOGUTILS_H_
 
+#include "hal_stdtypes.h"
+
+//
+// Position and counters of the packed log writer (see log_usdcard_append()).
+//
+typedef struct
+{
+	uint32 blkaddr;		// sector being filled
+	uint32 offset;		// bytes already used in that sector
+	uint32 messages;	// messages accepted
+	uint32 dropped;		// messages refused because both buffers were busy
+	uint32 lost;		// full sectors the job queue could not accept
+}
+log_usdcard_info;
+
 
 int write_usdcard(char loginfo[], int addr);
 
+/**
+ * 	@brief Starts the packed log writer at a sector of the card.
+ *
+ *	@param blkaddr - First sector used by the log.
+ */
+void log_usdcard_init(uint32 blkaddr);
+
+/**
+ * 	@brief Appends a message right after the previous one.
+ *
+ *  Messages are packed back-to-back in a sector buffer and may cross sector
+ *  boundaries. A full sector is queued with usd_job_write() and filling goes
+ *  on in the second buffer, so usd_main_function() must be called cyclically.
+ *
+ *	@param loginfo - Message, at most 512 characters.
+ *
+ *  @return 0 - Message stored.
+ *  		-1 - Message too long or both buffers still waiting for the card.
+ */
+int log_usdcard_append(const char loginfo[]);
+
+/**
+ * 	@brief Queues the partially filled sector, so nothing is lost on a reset.
+ *
+ *  The sector is written again when more messages are appended to it.
+ *
+ *  @return 0 - Sector queued or nothing to flush.
+ *  		-1 - The other buffer or the job queue is busy, try again later.
+ */
+int log_usdcard_flush(void);
 
+/**
+ * 	@brief Copy the position and counters of the log writer.
+ */
+void log_usdcard_get_info(log_usdcard_info* info);
 
 #endif /* INCLUDE_LOGUTILS_H_ */
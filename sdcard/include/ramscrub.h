@@ -0,0 +1,104 @@
+/*
+ * ramscrub.h
+ *
+ *  Background scrubber for the TCRAM.
+ *
+ *  ramscrub_step() reads the next RAMSCRUB_SLICE_WORDS 64-bit words of the
+ *  RAM, so the ECC of every word is checked once per pass. After the slice
+ *  the error registers of both TCRAM wrappers (B0TCM, B1TCM) are harvested:
+ *  a corrected word is written back with its corrected value, the flags are
+ *  cleared and an event is appended to a ring in RAM.
+ *
+ *  A pass takes RAMSCRUB_RAM_SIZE / (8 * RAMSCRUB_SLICE_WORDS) steps, so the
+ *  RAM is covered once every that many calls of ramscrub_step(). The cost of
+ *  a step is the slice plus at most one write back per wrapper.
+ *
+ *  Uncorrectable errors raise a data abort on the read and cannot be logged
+ *  by the scrubber. ramscrub_init() logs the ones still flagged after a reset.
+ *
+ *  Time stamps are RAMSCRUB_TIMESTAMP() ticks, the PMU cycle counter by
+ *  default; it must be started before ramscrub_init().
+ */
+
+#ifndef INCLUDE_RAMSCRUB_H_
+#define INCLUDE_RAMSCRUB_H_
+
+#include "hal_stdtypes.h"
+#include "sys_pmu.h"
+
+#define RAMSCRUB_RAM_START			0x08000000U
+#define RAMSCRUB_RAM_SIZE			0x00008000U		// STACKS and RAM of sys_link.cmd
+#define RAMSCRUB_SLICE_WORDS		128U			// 64-bit words read per step
+#define RAMSCRUB_LOG_SIZE			32U				// events in the ring, power of two
+
+#ifndef RAMSCRUB_TIMESTAMP
+#define RAMSCRUB_TIMESTAMP()		_pmuGetCycleCount_()
+#endif
+
+// RAMSCRUB_ECC_OFFSET: the ECC bits of a word are mapped at its address plus this offset
+#define RAMSCRUB_ECC_OFFSET			0x00400000U
+
+#define RAMSCRUB_EVENT_SINGLE		0x01	// corrected error, the word was written back
+#define RAMSCRUB_EVENT_DOUBLE		0x02	// uncorrectable error, flagged before ramscrub_init()
+#define RAMSCRUB_EVENT_OTHER		0x03	// address decode, compare logic or address parity error
+
+//
+// An error harvested from a TCRAM wrapper.
+//
+typedef struct
+{
+	uint32 timestamp;		// RAMSCRUB_TIMESTAMP() at the harvest
+	uint32 address;			// 64-bit word, from RAMSERRADDR or RAMUERRADDR
+	uint32 status;			// RAMERRSTATUS
+	uint16 count;			// RAMOCCUR, errors counted since the last harvest
+	uint8 type;				// RAMSCRUB_EVENT_...
+	uint8 wrapper;			// 0 = B0TCM, 1 = B1TCM
+}
+ramscrub_event;
+
+typedef struct
+{
+	uint32 passes;			// completed passes over the RAM
+	uint32 pass_ticks;		// duration of the last pass
+	uint32 slice_ticks_max;	// longest step
+	uint32 single;			// corrected errors
+	uint32 double_bit;		// uncorrectable errors
+	uint32 other;			// other errors
+	uint32 dropped;			// events lost to a full ring
+}
+ramscrub_stats;
+
+/**
+ * 	@brief Starts a pass at the start of the RAM and clears the log.
+ *
+ *  Sets the single-bit error threshold of both wrappers to 1, so that every
+ *  corrected error is flagged, and logs the errors still flagged.
+ */
+void ramscrub_init(void);
+
+/**
+ * 	@brief Reads the next slice and harvests the error registers.
+ *
+ *  Call from the main loop or an RTI tick, with IRQ and FIQ either both
+ *  enabled or both masked; the write back masks them for one word.
+ *
+ *  @return TRUE when the step completed a pass.
+ */
+boolean ramscrub_step(void);
+
+/**
+ * 	@brief Takes the oldest event from the log.
+ *
+ *  The log is a single producer single consumer ring: the consumer may run
+ *  in another context than ramscrub_step().
+ *
+ *  @return TRUE when an event was copied to *event.
+ */
+boolean ramscrub_read_event(ramscrub_event* event);
+
+/**
+ * 	@brief Copy the statistics of the scrubber.
+ */
+void ramscrub_get_stats(ramscrub_stats* stats);
+
+#endif /* INCLUDE_RAMSCRUB_H_ */
@@ -21,8 +21,79 @@ typedef struct
 }
 cmd_rsp_lkup;
 
+//
+// SPI driver calls issued by the card functions. calls / sectors gives the
+// number of SPI transfers needed per 512 byte sector.
+//
+typedef struct
+{
+	uint32 calls;	// spiTransmitData/spiReceiveData calls
+	uint32 words;	// words moved by those calls
+	uint32 sectors;	// sectors written or read
+	uint32 crc_errors;	// data blocks received with a wrong CRC16
+}
+usd_spi_counters;
+
+//
+// Activity of the background sector transfers. Every busy poll is a call to
+// usd_xfer_service() that returned at once because the hardware was shifting
+// or the card was still busy.
+//
+typedef struct
+{
+	uint32 chunks;		// buffer RAM chunks started
+	uint32 busy_polls;	// service calls that found the transfer in progress
+}
+usd_xfer_counters;
+
 #define USD_CDM_SIZE 6U
 
+//
+// Data tokens used in the data phase of the read/write commands
+//
+#define USD_TOKEN_START_BLOCK		0x00FE	// CMD17/CMD18/CMD24
+#define USD_TOKEN_START_MULTI_WRITE	0x00FC	// CMD25, one per block
+#define USD_TOKEN_STOP_TRAN			0x00FD	// CMD25, ends the transaction
+
+//
+// If TRUE, usd_write_blocks() sends ACMD23 before CMD25 so the card can
+// pre-erase the whole range and program the blocks faster.
+//
+#define USD_MULTI_WRITE_PRE_ERASE	TRUE
+
+//
+// If TRUE, usd_init() sends CMD59 so the card checks the CRC of every
+// command and data block it receives.
+//
+#define USD_CRC_MODE				FALSE
+
+//
+// If TRUE, the data blocks are sent with their CRC16 and the CRC16 of the
+// received blocks is checked (see usdcard_crc.h). Required by USD_CRC_MODE.
+//
+#define USD_DATA_CRC				FALSE
+
+#if USD_CRC_MODE && !USD_DATA_CRC
+#error "USD_CRC_MODE requires USD_DATA_CRC, the card would reject the dummy data CRC"
+#endif
+
+//
+// Background sector transfers (usd_xfer_*) shift the data phase through the
+// MibSPI1 buffer RAM in chunks of this many bytes (at most 128).
+//
+#define USD_XFER_CHUNK				128U
+
+#define USD_XFER_IDLE				0x00
+#define USD_XFER_BUSY				0x01
+#define USD_XFER_DONE				0x02
+#define USD_XFER_ERROR				0x03
+
+//
+// Number of sectors fetched by one CMD18 when usd_read_block_cached() misses.
+// The window is byte-packed, each sector costs 512 bytes of RAM.
+//
+#define USD_READ_AHEAD_BLOCKS		4U
+
 //
 //
 //
@@ -38,16 +109,23 @@ cmd_rsp_lkup;
 #define USD_CMD0_GO_IDLE_STATE      		 0x00
 #define USD_CMD1_SEND_OP_COND       		 0x01
 #define USD_CMD8_SEND_IF_COND				 0x08
+#define USD_CMD9_SEND_CSD					 0x09
+#define USD_CMD10_SEND_CID					 0x0A
+#define USD_CMD12_STOP_TRANSMISSION			 0x0C
 #define USD_CMD13_SEND_STATUS       		 0x0D
 #define USD_CMD16_SET_BLOCKLEN      		 0x10
 #define USD_CMD17_READ_SINGLE_BLOCK 		 0x11
+#define USD_CMD18_READ_MULTIPLE_BLOCK		 0x12
 #define USD_CMD24_WRITE_BLOCK       		 0x18
+#define USD_CMD25_WRITE_MULTIPLE_BLOCK		 0x19
 #define USD_CMD32_ERASE_WR_BLK_START_ADDRESS 0x20
 #define USD_CMD33_ERASE_WR_BLK_END_ADDRESS   0x21
 #define USD_CMD38_ERASE 					 0x26
+#define USD_ACMD23_SET_WR_BLK_ERASE_COUNT	 0x17
 #define USD_ACMD41_SD_SEND_OP_COND			 0x29
 #define USD_CMD55_APP_CMD					 0x37
 #define USD_CMD58_READ_OCR        			 0x3A
+#define USD_CMD59_CRC_ON_OFF				 0x3B
 
 /**
  * 	@brief Initialize the uSDCARD sending the correct command sequence and indetify its type
@@ -62,6 +140,8 @@ cmd_rsp_lkup;
  *  		USD_ERROR_SD_SEND_OP_COND -
  *  		USD_ERROR_READ_OCR -
  *  		USD_OLD_VERSION_NOT_CARD -
+ *  		USD_ERROR_CRC_ON_OFF -
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
  */
 uint8 usd_init();
 
@@ -73,9 +153,46 @@ uint8 usd_init();
  *
  *  @return SUCCESS -
  *  		USD_ERROR_WRITE -
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
  */
 uint8 usd_write_block(uint16* data, uint32 blkaddr);
 
+/**
+ * 	@brief Same as usd_write_block() for a byte-packed buffer.
+ *
+ *  The sector only takes 512 bytes of RAM instead of 1 KB, the bytes are
+ *  widened to SPI words while they are shifted out.
+ *
+ *	@param data: An array of 512 bytes.
+ *	@param blkaddr - An integer identifying the sector to be written.
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_WRITE -
+ */
+uint8 usd_write_block8(const uint8* data, uint32 blkaddr);
+
+/**
+ * 	@brief Write count consecutive sectors in a single CMD25 transaction.
+ *
+ *  The card stays selected for the whole transfer and each block is only
+ *  preceded by its data token, so the command and chip-select overhead of
+ *  usd_write_block() is paid once per call instead of once per sector.
+ *
+ *	@param data: An array of data with count * 512 bytes.
+ *	@param blkaddr_start - An integer identifying the first sector to be written.
+ *	@param count - Number of sectors to be written.
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_WRITE -
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
+ */
+uint8 usd_write_blocks(uint16* data, uint32 blkaddr_start, uint32 count);
+
+/**
+ * 	@brief Same as usd_write_blocks() for a byte-packed buffer of count * 512 bytes.
+ */
+uint8 usd_write_blocks8(const uint8* data, uint32 blkaddr_start, uint32 count);
+
 /**
  * 	@brief Reads a buffer with 512 bytes from a sector.
  *
@@ -84,9 +201,63 @@ uint8 usd_write_block(uint16* data, uint32 blkaddr);
  *
  *  @return SUCCESS -
  *  		USD_ERROR_READ -
+ *  		USD_ERROR_DATA_CRC - The block was read but its CRC16 does not match.
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
  */
 uint8 usd_read_block(uint16* data, uint32 blkaddr);
 
+/**
+ * 	@brief Same as usd_read_block() for a byte-packed buffer of 512 bytes.
+ */
+uint8 usd_read_block8(uint8* data, uint32 blkaddr);
+
+/**
+ * 	@brief Reads count consecutive sectors in a single CMD18 transaction.
+ *
+ *	@param data: A pointer to an array of count * 512 bytes to store the reading.
+ *	@param blkaddr_start - An integer identifying the first sector to be read.
+ *	@param count - Number of sectors to be read.
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_READ -
+ *  		USD_ERROR_DATA_CRC - At least one block does not match its CRC16.
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
+ */
+uint8 usd_read_blocks(uint16* data, uint32 blkaddr_start, uint32 count);
+
+/**
+ * 	@brief Same as usd_read_blocks() for a byte-packed buffer of count * 512 bytes.
+ */
+uint8 usd_read_blocks8(uint8* data, uint32 blkaddr_start, uint32 count);
+
+/**
+ * 	@brief Reads a sector through the read-ahead window.
+ *
+ *  On a miss the window is refilled with USD_READ_AHEAD_BLOCKS sectors
+ *  starting at blkaddr, so sequential dumps only issue one CMD18 per window.
+ *
+ *	@param data: A pointer to an array of bytes to store the reading.
+ *	@param blkaddr - An integer identifying the sector to be read.
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_READ -
+ */
+uint8 usd_read_block_cached(uint16* data, uint32 blkaddr);
+
+/**
+ * 	@brief Same as usd_read_block_cached() for a byte-packed buffer of 512 bytes.
+ */
+uint8 usd_read_block8_cached(uint8* data, uint32 blkaddr);
+
+/**
+ * 	@brief Drops the content of the read-ahead window.
+ *
+ *  Called by the write and erase functions, so the window never returns stale data.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_read_cache_invalidate(void);
+
 /**
  * 	@brief Reads a buffer with 512 bytes from a sector.
  *
@@ -95,9 +266,84 @@ uint8 usd_read_block(uint16* data, uint32 blkaddr);
  *
  *  @return SUCCESS -
  *  		USD_ERROR_READ -
+ *  		USD_ERROR_XFER_BUSY - A background transfer (usd_xfer_...) is running.
  */
 uint8 usd_erase_blocks(uint32 blkaddr_start, uint32 blkaddr_stop);
 
+/**
+ * 	@brief Starts writing a sector in the background.
+ *
+ *  The command and data token are sent at once, then the 512 data bytes are
+ *  shifted by the MibSPI1 buffer RAM while the CPU runs other code. The
+ *  transfer advances in usd_xfer_service(), data must stay valid until it ends.
+ *
+ *	@param data: A byte-packed array of 512 bytes.
+ *	@param blkaddr - An integer identifying the sector to be written.
+ *
+ *  @return SUCCESS - Transfer started.
+ *  		1 - A transfer is already running or the card rejected the command.
+ */
+uint8 usd_xfer_write_start(const uint8* data, uint32 blkaddr);
+
+/**
+ * 	@brief Starts reading a sector in the background.
+ *
+ *	@param data: A byte-packed array of 512 bytes to store the reading.
+ *	@param blkaddr - An integer identifying the sector to be read.
+ *
+ *  @return SUCCESS - Transfer started.
+ *  		1 - A transfer is already running or the card did not answer.
+ */
+uint8 usd_xfer_read_start(uint8* data, uint32 blkaddr);
+
+/**
+ * 	@brief Starts erasing a range of sectors in the background.
+ *
+ *  The erase commands are sent at once, the card busy state is then polled
+ *  by usd_xfer_service().
+ *
+ *	@param blkaddr_start - First sector of the range.
+ *	@param blkaddr_stop - Last sector of the range.
+ *
+ *  @return SUCCESS - Erase started.
+ *  		1 - A transfer is already running or the card rejected a command.
+ */
+uint8 usd_xfer_erase_start(uint32 blkaddr_start, uint32 blkaddr_stop);
+
+/**
+ * 	@brief Advances the background transfer, to be called from the main loop.
+ *
+ *  Each call does a bounded amount of work: one chunk of buffer RAM or one
+ *  poll of the card busy state. When the card is ready again
+ *  spiEndNotification(spiREG1) is called.
+ *
+ *  @return USD_XFER_IDLE, USD_XFER_BUSY, USD_XFER_DONE or USD_XFER_ERROR.
+ */
+uint8 usd_xfer_service(void);
+
+/**
+ * 	@brief Returns the state of the background transfer without advancing it.
+ *
+ *  @return USD_XFER_IDLE, USD_XFER_BUSY, USD_XFER_DONE or USD_XFER_ERROR.
+ */
+uint8 usd_xfer_status(void);
+
+/**
+ * 	@brief Copy the background transfer counters accumulated since the last reset.
+ *
+ *	@param counters: Structure that receives the counters.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_get_xfer_counters(usd_xfer_counters* counters);
+
+/**
+ * 	@brief Clears the background transfer counters.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_reset_xfer_counters(void);
+
 /**
  * 	@brief Enable the Chip Select (CS0) in SPI1 module to activate the uSDCARD.
  *
@@ -114,4 +360,20 @@ void usd_spi_disable_card(void);
 
 uint16 usd_send_command(uint8 command, uint32 argument);
 uint32 usd_check_card_presence(void);
+
+/**
+ * 	@brief Copy the SPI transfer counters accumulated since the last reset.
+ *
+ *	@param counters: Structure that receives the counters.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_get_spi_counters(usd_spi_counters* counters);
+
+/**
+ * 	@brief Clears the SPI transfer counters.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_reset_spi_counters(void);
 #endif /* CONASAT_INCLUDE_USDCARD_H_ */
@@ -0,0 +1,48 @@
+/*
+ * usdcard_crc.h
+ *
+ *  CRC16-CCITT of the data blocks exchanged with the uSDCARD.
+ */
+
+#include "hal_stdtypes.h"
+
+#ifndef CONASAT_INCLUDE_USDCARD_CRC_H_
+#define CONASAT_INCLUDE_USDCARD_CRC_H_
+
+/**
+ * 	@brief CRC16-CCITT (x^16 + x^12 + x^5 + 1, initial value 0) used by the card
+ *  to protect the data blocks.
+ *
+ *  Slice-by-4 kernel: four bytes are folded into the CRC with four table
+ *  lookups, the remaining bytes are processed one at a time.
+ *
+ *	@param data: An array with one byte per element, as used by the SPI driver.
+ *	@param length - Number of bytes.
+ *
+ *  @return The CRC of the bytes.
+ */
+uint16 usd_crc16(const uint16* data, uint32 length);
+
+/**
+ * 	@brief Same as usd_crc16() for a byte-packed buffer.
+ *
+ *	@param data: An array of bytes.
+ *	@param length - Number of bytes.
+ *
+ *  @return The CRC of the bytes.
+ */
+uint16 usd_crc16_8(const uint8* data, uint32 length);
+
+/**
+ * 	@brief Same CRC as usd_crc16(), one byte and one table lookup per step.
+ *
+ *  Reference implementation, kept to check and benchmark the fast kernel.
+ *
+ *	@param data: An array with one byte per element, as used by the SPI driver.
+ *	@param length - Number of bytes.
+ *
+ *  @return The CRC of the bytes.
+ */
+uint16 usd_crc16_bytewise(const uint16* data, uint32 length);
+
+#endif /* CONASAT_INCLUDE_USDCARD_CRC_H_ */
@@ -0,0 +1,88 @@
+/*
+ * usdcard_jobs.h
+ *
+ *  Asynchronous uSDCARD jobs, in the style of the TI FEE driver: jobs are
+ *  queued by the request functions and advanced by usd_main_function().
+ */
+
+#include "hal_stdtypes.h"
+
+#ifndef CONASAT_INCLUDE_USDCARD_JOBS_H_
+#define CONASAT_INCLUDE_USDCARD_JOBS_H_
+
+//
+// Maximum number of jobs waiting in the queue.
+//
+#define USD_JOB_QUEUE_SIZE	4U
+
+//
+// Module status (see usd_get_status()).
+//
+#define USD_IDLE			0x00
+#define USD_BUSY			0x01
+
+//
+// Job results, same meaning as JOB_OK/JOB_FAILED/JOB_PENDING of the FEE.
+//
+#define USD_JOB_OK			0x00
+#define USD_JOB_FAILED		0x01
+#define USD_JOB_PENDING		0x02
+
+/**
+ * 	@brief Queues the reading of a sector.
+ *
+ *	@param data: A byte-packed array of 512 bytes to store the reading.
+ *	@param blkaddr - An integer identifying the sector to be read.
+ *	@param result - Optional (may be NULL), set to USD_JOB_PENDING now and to
+ *					USD_JOB_OK or USD_JOB_FAILED when the job ends.
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_QUEUE_FULL -
+ */
+uint8 usd_job_read(uint8* data, uint32 blkaddr, volatile uint8* result);
+
+/**
+ * 	@brief Queues the writing of a sector. data must stay valid until the job ends.
+ *
+ *	@param data: A byte-packed array of 512 bytes.
+ *	@param blkaddr - An integer identifying the sector to be written.
+ *	@param result - Optional (may be NULL), see usd_job_read().
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_QUEUE_FULL -
+ */
+uint8 usd_job_write(const uint8* data, uint32 blkaddr, volatile uint8* result);
+
+/**
+ * 	@brief Queues the erasing of a range of sectors.
+ *
+ *	@param blkaddr_start - First sector of the range.
+ *	@param blkaddr_stop - Last sector of the range.
+ *	@param result - Optional (may be NULL), see usd_job_read().
+ *
+ *  @return SUCCESS -
+ *  		USD_ERROR_QUEUE_FULL -
+ */
+uint8 usd_job_erase(uint32 blkaddr_start, uint32 blkaddr_stop, volatile uint8* result);
+
+/**
+ * 	@brief Advances the queued jobs, to be called cyclically from the main loop.
+ *
+ *  Never waits for the card: each call does one step of the current job.
+ *  While jobs are pending the blocking usd_* functions must not be used.
+ *
+ *  @return This function returns nothing.
+ */
+void usd_main_function(void);
+
+/**
+ * 	@brief Returns USD_BUSY while a job is running or queued, USD_IDLE otherwise.
+ */
+uint8 usd_get_status(void);
+
+/**
+ * 	@brief Returns the result of the last job that ended.
+ */
+uint8 usd_get_job_result(void);
+
+#endif /* CONASAT_INCLUDE_USDCARD_JOBS_H_ */
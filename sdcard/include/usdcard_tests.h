@@ -1,6 +1,11 @@
 #ifndef INCLUDE_USDCARD_TESTS_H_
 #define INCLUDE_USDCARD_TESTS_H_
 
+#include "hal_stdtypes.h"
+
+// Number of sectors moved by the multi-block tests and benchmarks
+#define USD_TEST_MULTI_BLOCKS 4U
+
 uint8 usd_test_one_write_one_read_same_block();
 uint8 usd_test_two_read_same_block();
 uint8 usd_test_two_write_and_read_same_block();
@@ -9,6 +14,21 @@ uint8 usd_test_read_after_erase();
 uint8 usd_test_write_erase_read();
 uint8 usd_test_erase_two_continuous_blocks();
 uint8 usd_test_erase_two_blocks();
+uint8 usd_test_write_blocks_and_read();
+uint8 usd_test_read_blocks_and_cached();
+uint8 usd_test_crc16_known_value();
+uint8 usd_test_packed_write_read();
+uint8 usd_test_xfer_write_read();
+uint8 usd_test_jobs_write_read_erase();
+uint8 usd_test_logbin_mount_resume();
+uint8 usd_test_ramscrub_single_bit();
+uint8 usd_test_bistsched_restore();
+uint8 usd_bench_write_single_vs_multi(uint32* single_kbps, uint32* multi_kbps);
+uint8 usd_bench_read_single_vs_multi(uint32* single_kbps, uint32* multi_kbps);
+uint8 usd_bench_spi_calls_per_sector(uint32* write_calls, uint32* read_calls);
+void usd_bench_crc16_cycles(uint32* bytewise_cycles, uint32* slice4_cycles);
+void usd_bench_telemetry_cycles(uint32* record_cycles, uint32* printf_cycles);
+uint8 usd_bench_xfer_overlap(uint32* blocking_cycles, uint32* xfer_cycles, uint32* free_polls);
 int usd_unit_tests();
 
 #endif /* INCLUDE_USDCARD_TESTS_H_ */
@@ -0,0 +1,147 @@
+/*
+ * usdcard_sim.h
+ *
+ *  Host model of the SD card on SPI1, to run usdcard.c on a PC.
+ *
+ *  usdcard.c is built unchanged against the model. This header is forced into
+ *  every file of the host build with -include, so it takes the register
+ *  frames of reg_spi.h and reg_mibspi.h before usdcard.c sees them:
+ *
+ *  - spiREG1 and mibspiREG1 are one register frame in host memory, like the
+ *    device where SPI1 and MibSPI1 are the same module. mibspiRAM1 is the
+ *    buffer RAM of MibSPI1.
+ *  - Every use of those pointers calls the model first, which reacts to what
+ *    the driver wrote since the previous access: a word written to DAT1 is
+ *    shifted to the card and its answer is in BUF with RXINT set in FLG, and
+ *    a transfer group enabled in TGCTRL starts shifting its buffers.
+ *  - spiTransmitData(), spiReceiveData(), gioSetBit(), gioGetBit() and
+ *    spiEndNotification() are provided by the model instead of spi.c, gio.c
+ *    and notification.c. Pin 0 of spiPORT1 is the chip select of the card,
+ *    pin 24 of hetPORT1 the card detect switch.
+ *
+ *  Time is virtual and runs are deterministic. Every byte on the bus costs
+ *  8 SPI clocks, every spiTransmitData()/spiReceiveData() call costs
+ *  usd_sim_config.call_ns of CPU time, and the host adds the time spent
+ *  outside the driver with usd_sim_advance_ns(). The card answers after its
+ *  access and busy times as the bus is clocked, like a real card polled by
+ *  the driver.
+ *
+ *  The card is an SDHC card in SPI mode with USD_SIM_BLOCKS sectors: CMD0,
+ *  CMD8, CMD55/ACMD41, CMD58, CMD59, CMD16, CMD17, CMD18, CMD12, CMD24,
+ *  CMD25 with ACMD23, CMD32, CMD33 and CMD38. Other commands are answered
+ *  with "illegal command". Command CRC7 is not checked; data CRC16 is sent
+ *  with every block and checked on writes after CMD59 turned it on.
+ *
+ *  MibSPI1 model: transfer group 0 only, from the start buffer of TGCTRL[0]
+ *  to the start buffer of TGCTRL[1] (bits 15-8, so 128 is the end of the
+ *  RAM). It starts when TGCTRL[0] bit 31 goes from 0 to 1 with MIBSPIE set,
+ *  takes 8 SPI clocks per buffer and then sets bit 16 of TGINTFLG. The flag
+ *  is cleared when the group is triggered again, as usdcard.c clears it
+ *  right before; a write of 1 to the flag cannot be seen by the model.
+ */
+
+#ifndef SIM_INCLUDE_USDCARD_SIM_H_
+#define SIM_INCLUDE_USDCARD_SIM_H_
+
+#include "hal_stdtypes.h"
+#include "reg_spi.h"
+#include "reg_mibspi.h"
+#include "reg_het.h"
+#include "gio.h"
+
+#define USD_SIM_BLOCKS			256U	// sectors of the simulated card
+
+typedef struct
+{
+	uint32 spi_hz;			// SPI1 bit clock
+	uint32 call_ns;			// CPU time of one spiTransmitData()/spiReceiveData() call
+	uint32 read_access_ns;	// CMD17/CMD18: command to first data token
+	uint32 read_gap_ns;		// CMD18: end of a block to the next data token
+	uint32 write_busy_ns;	// CMD24: busy after the data response
+	uint32 multi_busy_ns;	// CMD25: busy after the data response of each block
+	uint32 stop_busy_ns;	// CMD25: busy after the Stop Tran token
+	uint32 erase_busy_ns;	// CMD38: busy after the response
+}
+usd_sim_config;
+
+//
+// What the card and the MibSPI1 model saw since usd_sim_reset().
+//
+typedef struct
+{
+	uint32 bytes;			// bytes clocked on the bus with the card selected
+	uint32 commands;		// command frames received
+	uint32 blocks_written;	// data blocks accepted
+	uint32 blocks_read;		// data blocks sent
+	uint32 busy_bytes;		// 0x00 busy bytes sent
+	uint32 crc_errors;		// data blocks rejected for a wrong CRC16
+	uint32 tg_chunks;		// transfer group 0 runs
+	uint32 notifications;	// spiEndNotification() calls
+}
+usd_sim_counters;
+
+#define USD_SIM_CHUNK_LOG		16U	// transfer group runs kept by the chunk log
+
+//
+// One transfer group run as the card saw it: the sector and the position of
+// the first byte of the run in the data block.
+//
+typedef struct
+{
+	uint32 block;
+	uint32 offset;
+}
+usd_sim_chunk;
+
+/**
+ * 	@brief Powers the card on with config, or with the default timing for NULL.
+ *
+ *  The card content is set to 0xA5, the time, the counters and the chunk log
+ *  start at 0.
+ */
+void usd_sim_reset(const usd_sim_config* config);
+
+/**
+ * 	@brief Default timing of the model: 20 MHz SPI clock and the access and
+ *  busy times of a typical class 10 card.
+ */
+void usd_sim_default_config(usd_sim_config* config);
+
+uint64 usd_sim_now_ns(void);
+void usd_sim_advance_ns(uint32 ns);
+void usd_sim_get_counters(usd_sim_counters* counters);
+
+/**
+ * 	@brief Content of a sector of the card, USD_SIM_BLOCKS sectors of 512 bytes.
+ */
+uint8* usd_sim_block(uint32 blkaddr);
+
+/**
+ * 	@brief Transfer group runs since usd_sim_reset(), oldest first.
+ *
+ *	@param log: Receives the first USD_SIM_CHUNK_LOG runs.
+ *
+ *  @return The number of runs, which can be larger than USD_SIM_CHUNK_LOG.
+ */
+uint32 usd_sim_get_chunks(usd_sim_chunk* log);
+
+// Access to the register frames, see above
+spiBASE_t* usd_sim_spi1(void);
+mibspiBASE_t* usd_sim_mibspi1(void);
+mibspiRAM_t* usd_sim_mibspi1_ram(void);
+
+extern gioPORT_t usd_sim_spi_port;
+extern gioPORT_t usd_sim_het_port;
+
+#undef spiREG1
+#define spiREG1 (usd_sim_spi1())
+#undef mibspiREG1
+#define mibspiREG1 (usd_sim_mibspi1())
+#undef mibspiRAM1
+#define mibspiRAM1 (usd_sim_mibspi1_ram())
+#undef spiPORT1
+#define spiPORT1 (&usd_sim_spi_port)
+#undef hetPORT1
+#define hetPORT1 (&usd_sim_het_port)
+
+#endif /* SIM_INCLUDE_USDCARD_SIM_H_ */
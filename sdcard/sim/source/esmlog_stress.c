@@ -0,0 +1,166 @@
+/**
+ *	\file esmlog_stress.c
+ *	\brief Host stress test of the ESM event ring (esmlog.c).
+ *
+ *	A producer thread stands in for esmHighInterrupt() and pushes events as
+ *	fast as it can while the consumer thread drains them like the main loop.
+ *	Build and run from the sdcard directory:
+ *
+ *	gcc -std=c99 -O2 -pthread -Iinclude -D'ESMLOG_TIMESTAMP()=0U'
+ *	    -D'ESMLOG_BARRIER()=__sync_synchronize()' sim/source/esmlog_stress.c
+ *	    source/esmlog.c -o esmlog_stress
+ *
+ *	esmlog_stress [events]
+ *
+ *	1. Bursts: the producer pushes ESMLOG_SIZE events, then waits until all
+ *	   of them are taken. No event may be dropped.
+ *	2. Flood: the producer never waits. Every event has to be either taken or
+ *	   counted as dropped, and the taken ones have to arrive complete and in
+ *	   order, with sequence gaps that add up to the drops.
+ *
+ *	Both threads yield while they wait, so the test also runs on one core.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+#include "esmlog.h"
+
+#define ESMLOG_STRESS_DEFAULT_EVENTS	1000000U
+
+static uint32 esmlog_stress_events;
+static volatile boolean esmlog_stress_bursts;
+static volatile boolean esmlog_stress_done;
+static volatile uint32 esmlog_stress_taken;
+
+// Result of a run, written by the consumer
+static uint32 esmlog_stress_gaps;
+static uint32 esmlog_stress_bad;
+
+static uint64 esmlog_stress_now_ns(void)
+{
+	struct timespec now;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64) now.tv_sec * 1000000000U) + (uint64) now.tv_nsec;
+}
+
+//
+// Event number i of a run: the status carries i, the other fields follow from it.
+//
+static void esmlog_stress_push(uint32 i)
+{
+	esmlog_push((uint8) ((i & 1U) + 1U), (uint8) ((i >> 1) & 0x1FU), i);
+}
+
+static boolean esmlog_stress_valid(const esmlog_event* event)
+{
+	uint32 i = event->status;
+
+	return (boolean) (event->group == (uint8) ((i & 1U) + 1U) &&
+					  event->channel == (uint8) ((i >> 1) & 0x1FU) &&
+					  event->sequence == (uint16) i);
+}
+
+static void* esmlog_stress_producer(void* arg)
+{
+	uint32 i;
+
+	(void) arg;
+	for (i = 0; i < esmlog_stress_events; i++)
+	{
+		esmlog_stress_push(i);
+		if (esmlog_stress_bursts && ((i + 1U) % ESMLOG_SIZE) == 0U)
+		{
+			while (esmlog_stress_taken != i + 1U)
+			{
+				(void) sched_yield();
+			}
+		}
+	}
+	esmlog_stress_done = TRUE;
+
+	return NULL;
+}
+
+static void* esmlog_stress_consumer(void* arg)
+{
+	esmlog_event event;
+	uint32 next = 0;
+	boolean more = TRUE;
+
+	(void) arg;
+	while (more)
+	{
+		// The last events may land between the empty ring and the done flag
+		more = !esmlog_stress_done;
+		while (esmlog_pop(&event))
+		{
+			if (!esmlog_stress_valid(&event) || event.status < next)
+			{
+				esmlog_stress_bad++;
+			}
+			else
+			{
+				esmlog_stress_gaps += event.status - next;
+				next = event.status + 1U;
+			}
+			esmlog_stress_taken++;
+			more = TRUE;
+		}
+		(void) sched_yield();
+	}
+	// Drops at the end leave no gap behind
+	esmlog_stress_gaps += esmlog_stress_events - next;
+
+	return NULL;
+}
+
+static int esmlog_stress_run(const char* name, boolean bursts)
+{
+	pthread_t producer, consumer;
+	uint32 dropped = esmlog_dropped();
+	uint32 taken;
+	uint64 ns;
+
+	esmlog_stress_bursts = bursts;
+	esmlog_stress_done = FALSE;
+	esmlog_stress_taken = 0;
+	esmlog_stress_gaps = 0;
+	esmlog_stress_bad = 0;
+
+	ns = esmlog_stress_now_ns();
+	(void) pthread_create(&consumer, NULL, esmlog_stress_consumer, NULL);
+	(void) pthread_create(&producer, NULL, esmlog_stress_producer, NULL);
+	(void) pthread_join(producer, NULL);
+	(void) pthread_join(consumer, NULL);
+	ns = esmlog_stress_now_ns() - ns;
+
+	dropped = esmlog_dropped() - dropped;
+	taken = esmlog_stress_taken;
+	(void) printf("%-6s %lu events  %lu taken  %lu dropped  %lu corrupt  %lu ns/event  %s\n", name,
+				  (unsigned long) esmlog_stress_events, (unsigned long) taken, (unsigned long) dropped,
+				  (unsigned long) esmlog_stress_bad, (unsigned long) (ns / esmlog_stress_events),
+				  (taken + dropped == esmlog_stress_events && esmlog_stress_gaps == dropped &&
+				   esmlog_stress_bad == 0 && (!bursts || dropped == 0)) ? "ok" : "FAILED");
+
+	return (taken + dropped == esmlog_stress_events && esmlog_stress_gaps == dropped &&
+			esmlog_stress_bad == 0 && (!bursts || dropped == 0)) ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	int failed = 0;
+
+	esmlog_stress_events = (argc > 1) ? (uint32) strtoul(argv[1], NULL, 0) : ESMLOG_STRESS_DEFAULT_EVENTS;
+	// Sequence numbers are 16 bits: runs start at a multiple of 65536 events
+	esmlog_stress_events = (esmlog_stress_events + 0xFFFFU) & ~0xFFFFU;
+
+	failed += esmlog_stress_run("bursts", TRUE);
+	failed += esmlog_stress_run("flood", FALSE);
+
+	return failed;
+}
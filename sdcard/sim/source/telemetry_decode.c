@@ -0,0 +1,217 @@
+/**
+ *	\file telemetry_decode.c
+ *	\brief Host decoder of the binary telemetry records (telemetry.c).
+ *
+ *	A host program with its own main(): sdcard/.cproject excludes sim/ from the
+ *	CCS build. Build from the sdcard directory; telemetry.c is the same in the
+ *	three projects:
+ *
+ *	gcc -std=c99 -O2 -Iinclude -D'TELEMETRY_TIMESTAMP()=0U' sim/source/telemetry_decode.c
+ *	    source/telemetry.c -o telemetry_decode
+ *
+ *	telemetry_decode [file]
+ *		Prints one line per record of the capture (default stdin). Bytes that
+ *		are not a valid record are skipped until the next one, and sequence gaps
+ *		are counted per source.
+ *
+ *	telemetry_decode -b [records]
+ *		Compares the cost of telemetry_encode() with the printf formatting the
+ *		sys_main.c files used for the same information, then checks that every
+ *		record decodes back and that a flipped bit is rejected.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "telemetry.h"
+
+#define TELEMETRY_DECODE_BENCH_RECORDS	1000000U
+
+static const char* const telemetry_decode_types[] =
+{
+	"?", "FLASH_PROGRAM", "FAPI_STATUS", "ESM_EVENT", "ECC_ERROR", "FEE_JOB", "SD_ERROR"
+};
+
+static const char* const telemetry_decode_sources[] =
+{
+	"?", "FEE", "EEPROM", "SDCARD"
+};
+
+static void telemetry_decode_print(const telemetry_record* record)
+{
+	const char* type = (record->type <= TELEMETRY_SD_ERROR) ? telemetry_decode_types[record->type] : "?";
+	const char* source = (record->source <= TELEMETRY_SOURCE_SDCARD) ? telemetry_decode_sources[record->source] : "?";
+	unsigned hi = (unsigned) (record->detail >> 8);
+	unsigned lo = (unsigned) (record->detail & 0xFFU);
+
+	(void) printf("%-6s %3u %10lu %-13s ", source, (unsigned) record->sequence, (unsigned long) record->timestamp, type);
+	switch (record->type)
+	{
+		case TELEMETRY_FLASH_PROGRAM:
+			(void) printf("address 0x%08lX bytes %u status %u\n", (unsigned long) record->value, hi, lo);
+			break;
+		case TELEMETRY_FAPI_STATUS:
+			(void) printf("call %u status %u fsm 0x%08lX\n", hi, lo, (unsigned long) record->value);
+			break;
+		case TELEMETRY_ESM_EVENT:
+			(void) printf("group %u channel %u status 0x%08lX\n", hi, lo, (unsigned long) record->value);
+			break;
+		case TELEMETRY_ECC_ERROR:
+			(void) printf("kind %u address 0x%08lX errors %u\n", hi, (unsigned long) record->value, lo);
+			break;
+		case TELEMETRY_FEE_JOB:
+			(void) printf("job %u block %lu result %u\n", hi, (unsigned long) record->value, lo);
+			break;
+		case TELEMETRY_SD_ERROR:
+			(void) printf("operation %u sector %lu error %u\n", hi, (unsigned long) record->value, lo);
+			break;
+		default:
+			(void) printf("value 0x%08lX detail 0x%04X\n", (unsigned long) record->value, (unsigned) record->detail);
+			break;
+	}
+}
+
+static int telemetry_decode_stream(FILE* in)
+{
+	uint8 window[TELEMETRY_RECORD_SIZE];
+	uint32 filled = 0;
+	uint32 records = 0, skipped = 0, gaps = 0;
+	int next[256];
+	telemetry_record record;
+	int c;
+
+	for (c = 0; c < 256; c++)
+	{
+		next[c] = -1;
+	}
+
+	while ((c = fgetc(in)) != EOF)
+	{
+		window[filled++] = (uint8) c;
+		if (filled < TELEMETRY_RECORD_SIZE)
+		{
+			continue;
+		}
+
+		if (telemetry_decode(window, &record))
+		{
+			if (next[record.source] >= 0)
+			{
+				gaps += (uint32) ((record.sequence - next[record.source]) & 0xFF);
+			}
+			next[record.source] = (record.sequence + 1) & 0xFF;
+			telemetry_decode_print(&record);
+			records++;
+			filled = 0;
+		}
+		else
+		{
+			// Not a record here: look for the sync from the next byte on
+			(void) memmove(window, window + 1, TELEMETRY_RECORD_SIZE - 1U);
+			filled--;
+			skipped++;
+		}
+	}
+
+	(void) fprintf(stderr, "%lu records, %lu bytes skipped, %lu records missing from the sequence\n",
+				   (unsigned long) records, (unsigned long) (skipped + filled), (unsigned long) gaps);
+
+	return 0;
+}
+
+static double telemetry_decode_now(void)
+{
+	struct timespec now;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec * 1e9 + (double) now.tv_nsec;
+}
+
+static int telemetry_decode_bench(uint32 records)
+{
+	static char line[128];
+	uint8* encoded = (records > 0U) ? malloc((size_t) records * TELEMETRY_RECORD_SIZE) : NULL;
+	volatile uint32 sink = 0;
+	uint32 text_bytes = 0;
+	uint32 i, bad = 0;
+	telemetry_record record;
+	double start, encode_ns, printf_ns;
+
+	if (encoded == NULL)
+	{
+		return 1;
+	}
+
+	// A programming command and the FSM status after it, as sys_main.c reports them
+	telemetry_init(TELEMETRY_SOURCE_EEPROM);
+	start = telemetry_decode_now();
+	for (i = 0; i < records; i++)
+	{
+		telemetry_encode(&encoded[i * TELEMETRY_RECORD_SIZE], TELEMETRY_FAPI_STATUS, i, 0x00014000U + i,
+						 TELEMETRY_DETAIL(TELEMETRY_FAPI_PROGRAM, i & 7U));
+	}
+	encode_ns = telemetry_decode_now() - start;
+
+	start = telemetry_decode_now();
+	for (i = 0; i < records; i++)
+	{
+		text_bytes += (uint32) snprintf(line, sizeof(line), "Return check %d\nFSM Status %d\n", (int) (i & 7U), (int) (0x00014000U + i));
+		sink += (uint32) line[0];
+	}
+	printf_ns = telemetry_decode_now() - start;
+
+	for (i = 0; i < records; i++)
+	{
+		if (!telemetry_decode(&encoded[i * TELEMETRY_RECORD_SIZE], &record) ||
+			record.type != TELEMETRY_FAPI_STATUS || record.source != TELEMETRY_SOURCE_EEPROM ||
+			record.sequence != (uint8) i || record.timestamp != i || record.value != 0x00014000U + i ||
+			record.detail != TELEMETRY_DETAIL(TELEMETRY_FAPI_PROGRAM, i & 7U))
+		{
+			bad++;
+		}
+	}
+
+	// Every single bit error of a record is caught
+	for (i = 0; i < TELEMETRY_RECORD_SIZE * 8U; i++)
+	{
+		encoded[i / 8U] ^= (uint8) (1U << (i % 8U));
+		bad += telemetry_decode(encoded, &record) ? 1U : 0U;
+		encoded[i / 8U] ^= (uint8) (1U << (i % 8U));
+	}
+
+	(void) printf("encode  %6.1f ns/record  %2u bytes/record\n", encode_ns / records, TELEMETRY_RECORD_SIZE);
+	(void) printf("printf  %6.1f ns/record  %2lu bytes/record\n", printf_ns / records, (unsigned long) (text_bytes / records));
+	(void) printf("round trip and bit flips: %s\n", (bad == 0U) ? "ok" : "FAILED");
+
+	free(encoded);
+	(void) sink;
+
+	return (bad == 0U) ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	FILE* in = stdin;
+	int result;
+
+	if (argc > 1 && strcmp(argv[1], "-b") == 0)
+	{
+		return telemetry_decode_bench((argc > 2) ? (uint32) strtoul(argv[2], NULL, 0) : TELEMETRY_DECODE_BENCH_RECORDS);
+	}
+
+	if (argc > 1 && (in = fopen(argv[1], "rb")) == NULL)
+	{
+		(void) fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	result = telemetry_decode_stream(in);
+	if (in != stdin)
+	{
+		(void) fclose(in);
+	}
+
+	return result;
+}
@@ -0,0 +1,325 @@
+/**
+ *	\file usdcard_bench.c
+ *	\brief Host run of the SD card driver (usdcard.c) against a card model.
+ *
+ *	A host program with its own main(): sdcard/.cproject excludes sim/ from the
+ *	CCS build. usdcard_sim.c stands for the card, SPI1 and the GIO pins (see
+ *	usdcard_sim.h). Build and run from the sdcard directory:
+ *
+ *	gcc -std=c99 -O2 -Isim/include -Iinclude -include usdcard_sim.h
+ *	    sim/source/usdcard_bench.c sim/source/usdcard_sim.c source/usdcard.c
+ *	    source/usdcard_crc.c -o usdcard_bench
+ *
+ *	usdcard_bench [spi_hz]
+ *
+ *	1. Writes: the same sectors with one usd_write_block() per sector and with
+ *	   one usd_write_blocks(), as usd_bench_write_single_vs_multi() does on the
+ *	   target. The card content is checked after each path.
+ *	2. Reads: the same sectors with one usd_read_block() per sector, with one
+ *	   usd_read_blocks() and sector by sector through the read-ahead window of
+ *	   usd_read_block_cached(), as usd_bench_read_single_vs_multi() does on the
+ *	   target. The data is checked after each path.
+ *	3. Background transfers: usd_xfer_write_start() and usd_xfer_read_start()
+ *	   serviced from a main loop that spends USD_BENCH_WORK_NS on other work
+ *	   between two usd_xfer_service() calls, as usd_bench_xfer_overlap() does
+ *	   on the target. The card has to see the USD_XFER_CHUNK byte chunks of
+ *	   the sector in order and the data has to match. Reports the free service
+ *	   polls, the CPU time they leave free, and the time of the blocking call.
+ *
+ *	Throughput is in MB/s of virtual time: SPI clock, driver calls and the
+ *	access and busy times of the card model, so the numbers only move when the
+ *	driver or the model change.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usdcard.h"
+#include "usdcard_sim.h"
+
+#define USD_BENCH_MAX_BLOCKS	64U
+#define USD_BENCH_FIRST_BLOCK	16U
+#define USD_BENCH_XFER_BLOCK	3U
+#define USD_BENCH_WORK_NS		2000U	// other work of the main loop between two service calls
+
+static const uint32 usd_bench_counts[] = { 1U, 4U, 16U, USD_BENCH_MAX_BLOCKS };
+
+static uint16 usd_bench_buffer[USD_BENCH_MAX_BLOCKS * 512U];
+static uint8 usd_bench_sector[512];
+
+//
+// Fills count sectors with a pattern that differs for every sector and pass.
+//
+static void usd_bench_fill(uint32 count, uint32 pass)
+{
+	uint32 i;
+
+	for (i = 0; i < count * 512U; i++)
+	{
+		usd_bench_buffer[i] = (uint16) ((i * 7U + (i >> 9) * 13U + pass) & 0x00FFU);
+	}
+}
+
+//
+// Compares count sectors of the card, from USD_BENCH_FIRST_BLOCK, with the buffer.
+//
+static boolean usd_bench_card_matches(uint32 count)
+{
+	uint32 i;
+
+	for (i = 0; i < count * 512U; i++)
+	{
+		if (usd_sim_block(USD_BENCH_FIRST_BLOCK + (i >> 9))[i & 511U] != (uint8) usd_bench_buffer[i])
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static double usd_bench_mbps(uint32 count, uint64 ns)
+{
+	return (ns == 0U) ? 0.0 : ((double) count * 512.0 * 1000.0) / (double) ns;
+}
+
+static int usd_bench_write(uint32 count)
+{
+	uint32 blk;
+	uint64 single_ns, multi_ns;
+	boolean ok;
+
+	usd_bench_fill(count, 1U);
+	single_ns = usd_sim_now_ns();
+	ok = TRUE;
+	for (blk = 0; blk < count; blk++)
+	{
+		ok = ok && (usd_write_block(usd_bench_buffer + (blk * 512U), USD_BENCH_FIRST_BLOCK + blk) == SUCCESS);
+	}
+	single_ns = usd_sim_now_ns() - single_ns;
+	ok = ok && usd_bench_card_matches(count);
+
+	usd_bench_fill(count, 2U);
+	multi_ns = usd_sim_now_ns();
+	ok = (usd_write_blocks(usd_bench_buffer, USD_BENCH_FIRST_BLOCK, count) == SUCCESS) && ok;
+	multi_ns = usd_sim_now_ns() - multi_ns;
+	ok = ok && usd_bench_card_matches(count);
+
+	(void) printf("write  %3lu sectors  single %6.3f MB/s  multi %6.3f MB/s  x%.2f  %s\n", (unsigned long) count,
+				  usd_bench_mbps(count, single_ns), usd_bench_mbps(count, multi_ns),
+				  (multi_ns == 0U) ? 0.0 : (double) single_ns / (double) multi_ns, ok ? "ok" : "FAILED");
+
+	return ok ? 0 : 1;
+}
+
+//
+// Copies the buffer to the card, from USD_BENCH_FIRST_BLOCK, and clears the buffer.
+//
+static void usd_bench_load_card(uint32 count)
+{
+	uint32 i;
+
+	for (i = 0; i < count * 512U; i++)
+	{
+		usd_sim_block(USD_BENCH_FIRST_BLOCK + (i >> 9))[i & 511U] = (uint8) usd_bench_buffer[i];
+		usd_bench_buffer[i] = 0xFFFFU;
+	}
+}
+
+static int usd_bench_read(uint32 count)
+{
+	uint32 blk;
+	uint64 single_ns, multi_ns, cached_ns;
+	boolean ok;
+
+	usd_bench_fill(count, 3U);
+	usd_bench_load_card(count);
+	single_ns = usd_sim_now_ns();
+	ok = TRUE;
+	for (blk = 0; blk < count; blk++)
+	{
+		ok = ok && (usd_read_block(usd_bench_buffer + (blk * 512U), USD_BENCH_FIRST_BLOCK + blk) == SUCCESS);
+	}
+	single_ns = usd_sim_now_ns() - single_ns;
+	ok = ok && usd_bench_card_matches(count);
+
+	usd_bench_fill(count, 4U);
+	usd_bench_load_card(count);
+	multi_ns = usd_sim_now_ns();
+	ok = (usd_read_blocks(usd_bench_buffer, USD_BENCH_FIRST_BLOCK, count) == SUCCESS) && ok;
+	multi_ns = usd_sim_now_ns() - multi_ns;
+	ok = ok && usd_bench_card_matches(count);
+
+	usd_bench_fill(count, 5U);
+	usd_bench_load_card(count);
+	usd_read_cache_invalidate();
+	cached_ns = usd_sim_now_ns();
+	for (blk = 0; blk < count; blk++)
+	{
+		ok = ok && (usd_read_block_cached(usd_bench_buffer + (blk * 512U), USD_BENCH_FIRST_BLOCK + blk) == SUCCESS);
+	}
+	cached_ns = usd_sim_now_ns() - cached_ns;
+	ok = ok && usd_bench_card_matches(count);
+
+	(void) printf("read   %3lu sectors  single %6.3f MB/s  multi %6.3f MB/s  x%.2f  cached %6.3f MB/s  %s\n",
+				  (unsigned long) count, usd_bench_mbps(count, single_ns), usd_bench_mbps(count, multi_ns),
+				  (multi_ns == 0U) ? 0.0 : (double) single_ns / (double) multi_ns,
+				  usd_bench_mbps(count, cached_ns), ok ? "ok" : "FAILED");
+
+	return ok ? 0 : 1;
+}
+
+//
+// Runs the background transfer started last to its end, with USD_BENCH_WORK_NS
+// of other work after every busy service call. A blocking call in between has
+// to be refused.
+//
+static boolean usd_bench_xfer_run(uint32* polls)
+{
+	uint16 other[512];
+	uint8 state;
+
+	*polls = 0;
+	while ((state = usd_xfer_service()) == USD_XFER_BUSY)
+	{
+		if (*polls == 0U && usd_read_block(other, USD_BENCH_FIRST_BLOCK) != USD_ERROR_XFER_BUSY)
+		{
+			return FALSE;
+		}
+		usd_sim_advance_ns(USD_BENCH_WORK_NS);
+		(*polls)++;
+	}
+
+	return (boolean) (state == USD_XFER_DONE);
+}
+
+//
+// The chunk log from entry first on has to be the sector in order.
+//
+static boolean usd_bench_chunks_in_order(uint32 first)
+{
+	usd_sim_chunk log[USD_SIM_CHUNK_LOG];
+	uint32 n = usd_sim_get_chunks(log);
+	uint32 i;
+
+	if (n != first + (512U / USD_XFER_CHUNK) || n > USD_SIM_CHUNK_LOG)
+	{
+		return FALSE;
+	}
+
+	for (i = first; i < n; i++)
+	{
+		if (log[i].block != USD_BENCH_XFER_BLOCK || log[i].offset != (i - first) * USD_XFER_CHUNK)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static int usd_bench_xfer(const char* name, boolean write)
+{
+	usd_xfer_counters counters;
+	usd_sim_counters sim;
+	usd_sim_chunk log[USD_SIM_CHUNK_LOG];
+	uint32 i, first, notifications;
+	uint32 polls = 0;
+	uint64 blocking_ns, xfer_ns;
+	boolean ok;
+
+	for (i = 0; i < 512U; i++)
+	{
+		usd_bench_sector[i] = (uint8) (i * 5U + (write ? 1U : 2U));
+		usd_bench_buffer[i] = usd_bench_sector[i];
+	}
+
+	if (!write)
+	{
+		memcpy(usd_sim_block(USD_BENCH_XFER_BLOCK), usd_bench_sector, 512U);
+	}
+
+	// Blocking path for the same sector
+	blocking_ns = usd_sim_now_ns();
+	ok = write ? (usd_write_block(usd_bench_buffer, USD_BENCH_XFER_BLOCK) == SUCCESS)
+			   : (usd_read_block(usd_bench_buffer, USD_BENCH_XFER_BLOCK) == SUCCESS);
+	blocking_ns = usd_sim_now_ns() - blocking_ns;
+
+	if (!write)
+	{
+		memset(usd_bench_sector, 0, sizeof(usd_bench_sector));
+	}
+	else
+	{
+		memset(usd_sim_block(USD_BENCH_XFER_BLOCK), 0, 512U);
+	}
+
+	usd_sim_get_counters(&sim);
+	notifications = sim.notifications;
+	first = usd_sim_get_chunks(log);
+	usd_reset_xfer_counters();
+
+	xfer_ns = usd_sim_now_ns();
+	ok = ok && ((write ? usd_xfer_write_start(usd_bench_sector, USD_BENCH_XFER_BLOCK)
+					   : usd_xfer_read_start(usd_bench_sector, USD_BENCH_XFER_BLOCK)) == SUCCESS);
+	ok = ok && usd_bench_xfer_run(&polls);
+	xfer_ns = usd_sim_now_ns() - xfer_ns;
+
+	usd_get_xfer_counters(&counters);
+	usd_sim_get_counters(&sim);
+	ok = ok && counters.chunks == 512U / USD_XFER_CHUNK && counters.busy_polls <= polls;
+	ok = ok && usd_bench_chunks_in_order(first) && sim.notifications == notifications + 1U;
+	ok = ok && memcmp(usd_bench_sector, usd_sim_block(USD_BENCH_XFER_BLOCK), 512U) == 0;
+	for (i = 0; i < 512U; i++)
+	{
+		ok = ok && usd_bench_sector[i] == (uint8) (i * 5U + (write ? 1U : 2U));
+	}
+
+	(void) printf("xfer %-5s %lu chunks  %lu service calls  %lu free polls  %lu of %lu us free  blocking %lu us  %s\n",
+				  name, (unsigned long) counters.chunks, (unsigned long) polls, (unsigned long) counters.busy_polls,
+				  (unsigned long) (((uint64) polls * USD_BENCH_WORK_NS) / 1000U), (unsigned long) (xfer_ns / 1000U),
+				  (unsigned long) (blocking_ns / 1000U), ok ? "ok" : "FAILED");
+
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	usd_sim_config config;
+	uint32 i;
+	int failed = 0;
+
+	usd_sim_default_config(&config);
+	if (argc > 1)
+	{
+		config.spi_hz = (uint32) strtoul(argv[1], NULL, 0);
+	}
+	usd_sim_reset(&config);
+
+	(void) printf("SPI %lu Hz, %lu ns per call, read access %lu us, write busy %lu us, "
+				  "multi-block busy %lu us, stop busy %lu us\n",
+				  (unsigned long) config.spi_hz, (unsigned long) config.call_ns,
+				  (unsigned long) (config.read_access_ns / 1000U), (unsigned long) (config.write_busy_ns / 1000U),
+				  (unsigned long) (config.multi_busy_ns / 1000U), (unsigned long) (config.stop_busy_ns / 1000U));
+
+	if (usd_init() != SUCCESS)
+	{
+		(void) printf("usd_init  FAILED\n");
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(usd_bench_counts) / sizeof(usd_bench_counts[0]); i++)
+	{
+		failed += usd_bench_write(usd_bench_counts[i]);
+	}
+
+	for (i = 0; i < sizeof(usd_bench_counts) / sizeof(usd_bench_counts[0]); i++)
+	{
+		failed += usd_bench_read(usd_bench_counts[i]);
+	}
+
+	failed += usd_bench_xfer("write", TRUE);
+	failed += usd_bench_xfer("read", FALSE);
+
+	return failed;
+}
@@ -0,0 +1,690 @@
+/**
+ *	\file usdcard_sim.c
+ *	\brief Host model of the SD card on SPI1 (usdcard_sim.h).
+ *
+ *	Replaces spi.c, gio.c and notification.c in the host build of usdcard.c,
+ *	see usdcard_bench.c for the build line.
+ */
+
+#include <string.h>
+#include "usdcard_sim.h"
+#include "usdcard_crc.h"
+#include "spi.h"
+
+// DAT1 value meaning "nothing written since the last access"
+#define USD_SIM_DAT1_IDLE		0xFFFFFFFFU
+
+// Card states between two bytes
+typedef enum
+{
+	USD_SIM_IDLE,	// waiting for a command
+	USD_SIM_READ,	// sending data blocks of a CMD17/CMD18
+	USD_SIM_WRITE,	// waiting for a data token or receiving a block of a CMD24/CMD25
+	USD_SIM_BUSY	// programming or erasing, the card holds MISO low
+}
+usd_sim_state;
+
+static struct
+{
+	usd_sim_state state;
+	usd_sim_state after_busy;	// state once the busy time is over
+	boolean selected;
+	boolean idle;				// R1 idle bit, until ACMD41 ends the initialization
+	boolean app_cmd;			// the previous command was CMD55
+	boolean crc_on;				// CMD59
+	uint32 init_polls;			// ACMD41 calls left that still answer "idle"
+
+	uint8 frame[6];				// command being received
+	uint32 frame_length;
+
+	uint8 response[8];			// bytes sent before the output of the state
+	uint32 response_length;
+	uint32 response_pos;
+
+	boolean multi;				// CMD18/CMD25
+	uint32 block;				// sector of the data phase
+	sint32 position;			// byte of the block, -1 before the data token
+	uint64 ready;				// read: first data token, busy: end of the busy time
+	uint8 data[514];			// block being received, with its CRC
+	uint8 crc[2];				// CRC of the block being sent
+	uint32 erase_start;
+	uint32 erase_end;
+}
+usd_sim_card;
+
+static usd_sim_config usd_sim_timing;
+static usd_sim_counters usd_sim_count;
+static uint64 usd_sim_now;
+static uint64 usd_sim_byte_ns;
+
+static uint8 usd_sim_blocks[USD_SIM_BLOCKS][512];
+
+// SPI1 and MibSPI1 are the same module, one register frame
+static union
+{
+	spiBASE_t spi;
+	mibspiBASE_t mibspi;
+}
+usd_sim_regs;
+
+static mibspiRAM_t usd_sim_ram;
+
+// Transfer group 0 of MibSPI1
+static struct
+{
+	boolean enabled;	// TGCTRL[0] bit 31 and MIBSPIE at the last access
+	boolean running;
+	uint32 start;		// first buffer
+	uint32 end;			// one past the last buffer
+	uint64 done;		// end of the last buffer
+}
+usd_sim_tg;
+
+static uint64 usd_sim_last_access;
+static usd_sim_chunk usd_sim_chunks[USD_SIM_CHUNK_LOG];
+static uint32 usd_sim_chunk_count;
+
+gioPORT_t usd_sim_spi_port;
+gioPORT_t usd_sim_het_port;
+
+void usd_sim_default_config(usd_sim_config* config)
+{
+	config->spi_hz = 20000000U;
+	config->call_ns = 1000U;
+	config->read_access_ns = 100000U;
+	config->read_gap_ns = 10000U;
+	config->write_busy_ns = 500000U;
+	config->multi_busy_ns = 50000U;
+	config->stop_busy_ns = 250000U;
+	config->erase_busy_ns = 2000000U;
+}
+
+void usd_sim_reset(const usd_sim_config* config)
+{
+	if (config)
+	{
+		usd_sim_timing = *config;
+	}
+	else
+	{
+		usd_sim_default_config(&usd_sim_timing);
+	}
+
+	memset(&usd_sim_card, 0, sizeof(usd_sim_card));
+	memset(&usd_sim_count, 0, sizeof(usd_sim_count));
+	memset(usd_sim_blocks, 0xA5, sizeof(usd_sim_blocks));
+	memset((void*) &usd_sim_regs, 0, sizeof(usd_sim_regs));
+	memset((void*) &usd_sim_ram, 0, sizeof(usd_sim_ram));
+	memset(&usd_sim_tg, 0, sizeof(usd_sim_tg));
+	usd_sim_chunk_count = 0;
+
+	usd_sim_card.state = USD_SIM_IDLE;
+	usd_sim_card.idle = TRUE;
+	usd_sim_card.init_polls = 2U;
+	usd_sim_regs.spi.DAT1 = USD_SIM_DAT1_IDLE;
+
+	// Chip select high, card detect switch closed (low)
+	usd_sim_spi_port.DOUT = 1U;
+	usd_sim_het_port.DIN = 0U;
+
+	usd_sim_now = 0U;
+	usd_sim_last_access = 0U;
+	usd_sim_byte_ns = 8000000000ULL / usd_sim_timing.spi_hz;
+}
+
+uint64 usd_sim_now_ns(void)
+{
+	return usd_sim_now;
+}
+
+void usd_sim_advance_ns(uint32 ns)
+{
+	usd_sim_now += ns;
+}
+
+void usd_sim_get_counters(usd_sim_counters* counters)
+{
+	*counters = usd_sim_count;
+}
+
+uint8* usd_sim_block(uint32 blkaddr)
+{
+	return usd_sim_blocks[blkaddr];
+}
+
+uint32 usd_sim_get_chunks(usd_sim_chunk* log)
+{
+	uint32 n = (usd_sim_chunk_count < USD_SIM_CHUNK_LOG) ? usd_sim_chunk_count : USD_SIM_CHUNK_LOG;
+
+	memcpy(log, usd_sim_chunks, n * sizeof(usd_sim_chunk));
+
+	return usd_sim_chunk_count;
+}
+
+static void usd_sim_respond(uint8 value)
+{
+	if (usd_sim_card.response_length < sizeof(usd_sim_card.response))
+	{
+		usd_sim_card.response[usd_sim_card.response_length++] = value;
+	}
+}
+
+static void usd_sim_busy(uint32 ns, usd_sim_state next)
+{
+	usd_sim_card.state = USD_SIM_BUSY;
+	usd_sim_card.after_busy = next;
+	usd_sim_card.ready = usd_sim_now + ns;
+}
+
+//
+// Executes the command in frame. The answer goes to the response queue after
+// one Ncr byte; data phases and busy times follow from the new state.
+//
+static void usd_sim_command(void)
+{
+	uint8 cmd = usd_sim_card.frame[0] & 0x3FU;
+	uint32 arg = ((uint32) usd_sim_card.frame[1] << 24) | ((uint32) usd_sim_card.frame[2] << 16)
+			   | ((uint32) usd_sim_card.frame[3] << 8) | (uint32) usd_sim_card.frame[4];
+	boolean app = usd_sim_card.app_cmd;
+	uint8 r1;
+	uint32 blk;
+
+	usd_sim_count.commands++;
+	usd_sim_card.app_cmd = FALSE;
+	usd_sim_card.response_length = 0;
+	usd_sim_card.response_pos = 0;
+
+	// Any command ends a data stream, CMD12 is the one meant for it
+	usd_sim_card.state = USD_SIM_IDLE;
+
+	usd_sim_respond(0xFF);
+
+	if (cmd == 0)
+	{
+		usd_sim_card.idle = TRUE;
+	}
+
+	r1 = usd_sim_card.idle ? 0x01 : 0x00;
+
+	switch (cmd)
+	{
+	case 0:		// GO_IDLE_STATE
+	case 12:	// STOP_TRANSMISSION
+	case 16:	// SET_BLOCKLEN, always 512 on SDHC
+		break;
+
+	case 8:		// SEND_IF_COND, R7 echoes the voltage and the check pattern
+		usd_sim_respond(r1);
+		usd_sim_respond(0x00);
+		usd_sim_respond(0x00);
+		usd_sim_respond((uint8) ((arg >> 8) & 0x0FU));
+		usd_sim_respond((uint8) arg);
+		return;
+
+	case 55:	// APP_CMD
+		usd_sim_card.app_cmd = TRUE;
+		break;
+
+	case 58:	// READ_OCR, R3 with power up and CCS set
+		usd_sim_respond(r1);
+		usd_sim_respond(0xC0);
+		usd_sim_respond(0xFF);
+		usd_sim_respond(0x80);
+		usd_sim_respond(0x00);
+		return;
+
+	case 59:	// CRC_ON_OFF
+		usd_sim_card.crc_on = (arg & 1U) ? TRUE : FALSE;
+		break;
+
+	case 41:	// ACMD41 SD_SEND_OP_COND
+		if (!app)
+		{
+			r1 |= 0x04;
+		}
+		else if (usd_sim_card.init_polls)
+		{
+			usd_sim_card.init_polls--;
+		}
+		else
+		{
+			usd_sim_card.idle = FALSE;
+			r1 = 0x00;
+		}
+		break;
+
+	case 23:	// ACMD23 SET_WR_BLK_ERASE_COUNT, only a hint for the card
+		if (!app)
+		{
+			r1 |= 0x04;
+		}
+		break;
+
+	case 17:	// READ_SINGLE_BLOCK
+	case 18:	// READ_MULTIPLE_BLOCK
+	case 24:	// WRITE_BLOCK
+	case 25:	// WRITE_MULTIPLE_BLOCK
+		if (usd_sim_card.idle)
+		{
+			r1 |= 0x04;
+		}
+		else if (arg >= USD_SIM_BLOCKS)
+		{
+			r1 |= 0x20;
+		}
+		else
+		{
+			usd_sim_card.block = arg;
+			usd_sim_card.position = -1;
+			usd_sim_card.multi = (cmd == 18 || cmd == 25) ? TRUE : FALSE;
+
+			if (cmd == 17 || cmd == 18)
+			{
+				usd_sim_card.state = USD_SIM_READ;
+				usd_sim_card.ready = usd_sim_now + usd_sim_timing.read_access_ns;
+			}
+			else
+			{
+				usd_sim_card.state = USD_SIM_WRITE;
+			}
+		}
+		break;
+
+	case 32:	// ERASE_WR_BLK_START_ADDR
+	case 33:	// ERASE_WR_BLK_END_ADDR
+		if (arg >= USD_SIM_BLOCKS)
+		{
+			r1 |= 0x20;
+		}
+		else if (cmd == 32)
+		{
+			usd_sim_card.erase_start = arg;
+		}
+		else
+		{
+			usd_sim_card.erase_end = arg;
+		}
+		break;
+
+	case 38:	// ERASE, the sectors read back as 0x00
+		for (blk = usd_sim_card.erase_start; blk <= usd_sim_card.erase_end; blk++)
+		{
+			memset(usd_sim_blocks[blk], 0x00, 512U);
+		}
+		usd_sim_respond(r1);
+		usd_sim_busy(usd_sim_timing.erase_busy_ns, USD_SIM_IDLE);
+		return;
+
+	default:
+		r1 |= 0x04;
+		break;
+	}
+
+	usd_sim_respond(r1);
+}
+
+//
+// End of a received data block: the data response and the programming time.
+//
+static void usd_sim_write_block(void)
+{
+	uint8 token = 0x05; // data accepted
+	uint16 crc = (uint16) ((usd_sim_card.data[512] << 8) | usd_sim_card.data[513]);
+
+	if (usd_sim_card.crc_on && usd_crc16_8(usd_sim_card.data, 512U) != crc)
+	{
+		usd_sim_count.crc_errors++;
+		token = 0x0B;
+	}
+	else if (usd_sim_card.block >= USD_SIM_BLOCKS)
+	{
+		token = 0x0D;
+	}
+	else
+	{
+		memcpy(usd_sim_blocks[usd_sim_card.block], usd_sim_card.data, 512U);
+		usd_sim_count.blocks_written++;
+	}
+
+	usd_sim_respond(token);
+
+	usd_sim_card.block++;
+	usd_sim_card.position = -1;
+
+	if (usd_sim_card.multi)
+	{
+		usd_sim_busy(usd_sim_timing.multi_busy_ns, USD_SIM_WRITE);
+	}
+	else
+	{
+		usd_sim_busy(usd_sim_timing.write_busy_ns, USD_SIM_IDLE);
+	}
+}
+
+static void usd_sim_write_byte(uint8 mosi)
+{
+	if (usd_sim_card.position < 0)
+	{
+		// 0xFF fill bytes are skipped until a token
+		if (mosi == (usd_sim_card.multi ? 0xFC : 0xFE))
+		{
+			usd_sim_card.position = 0;
+		}
+		else if (usd_sim_card.multi && mosi == 0xFD)
+		{
+			// Stop Tran: one byte before the card goes busy
+			usd_sim_respond(0xFF);
+			usd_sim_busy(usd_sim_timing.stop_busy_ns, USD_SIM_IDLE);
+		}
+		return;
+	}
+
+	usd_sim_card.data[usd_sim_card.position++] = mosi;
+
+	if (usd_sim_card.position == 514)
+	{
+		usd_sim_write_block();
+	}
+}
+
+//
+// MISO of the next byte, from the response queue first and then the state.
+//
+static uint8 usd_sim_output(void)
+{
+	uint8 miso = 0xFF;
+	uint16 crc;
+
+	if (usd_sim_card.response_pos < usd_sim_card.response_length)
+	{
+		miso = usd_sim_card.response[usd_sim_card.response_pos++];
+
+		if (usd_sim_card.response_pos == usd_sim_card.response_length)
+		{
+			usd_sim_card.response_length = 0;
+			usd_sim_card.response_pos = 0;
+		}
+
+		return miso;
+	}
+
+	switch (usd_sim_card.state)
+	{
+	case USD_SIM_READ:
+		if (usd_sim_card.position < 0)
+		{
+			if (usd_sim_now >= usd_sim_card.ready)
+			{
+				crc = usd_crc16_8(usd_sim_blocks[usd_sim_card.block], 512U);
+				usd_sim_card.crc[0] = (uint8) (crc >> 8);
+				usd_sim_card.crc[1] = (uint8) crc;
+				usd_sim_card.position = 0;
+				miso = 0xFE; // Start Block token
+			}
+		}
+		else if (usd_sim_card.position < 512)
+		{
+			miso = usd_sim_blocks[usd_sim_card.block][usd_sim_card.position++];
+		}
+		else
+		{
+			miso = usd_sim_card.crc[usd_sim_card.position++ - 512];
+
+			if (usd_sim_card.position == 514)
+			{
+				usd_sim_count.blocks_read++;
+				usd_sim_card.block++;
+				usd_sim_card.position = -1;
+				usd_sim_card.ready = usd_sim_now + usd_sim_timing.read_gap_ns;
+
+				if (!usd_sim_card.multi || usd_sim_card.block >= USD_SIM_BLOCKS)
+				{
+					usd_sim_card.state = USD_SIM_IDLE;
+				}
+			}
+		}
+		break;
+
+	case USD_SIM_BUSY:
+		if (usd_sim_now < usd_sim_card.ready)
+		{
+			usd_sim_count.busy_bytes++;
+			miso = 0x00;
+		}
+		else
+		{
+			usd_sim_card.state = usd_sim_card.after_busy;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return miso;
+}
+
+static void usd_sim_input(uint8 mosi)
+{
+	switch (usd_sim_card.state)
+	{
+	case USD_SIM_WRITE:
+		usd_sim_write_byte(mosi);
+		break;
+
+	case USD_SIM_BUSY:
+		break;
+
+	default:
+		// Commands start with 01 and can come at any byte, CMD12 during a CMD18 too
+		if (usd_sim_card.frame_length == 0 && (mosi & 0xC0U) != 0x40U)
+		{
+			break;
+		}
+
+		usd_sim_card.frame[usd_sim_card.frame_length++] = mosi;
+
+		if (usd_sim_card.frame_length == 6)
+		{
+			usd_sim_card.frame_length = 0;
+			usd_sim_command();
+		}
+		break;
+	}
+}
+
+//
+// One byte on the bus, without the time it takes.
+//
+static uint8 usd_sim_exchange(uint8 mosi)
+{
+	uint8 miso;
+
+	if (!usd_sim_card.selected)
+	{
+		return 0xFF;
+	}
+
+	usd_sim_count.bytes++;
+
+	miso = usd_sim_output();
+	usd_sim_input(mosi);
+
+	return miso;
+}
+
+//
+// One byte clocked by the CPU, which waits for it.
+//
+static uint8 usd_sim_clock(uint8 mosi)
+{
+	usd_sim_now += usd_sim_byte_ns;
+
+	return usd_sim_exchange(mosi);
+}
+
+//
+// End of a transfer group run: every buffer was shifted through the card.
+//
+static void usd_sim_tg_complete(void)
+{
+	uint32 i;
+
+	if (usd_sim_chunk_count < USD_SIM_CHUNK_LOG)
+	{
+		usd_sim_chunks[usd_sim_chunk_count].block = usd_sim_card.block;
+		usd_sim_chunks[usd_sim_chunk_count].offset = (uint32) usd_sim_card.position;
+	}
+	usd_sim_chunk_count++;
+	usd_sim_count.tg_chunks++;
+
+	for (i = usd_sim_tg.start; i < usd_sim_tg.end; i++)
+	{
+		usd_sim_ram.rx[i].data = usd_sim_exchange((uint8) usd_sim_ram.tx[i].data);
+	}
+
+	usd_sim_regs.mibspi.TGINTFLG |= (uint32) 1U << 16U;
+	usd_sim_tg.running = FALSE;
+}
+
+//
+// Catches up with the register writes of the driver since the previous access.
+//
+static void usd_sim_update(void)
+{
+	boolean enabled = ((usd_sim_regs.mibspi.MIBSPIE & 1U) != 0U)
+				   && ((usd_sim_regs.mibspi.TGCTRL[0U] & 0x80000000U) != 0U);
+
+	if (usd_sim_regs.spi.DAT1 != USD_SIM_DAT1_IDLE)
+	{
+		usd_sim_regs.spi.BUF = usd_sim_clock((uint8) usd_sim_regs.spi.DAT1);
+		usd_sim_regs.spi.FLG |= 0x00000100U;
+		usd_sim_regs.spi.DAT1 = USD_SIM_DAT1_IDLE;
+	}
+
+	// Enabled by the previous access at the latest, so the group starts at
+	// the time of that access
+	if (enabled && !usd_sim_tg.enabled)
+	{
+		usd_sim_tg.start = (usd_sim_regs.mibspi.TGCTRL[0U] >> 8U) & 0x7FU;
+		usd_sim_tg.end = (usd_sim_regs.mibspi.TGCTRL[1U] >> 8U) & 0xFFU;
+		if (usd_sim_tg.end > 128U || usd_sim_tg.end < usd_sim_tg.start)
+		{
+			usd_sim_tg.end = 128U;
+		}
+		usd_sim_tg.done = usd_sim_last_access + (usd_sim_tg.end - usd_sim_tg.start) * usd_sim_byte_ns;
+		usd_sim_tg.running = TRUE;
+		usd_sim_regs.mibspi.TGINTFLG &= ~((uint32) 1U << 16U);
+	}
+	else if (!enabled)
+	{
+		// Disabling the group stops it
+		usd_sim_tg.running = FALSE;
+	}
+	usd_sim_tg.enabled = enabled;
+
+	if (usd_sim_tg.running && usd_sim_now >= usd_sim_tg.done)
+	{
+		usd_sim_tg_complete();
+	}
+
+	usd_sim_last_access = usd_sim_now;
+}
+
+spiBASE_t* usd_sim_spi1(void)
+{
+	usd_sim_update();
+
+	return &usd_sim_regs.spi;
+}
+
+mibspiBASE_t* usd_sim_mibspi1(void)
+{
+	usd_sim_update();
+
+	return &usd_sim_regs.mibspi;
+}
+
+mibspiRAM_t* usd_sim_mibspi1_ram(void)
+{
+	usd_sim_update();
+
+	return &usd_sim_ram;
+}
+
+uint32 spiTransmitData(spiBASE_t *spi, spiDAT1_t *dataconfig_t, uint32 blocksize, uint16 * srcbuff)
+{
+	(void) spi;
+	(void) dataconfig_t;
+
+	usd_sim_now += usd_sim_timing.call_ns;
+
+	while (blocksize != 0U)
+	{
+		(void) usd_sim_clock((uint8) *srcbuff++);
+		blocksize--;
+	}
+
+	return 0U;
+}
+
+uint32 spiReceiveData(spiBASE_t *spi, spiDAT1_t *dataconfig_t, uint32 blocksize, uint16 * destbuff)
+{
+	(void) spi;
+	(void) dataconfig_t;
+
+	usd_sim_now += usd_sim_timing.call_ns;
+
+	// spi.c shifts out 0x00 while it receives
+	while (blocksize != 0U)
+	{
+		*destbuff++ = usd_sim_clock(0x00);
+		blocksize--;
+	}
+
+	return 0U;
+}
+
+void gioSetBit(gioPORT_t *port, uint32 bit, uint32 value)
+{
+	if (value)
+	{
+		port->DOUT |= (uint32) 1U << bit;
+	}
+	else
+	{
+		port->DOUT &= ~((uint32) 1U << bit);
+	}
+
+	if (port == spiPORT1 && bit == 0U)
+	{
+		usd_sim_card.selected = value ? FALSE : TRUE;
+
+		// A deselected card drops the command and the data phase it was in,
+		// a busy card keeps programming
+		if (!usd_sim_card.selected)
+		{
+			usd_sim_card.frame_length = 0;
+			usd_sim_card.response_length = 0;
+			usd_sim_card.response_pos = 0;
+			usd_sim_card.after_busy = USD_SIM_IDLE;
+
+			if (usd_sim_card.state != USD_SIM_BUSY)
+			{
+				usd_sim_card.state = USD_SIM_IDLE;
+			}
+		}
+	}
+}
+
+uint32 gioGetBit(gioPORT_t *port, uint32 bit)
+{
+	return (port->DIN >> bit) & 1U;
+}
+
+void spiEndNotification(spiBASE_t *spi)
+{
+	(void) spi;
+
+	usd_sim_count.notifications++;
+}
@@ -0,0 +1,263 @@
+/**
+ *	\file bistsched.c
+ *	\brief Scheduler that re-runs PBIST tests between the work of the main loop.
+ *	The operation is described in bistsched.h.
+ */
+
+#include "bistsched.h"
+#include "sys_selftest.h"
+#include "sys_vim.h"
+#include "reg_pbist.h"
+#include "reg_het.h"
+#include "reg_htu.h"
+#include "reg_mibspi.h"
+#include "usdcard.h"
+#include "sys_core.h"
+
+#define BISTSCHED_SYNC		0x01U	// run to completion with IRQ and FIQ masked
+
+#define BISTSCHED_ROM_ALGO	((uint32) PBIST_TripleReadSlow | (uint32) PBIST_TripleReadFast)
+#define BISTSCHED_RAM_ALGO	((uint32) PBIST_March13N_DP)
+
+typedef struct
+{
+	uint32 ram_group;		// RINFOL bit, as in sys_startup.c
+	uint32 algorithm;		// PBIST_... mask
+	uint32 address;			// RAM saved and restored around the test, 0 for none
+	uint32 size;			// bytes saved
+	void (*stop)(void);		// stops the owner of the RAM before the test, NULL for none
+	void (*start)(void);	// restarts it after the RAM is restored, NULL for none
+	boolean (*ready)(void);	// FALSE postpones the test to the next step, NULL for always ready
+	uint8 flags;			// BISTSCHED_SYNC
+}
+bistsched_test;
+
+static uint32 bistsched_het_gcr = 0;
+
+static void bistsched_het_stop(void)
+{
+	// Turn the HET off, the pins keep their state until it is turned on again
+	bistsched_het_gcr = hetREG1->GCR;
+	hetREG1->GCR = bistsched_het_gcr & ~1U;
+}
+
+static void bistsched_het_start(void)
+{
+	hetREG1->GCR = bistsched_het_gcr;
+}
+
+static boolean bistsched_mibspi1_ready(void)
+{
+	// usd_xfer_* moves the data of the card through transfer group 0 of the buffer RAM
+	return (boolean) (usd_xfer_status() != USD_XFER_BUSY);
+}
+
+//
+// The memories of the dual-port group tested by sys_startup.c, plus the two
+// ROMs. The MibSPI1 buffer RAM holds the transfer group of usd_xfer_* while a
+// background transfer of usdcard.c runs: its test waits for the transfer to
+// end, then runs masked so that none starts, and the RAM is restored. The ADC
+// results are not kept, and the CAN message objects are configured again by
+// canInit() when the modules are used.
+//
+static const bistsched_test bistsched_table[BISTSCHED_TESTS] =
+{
+	{ PBIST_ROM_PBIST_RAM_GROUP, BISTSCHED_ROM_ALGO, 0U, 0U, NULL, NULL, NULL, 0U },
+	{ STC_ROM_PBIST_RAM_GROUP, BISTSCHED_ROM_ALGO, 0U, 0U, NULL, NULL, NULL, 0U },
+	{ 0x00000200U, BISTSCHED_RAM_ALGO, 0xFFF82000U, VIM_CHANNELS * 4U, NULL, NULL, NULL, BISTSCHED_SYNC },
+	{ 0x00000040U, BISTSCHED_RAM_ALGO, 0xFF0E0000U, sizeof(mibspiRAM_t), NULL, NULL, bistsched_mibspi1_ready, BISTSCHED_SYNC },
+	{ 0x00000400U, BISTSCHED_RAM_ALGO, 0U, 0U, NULL, NULL, NULL, 0U },
+	{ 0x00000004U, BISTSCHED_RAM_ALGO, 0U, 0U, NULL, NULL, NULL, 0U },
+	{ 0x00000008U, BISTSCHED_RAM_ALGO, 0U, 0U, NULL, NULL, NULL, 0U },
+	{ 0x00001000U, BISTSCHED_RAM_ALGO, 0xFF460000U, sizeof(hetRAMBASE_t), bistsched_het_stop, bistsched_het_start, NULL, 0U },
+	{ 0x00002000U, BISTSCHED_RAM_ALGO, 0xFF4E0000U, sizeof(htuRAMBASE_t), NULL, NULL, NULL, 0U },
+};
+
+static uint32 bistsched_save[BISTSCHED_SAVE_WORDS];
+static bistsched_stats bistsched_state[BISTSCHED_TESTS];
+
+static uint32 bistsched_tests = 0;		// selected tests
+static uint32 bistsched_current = 0;	// test running, or the last one run
+static boolean bistsched_running = FALSE;
+static uint32 bistsched_period = BISTSCHED_PERIOD;
+static uint32 bistsched_mark = 0;		// start of the running test, or end of the last one
+
+static void bistsched_copy(volatile uint32* to, const volatile uint32* from, uint32 size)
+{
+	uint32 i;
+
+	for (i = 0U; i < (size / 4U); i++)
+	{
+		to[i] = from[i];
+	}
+}
+
+static void bistsched_start(uint32 test)
+{
+	const bistsched_test* entry = &bistsched_table[test];
+
+	if (entry->stop != NULL)
+	{
+		entry->stop();
+	}
+	bistsched_copy(bistsched_save, (const volatile uint32*) entry->address, entry->size);
+
+	bistsched_current = test;
+	bistsched_running = TRUE;
+	bistsched_mark = BISTSCHED_TIMESTAMP();
+	pbistRun(entry->ram_group, entry->algorithm);
+}
+
+//
+// Stops the controller, gives the RAM back to its owner and counts the run.
+//
+static void bistsched_finish(boolean timeout)
+{
+	const bistsched_test* entry = &bistsched_table[bistsched_current];
+	bistsched_stats* stats = &bistsched_state[bistsched_current];
+	uint32 ticks = BISTSCHED_TIMESTAMP() - bistsched_mark;
+
+	if (!timeout && pbistIsTestPassed())
+	{
+		stats->passed++;
+	}
+	else
+	{
+		stats->failed++;
+		stats->timeouts += timeout ? 1U : 0U;
+		stats->fail_address = pbistREG->FSRA0;
+		stats->fail_data = pbistREG->FSRDL0;
+	}
+	pbistStop();
+
+	bistsched_copy((volatile uint32*) entry->address, bistsched_save, entry->size);
+	if (entry->start != NULL)
+	{
+		entry->start();
+	}
+
+	stats->runs++;
+	stats->last_ticks = ticks;
+	if (ticks > stats->max_ticks)
+	{
+		stats->max_ticks = ticks;
+	}
+
+	bistsched_running = FALSE;
+	bistsched_mark = BISTSCHED_TIMESTAMP();
+}
+
+//
+// Runs a test that cannot share the CPU: interrupts stay masked until its RAM is restored.
+//
+static void bistsched_run_masked(uint32 test)
+{
+	uint32 cpsr = _getCPSRValue_();
+	boolean timeout = FALSE;
+
+	_disable_interrupt_();
+	bistsched_start(test);
+	while (!pbistIsTestCompleted() && !timeout)
+	{
+		timeout = (boolean) ((BISTSCHED_TIMESTAMP() - bistsched_mark) > BISTSCHED_TIMEOUT);
+	}
+	bistsched_finish(timeout);
+	if ((cpsr & 0xC0U) == 0U)
+	{
+		_enable_interrupt_();
+	}
+}
+
+void bistsched_init(uint32 tests)
+{
+	uint32 test;
+
+	bistsched_tests = 0U;
+	for (test = 0U; test < BISTSCHED_TESTS; test++)
+	{
+		if (((tests >> test) & 1U) != 0U && bistsched_table[test].size <= (BISTSCHED_SAVE_WORDS * 4U))
+		{
+			bistsched_tests |= 1U << test;
+		}
+
+		bistsched_state[test].runs = 0U;
+		bistsched_state[test].passed = 0U;
+		bistsched_state[test].failed = 0U;
+		bistsched_state[test].timeouts = 0U;
+		bistsched_state[test].last_ticks = 0U;
+		bistsched_state[test].max_ticks = 0U;
+		bistsched_state[test].fail_address = 0U;
+		bistsched_state[test].fail_data = 0U;
+	}
+
+	bistsched_current = BISTSCHED_TESTS - 1U;
+	bistsched_running = FALSE;
+	bistsched_mark = BISTSCHED_TIMESTAMP();
+}
+
+boolean bistsched_step(void)
+{
+	uint32 test = bistsched_current;
+	uint32 i;
+
+	if (bistsched_running)
+	{
+		if (pbistIsTestCompleted())
+		{
+			bistsched_finish(FALSE);
+			return TRUE;
+		}
+		if ((BISTSCHED_TIMESTAMP() - bistsched_mark) > BISTSCHED_TIMEOUT)
+		{
+			bistsched_finish(TRUE);
+			return TRUE;
+		}
+		return FALSE;
+	}
+
+	if (bistsched_tests == 0U || (BISTSCHED_TIMESTAMP() - bistsched_mark) < bistsched_period)
+	{
+		return FALSE;
+	}
+
+	// Next selected test after the last one
+	for (i = 0U; i < BISTSCHED_TESTS; i++)
+	{
+		test = (test + 1U) % BISTSCHED_TESTS;
+		if (((bistsched_tests >> test) & 1U) != 0U)
+		{
+			break;
+		}
+	}
+
+	// The last test run stays bistsched_current, so the same test is tried again
+	if (bistsched_table[test].ready != NULL && !bistsched_table[test].ready())
+	{
+		return FALSE;
+	}
+
+	if ((bistsched_table[test].flags & BISTSCHED_SYNC) != 0U)
+	{
+		bistsched_run_masked(test);
+		return TRUE;
+	}
+
+	bistsched_start(test);
+
+	return FALSE;
+}
+
+void bistsched_set_period(uint32 ticks)
+{
+	bistsched_period = ticks;
+}
+
+void bistsched_get_stats(uint32 test, bistsched_stats* stats)
+{
+	if (test >= BISTSCHED_TESTS)
+	{
+		return;
+	}
+
+	*stats = bistsched_state[test];
+}
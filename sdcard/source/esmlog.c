@@ -0,0 +1,96 @@
+/**
+ *	\file esmlog.c
+ *	\brief Lock-free ring of ESM events, written from the ESM interrupt.
+ *	The operation is described in esmlog.h.
+ */
+
+#include "esmlog.h"
+
+//
+// Only esmlog_push() writes the head, the drop counter and the records,
+// only esmlog_release() writes the tail.
+//
+static volatile esmlog_event esmlog_ring[ESMLOG_SIZE];
+static volatile uint32 esmlog_head = 0;
+static volatile uint32 esmlog_tail = 0;
+static volatile uint32 esmlog_drops = 0;
+static uint16 esmlog_sequence = 0;
+
+void esmlog_push(uint8 group, uint8 channel, uint32 status)
+{
+	uint32 head = esmlog_head;
+	uint16 sequence = esmlog_sequence++;
+	volatile esmlog_event* slot;
+
+	if ((head - esmlog_tail) >= ESMLOG_SIZE)
+	{
+		esmlog_drops++;
+		return;
+	}
+
+	slot = &esmlog_ring[head & (ESMLOG_SIZE - 1U)];
+	slot->timestamp = ESMLOG_TIMESTAMP();
+	slot->status = status;
+	slot->sequence = sequence;
+	slot->group = group;
+	slot->channel = channel;
+
+	// The record is complete before the consumer can see it
+	ESMLOG_BARRIER();
+	esmlog_head = head + 1U;
+}
+
+boolean esmlog_peek(esmlog_event* event)
+{
+	uint32 tail = esmlog_tail;
+
+	if (tail == esmlog_head)
+	{
+		return FALSE;
+	}
+
+	ESMLOG_BARRIER();
+	*event = esmlog_ring[tail & (ESMLOG_SIZE - 1U)];
+
+	return TRUE;
+}
+
+void esmlog_release(void)
+{
+	// The record is copied before the producer can reuse it
+	ESMLOG_BARRIER();
+	esmlog_tail = esmlog_tail + 1U;
+}
+
+boolean esmlog_pop(esmlog_event* event)
+{
+	if (!esmlog_peek(event))
+	{
+		return FALSE;
+	}
+
+	esmlog_release();
+
+	return TRUE;
+}
+
+void esmlog_encode(const esmlog_event* event, uint8* payload)
+{
+	payload[0] = (uint8) (event->timestamp >> 24);
+	payload[1] = (uint8) (event->timestamp >> 16);
+	payload[2] = (uint8) (event->timestamp >> 8);
+	payload[3] = (uint8) event->timestamp;
+	payload[4] = (uint8) (event->status >> 24);
+	payload[5] = (uint8) (event->status >> 16);
+	payload[6] = (uint8) (event->status >> 8);
+	payload[7] = (uint8) event->status;
+	payload[8] = (uint8) (event->sequence >> 8);
+	payload[9] = (uint8) event->sequence;
+	payload[10] = event->group;
+	payload[11] = event->channel;
+}
+
+uint32 esmlog_dropped(void)
+{
+	return esmlog_drops;
+}
@@ -0,0 +1,327 @@
+/**
+ *	\file logbin.c
+ *	\brief Append-only binary log with framed records and a fast mount scan.
+ *	The layout is described in logbin.h.
+ */
+
+#include "logbin.h"
+#include "usdcard.h"
+#include "usdcard_crc.h"
+#include <string.h>
+
+//
+// Sector being filled. It is written again on each flush until it is full.
+//
+static uint8 logbin_sector[512];
+static logbin_info logbin_state;
+static uint8 logbin_mounted = FALSE;
+
+static void logbin_put32(uint8* p, uint32 value)
+{
+	p[0] = (uint8)(value >> 24);
+	p[1] = (uint8)(value >> 16);
+	p[2] = (uint8)(value >> 8);
+	p[3] = (uint8)value;
+}
+
+static uint32 logbin_get32(const uint8* p)
+{
+	return ((uint32)p[0] << 24) | ((uint32)p[1] << 16) | ((uint32)p[2] << 8) | (uint32)p[3];
+}
+
+static void logbin_put16(uint8* p, uint16 value)
+{
+	p[0] = (uint8)(value >> 8);
+	p[1] = (uint8)value;
+}
+
+static uint16 logbin_get16(const uint8* p)
+{
+	return (uint16)(((uint16)p[0] << 8) | (uint16)p[1]);
+}
+
+//
+// TRUE when the sector starts with a log header whose CRC matches.
+//
+static boolean logbin_header_valid(const uint8* sector)
+{
+	if (logbin_get32(&sector[0]) != LOGBIN_MAGIC)
+	{
+		return FALSE;
+	}
+
+	return (boolean)(usd_crc16_8(sector, 14U) == logbin_get16(&sector[14]));
+}
+
+//
+// Clears the sector buffer and writes the header of a new sector.
+//
+static void logbin_sector_start(void)
+{
+	memset(logbin_sector, 0, sizeof(logbin_sector));
+
+	logbin_put32(&logbin_sector[0], LOGBIN_MAGIC);
+	logbin_put32(&logbin_sector[4], logbin_state.generation);
+	logbin_put32(&logbin_sector[8], logbin_state.sequence);
+	logbin_put16(&logbin_sector[14], usd_crc16_8(logbin_sector, 14U));
+
+	logbin_state.offset = LOGBIN_SECTOR_HEADER_SIZE;
+}
+
+static uint8 logbin_sector_write(void)
+{
+	if (usd_write_block8(logbin_sector, logbin_state.blkaddr_first + logbin_state.sector) != SUCCESS)
+	{
+		return LOGBIN_ERROR_CARD;
+	}
+
+	return LOGBIN_OK;
+}
+
+//
+// Reads the header of sector index and tells whether it belongs to generation.
+//
+static uint8 logbin_sector_is_current(uint32 index, uint32 generation, boolean* current)
+{
+	logbin_state.mount_reads++;
+
+	if (usd_read_block8(logbin_sector, logbin_state.blkaddr_first + index) != SUCCESS)
+	{
+		return LOGBIN_ERROR_CARD;
+	}
+
+	*current = (boolean)(logbin_header_valid(logbin_sector) && (logbin_get32(&logbin_sector[4]) == generation));
+
+	return LOGBIN_OK;
+}
+
+boolean logbin_parse_record(const uint8* sector, uint32* offset, logbin_record* record)
+{
+	uint32 pos = *offset;
+	uint16 length;
+	uint32 end;
+
+	if ((pos + LOGBIN_RECORD_HEADER_SIZE + 2U) > 512U || sector[pos] != LOGBIN_RECORD_SYNC)
+	{
+		return FALSE;
+	}
+
+	length = logbin_get16(&sector[pos + 2U]);
+	end = pos + LOGBIN_RECORD_HEADER_SIZE + length;
+
+	if ((end + 2U) > 512U)
+	{
+		return FALSE;
+	}
+
+	if (usd_crc16_8(&sector[pos], end - pos) != logbin_get16(&sector[end]))
+	{
+		return FALSE;
+	}
+
+	record->type = sector[pos + 1U];
+	record->length = length;
+	record->sequence = logbin_get32(&sector[pos + 4U]);
+	record->timestamp = logbin_get32(&sector[pos + 8U]);
+	record->payload = &sector[pos + LOGBIN_RECORD_HEADER_SIZE];
+
+	*offset = end + 2U;
+
+	return TRUE;
+}
+
+uint8 logbin_mount(uint32 blkaddr_first, uint32 blocks)
+{
+	uint32 generation;
+	uint32 low;
+	uint32 high;
+	uint32 middle;
+	uint32 probe;
+	boolean current;
+	logbin_record record;
+
+	logbin_mounted = FALSE;
+	memset(&logbin_state, 0, sizeof(logbin_state));
+	logbin_state.blkaddr_first = blkaddr_first;
+	logbin_state.blocks = blocks;
+
+	if (blocks == 0U)
+	{
+		return LOGBIN_ERROR_NOT_MOUNTED;
+	}
+
+	//
+	// Sector 0 is rewritten first at each wrap, so it holds the newest
+	// generation.
+	//
+	logbin_state.mount_reads++;
+
+	if (usd_read_block8(logbin_sector, blkaddr_first) != SUCCESS)
+	{
+		return LOGBIN_ERROR_CARD;
+	}
+
+	if (!logbin_header_valid(logbin_sector))
+	{
+		//
+		// Either a blank range or a sector 0 torn while it was rewritten, with
+		// the older generations still in the other sectors. Sector 1 and the
+		// last sector hold the newest of those: start past it, so no sector
+		// left behind can pass for the current generation.
+		//
+		generation = 0U;
+		probe = 1U;
+
+		while (probe < blocks)
+		{
+			logbin_state.mount_reads++;
+
+			if (usd_read_block8(logbin_sector, blkaddr_first + probe) != SUCCESS)
+			{
+				return LOGBIN_ERROR_CARD;
+			}
+
+			if (logbin_header_valid(logbin_sector) && logbin_get32(&logbin_sector[4]) > generation)
+			{
+				generation = logbin_get32(&logbin_sector[4]);
+			}
+
+			probe = (probe < (blocks - 1U)) ? (blocks - 1U) : blocks;
+		}
+
+		logbin_state.generation = generation + 1U;
+		logbin_state.sector = 0U;
+		logbin_state.sequence = 0U;
+		logbin_sector_start();
+		logbin_mounted = TRUE;
+
+		return LOGBIN_OK;
+	}
+
+	generation = logbin_get32(&logbin_sector[4]);
+
+	//
+	// Sectors of the current generation form a prefix of the range: find the
+	// first one that is not, in [1, blocks].
+	//
+	low = 1U;
+	high = blocks;
+
+	while (low < high)
+	{
+		middle = low + ((high - low) / 2U);
+
+		if (logbin_sector_is_current(middle, generation, &current) != LOGBIN_OK)
+		{
+			return LOGBIN_ERROR_CARD;
+		}
+
+		if (current)
+		{
+			low = middle + 1U;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	//
+	// Resume in the last sector written, after its last valid record.
+	//
+	logbin_state.generation = generation;
+	logbin_state.sector = low - 1U;
+	logbin_state.mount_reads++;
+
+	if (usd_read_block8(logbin_sector, blkaddr_first + logbin_state.sector) != SUCCESS)
+	{
+		return LOGBIN_ERROR_CARD;
+	}
+
+	logbin_state.sequence = logbin_get32(&logbin_sector[8]);
+	logbin_state.offset = LOGBIN_SECTOR_HEADER_SIZE;
+
+	while (logbin_parse_record(logbin_sector, &logbin_state.offset, &record))
+	{
+		logbin_state.sequence = record.sequence + 1U;
+	}
+
+	//
+	// Anything after the last valid record is a torn write: clear it so the
+	// sector is rewritten clean.
+	//
+	memset(&logbin_sector[logbin_state.offset], 0, 512U - logbin_state.offset);
+
+	logbin_mounted = TRUE;
+
+	return LOGBIN_OK;
+}
+
+uint8 logbin_append(uint8 type, uint32 timestamp, const uint8* payload, uint16 length)
+{
+	uint32 pos;
+	uint32 end;
+
+	if (!logbin_mounted)
+	{
+		return LOGBIN_ERROR_NOT_MOUNTED;
+	}
+
+	if (length > LOGBIN_MAX_PAYLOAD)
+	{
+		return LOGBIN_ERROR_TOO_LONG;
+	}
+
+	//
+	// Records do not cross sectors: close the current one when it cannot
+	// hold this record and move to the next, wrapping to a new generation.
+	//
+	if ((logbin_state.offset + LOGBIN_RECORD_HEADER_SIZE + length + 2U) > 512U)
+	{
+		if (logbin_sector_write() != LOGBIN_OK)
+		{
+			return LOGBIN_ERROR_CARD;
+		}
+
+		logbin_state.sector++;
+
+		if (logbin_state.sector == logbin_state.blocks)
+		{
+			logbin_state.sector = 0U;
+			logbin_state.generation++;
+		}
+
+		logbin_sector_start();
+	}
+
+	pos = logbin_state.offset;
+	end = pos + LOGBIN_RECORD_HEADER_SIZE + length;
+
+	logbin_sector[pos] = LOGBIN_RECORD_SYNC;
+	logbin_sector[pos + 1U] = type;
+	logbin_put16(&logbin_sector[pos + 2U], length);
+	logbin_put32(&logbin_sector[pos + 4U], logbin_state.sequence);
+	logbin_put32(&logbin_sector[pos + 8U], timestamp);
+	memcpy(&logbin_sector[pos + LOGBIN_RECORD_HEADER_SIZE], payload, length);
+	logbin_put16(&logbin_sector[end], usd_crc16_8(&logbin_sector[pos], end - pos));
+
+	logbin_state.offset = end + 2U;
+	logbin_state.sequence++;
+
+	return LOGBIN_OK;
+}
+
+uint8 logbin_flush(void)
+{
+	if (!logbin_mounted)
+	{
+		return LOGBIN_ERROR_NOT_MOUNTED;
+	}
+
+	return logbin_sector_write();
+}
+
+void logbin_get_info(logbin_info* info)
+{
+	*info = logbin_state;
+}
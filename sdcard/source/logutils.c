@@ -8,25 +8,128 @@
 
 #include "logutils.h"
 #include "usdcard.h"
+#include "usdcard_jobs.h"
 #include <stdio.h>
+#include <string.h>
 
 //TODO Precisa ser dinmico (buffer)?
 
 int write_usdcard(char loginfo[], int addr){
 	// if retv = 1, write error
 
-	uint16_t buffer[512], i;
+	uint8 buffer[512];
+	uint16 i;
 	int retv = -1, length = 0;
 	length = strlen(loginfo);
 	if(length <= 512) {
 		for(i = 0; i < length ; i++){
-			buffer[i] = (uint16) loginfo[i];
+			buffer[i] = (uint8) loginfo[i];
 		}
-		retv = usd_write_block(buffer, addr);
+		retv = usd_write_block8(buffer, addr);
 	}
 	return retv;
 }
 
+//
+// Two sector buffers: one is filled while the other is written by the job queue.
+// log_result[i] is USD_JOB_PENDING while buffer i belongs to the card.
+//
+static uint8 log_buffer[2][512];
+static volatile uint8 log_result[2] = { USD_JOB_OK, USD_JOB_OK };
+static uint8 log_active = 0;
+static log_usdcard_info log_info = { 0, 0, 0, 0, 0 };
+
+//
+// Hands the active buffer to the job queue and switches to the other one.
+//
+static void log_usdcard_write_active(void)
+{
+	if (usd_job_write(log_buffer[log_active], log_info.blkaddr, &log_result[log_active]) != SUCCESS)
+	{
+		log_info.lost++;
+	}
+
+	log_active ^= 1U;
+	log_info.blkaddr++;
+	log_info.offset = 0;
+}
+
+void log_usdcard_init(uint32 blkaddr)
+{
+	log_active = 0;
+	log_info.blkaddr = blkaddr;
+	log_info.offset = 0;
+	log_info.messages = 0;
+	log_info.dropped = 0;
+	log_info.lost = 0;
+}
+
+int log_usdcard_append(const char loginfo[])
+{
+	uint32 i, length;
+	uint8* dst;
+
+	length = strlen(loginfo);
+
+	if (length > 512) {
+		return -1;
+	}
+
+	// The message reaches the next sector, whose buffer must be free
+	if (log_info.offset + length >= 512 && log_result[log_active ^ 1U] == USD_JOB_PENDING) {
+		log_info.dropped++;
+		return -1;
+	}
+
+	dst = log_buffer[log_active];
+
+	for (i = 0; i < length; i++) {
+		dst[log_info.offset++] = (uint8) loginfo[i];
+
+		if (log_info.offset == 512) {
+			log_usdcard_write_active();
+			dst = log_buffer[log_active];
+		}
+	}
+
+	log_info.messages++;
+
+	return 0;
+}
+
+int log_usdcard_flush(void)
+{
+	uint32 i;
+	uint8 next = log_active ^ 1U;
+
+	if (log_info.offset == 0) {
+		return 0;
+	}
+
+	if (log_result[next] == USD_JOB_PENDING) {
+		return -1;
+	}
+
+	// The partial sector goes on in the other buffer, the unused tail is zero
+	for (i = 0; i < 512; i++) {
+		log_buffer[next][i] = (i < log_info.offset) ? log_buffer[log_active][i] : 0;
+		log_buffer[log_active][i] = log_buffer[next][i];
+	}
+
+	if (usd_job_write(log_buffer[log_active], log_info.blkaddr, &log_result[log_active]) != SUCCESS) {
+		return -1;
+	}
+
+	log_active = next;
+
+	return 0;
+}
+
+void log_usdcard_get_info(log_usdcard_info* info)
+{
+	*info = log_info;
+}
+
 //TODO Write flash
 
 //TODO Function to Printf, write sdcard and write flash
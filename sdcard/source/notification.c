@@ -55,12 +55,15 @@
 #include "het.h"
 
 /* USER CODE BEGIN (0) */
+#include "esmlog.h"
 /* USER CODE END */
 #pragma WEAK(esmGroup1Notification)
 void esmGroup1Notification(uint32 channel)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (1) */
+    // Channels 32 to 63 of group 1 are flagged in SR4
+    esmlog_push(1U, (uint8)channel, (channel < 32U) ? esmREG->SR1[0U] : esmREG->SR4[0U]);
 /* USER CODE END */
 }
 
@@ -71,6 +74,7 @@ void esmGroup2Notification(uint32 channel)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (3) */
+    esmlog_push(2U, (uint8)channel, esmREG->SR1[1U]);
 /* USER CODE END */
 }
 
@@ -0,0 +1,212 @@
+/**
+ *	\file ramscrub.c
+ *	\brief Background TCRAM scrubber with a ring of single-event upset records.
+ *	The operation is described in ramscrub.h.
+ */
+
+#include "ramscrub.h"
+#include "reg_tcram.h"
+#include "reg_esm.h"
+#include "sys_core.h"
+
+#define RAMSCRUB_ERR_SINGLE		0x00000001U	// SERR
+#define RAMSCRUB_ERR_DOUBLE		0x00000020U	// DERR
+#define RAMSCRUB_ERR_OTHER		0x00000194U	// ADDR_DEC_FAIL, ADDR_COMP_LOGIC_FAIL, RADDR_PAR_FAIL, WADDR_PAR_FAIL
+#define RAMSCRUB_ERR_ADDRESS	0x0003FFF8U	// 64-bit word offset in RAMSERRADDR and RAMUERRADDR
+
+static tcramBASE_t* const ramscrub_wrapper[2] = { tcram1REG, tcram2REG };
+
+// ESM group 1 channels 26 and 28: corrected error of B0TCM and B1TCM
+static const uint32 ramscrub_esm_single[2] = { 0x04000000U, 0x10000000U };
+
+//
+// Ring of events. Only ramscrub_step() and ramscrub_init() move the head,
+// only ramscrub_read_event() moves the tail.
+//
+static volatile ramscrub_event ramscrub_log[RAMSCRUB_LOG_SIZE];
+static volatile uint32 ramscrub_head = 0;
+static volatile uint32 ramscrub_tail = 0;
+
+static ramscrub_stats ramscrub_state;
+static uint32 ramscrub_cursor = 0;		// offset of the next word to read
+static uint32 ramscrub_pass_start = 0;
+
+static void ramscrub_log_event(const ramscrub_event* event)
+{
+	if ((ramscrub_head - ramscrub_tail) >= RAMSCRUB_LOG_SIZE)
+	{
+		ramscrub_state.dropped++;
+		return;
+	}
+
+	ramscrub_log[ramscrub_head & (RAMSCRUB_LOG_SIZE - 1U)] = *event;
+	ramscrub_head++;
+}
+
+//
+// Writes a word back with the value corrected on the read, which stores a
+// correct ECC. Interrupts are masked so no other write to the word is lost.
+//
+static void ramscrub_write_back(uint32 address)
+{
+	volatile uint64* word = (volatile uint64*) address;
+	uint32 cpsr;
+	uint64 value;
+
+	if ((address < RAMSCRUB_RAM_START) || (address >= (RAMSCRUB_RAM_START + RAMSCRUB_RAM_SIZE)))
+	{
+		return;
+	}
+
+	cpsr = _getCPSRValue_();
+	_disable_interrupt_();
+	value = *word;
+	*word = value;
+	if ((cpsr & 0xC0U) == 0U)
+	{
+		_enable_interrupt_();
+	}
+}
+
+//
+// Logs and clears the correctable and the other errors of a wrapper.
+//
+static void ramscrub_harvest(uint32 wrapper)
+{
+	tcramBASE_t* reg = ramscrub_wrapper[wrapper];
+	uint32 status = reg->RAMERRSTATUS;
+	ramscrub_event event;
+
+	if ((status & (RAMSCRUB_ERR_SINGLE | RAMSCRUB_ERR_OTHER)) == 0U)
+	{
+		return;
+	}
+
+	event.timestamp = RAMSCRUB_TIMESTAMP();
+	event.status = status;
+	event.count = (uint16) reg->RAMOCCUR;
+	event.wrapper = (uint8) wrapper;
+
+	if ((status & RAMSCRUB_ERR_SINGLE) != 0U)
+	{
+		event.type = RAMSCRUB_EVENT_SINGLE;
+		event.address = RAMSCRUB_RAM_START + (reg->RAMSERRADDR & RAMSCRUB_ERR_ADDRESS);
+		ramscrub_write_back(event.address);
+		ramscrub_state.single += (event.count > 1U) ? event.count : 1U;
+
+		reg->RAMOCCUR = 0U;
+		esmREG->SR1[0U] = ramscrub_esm_single[wrapper];
+	}
+	else
+	{
+		event.type = RAMSCRUB_EVENT_OTHER;
+		event.address = 0U;
+		ramscrub_state.other++;
+	}
+
+	// The flags are cleared by writing 1
+	reg->RAMERRSTATUS = status & (RAMSCRUB_ERR_SINGLE | RAMSCRUB_ERR_OTHER);
+	ramscrub_log_event(&event);
+}
+
+void ramscrub_init(void)
+{
+	uint32 wrapper;
+	ramscrub_event event;
+	tcramBASE_t* reg;
+
+	ramscrub_head = 0U;
+	ramscrub_tail = 0U;
+	ramscrub_cursor = 0U;
+	ramscrub_state.passes = 0U;
+	ramscrub_state.pass_ticks = 0U;
+	ramscrub_state.slice_ticks_max = 0U;
+	ramscrub_state.single = 0U;
+	ramscrub_state.double_bit = 0U;
+	ramscrub_state.other = 0U;
+	ramscrub_state.dropped = 0U;
+
+	for (wrapper = 0U; wrapper < 2U; wrapper++)
+	{
+		reg = ramscrub_wrapper[wrapper];
+
+		// Flag every corrected error and report it to the ESM
+		reg->RAMTHRESHOLD = 1U;
+		reg->RAMINTCTRL = 1U;
+
+		if ((reg->RAMERRSTATUS & RAMSCRUB_ERR_DOUBLE) != 0U)
+		{
+			event.timestamp = RAMSCRUB_TIMESTAMP();
+			event.address = RAMSCRUB_RAM_START + (reg->RAMUERRADDR & RAMSCRUB_ERR_ADDRESS);
+			event.status = reg->RAMERRSTATUS;
+			event.count = 1U;
+			event.type = RAMSCRUB_EVENT_DOUBLE;
+			event.wrapper = (uint8) wrapper;
+			ramscrub_state.double_bit++;
+
+			reg->RAMERRSTATUS = RAMSCRUB_ERR_DOUBLE;
+			ramscrub_log_event(&event);
+		}
+		ramscrub_harvest(wrapper);
+	}
+
+	ramscrub_pass_start = RAMSCRUB_TIMESTAMP();
+}
+
+boolean ramscrub_step(void)
+{
+	uint32 start = RAMSCRUB_TIMESTAMP();
+	const volatile uint64* word = (const volatile uint64*) (RAMSCRUB_RAM_START + ramscrub_cursor);
+	uint32 words = (RAMSCRUB_RAM_SIZE - ramscrub_cursor) / 8U;
+	uint32 i;
+	boolean pass_done = FALSE;
+
+	if (words > RAMSCRUB_SLICE_WORDS)
+	{
+		words = RAMSCRUB_SLICE_WORDS;
+	}
+
+	// Every 64-bit read checks, and corrects in the read data, the ECC of the word
+	for (i = 0U; i < words; i++)
+	{
+		(void) word[i];
+	}
+	ramscrub_cursor += words * 8U;
+
+	ramscrub_harvest(0U);
+	ramscrub_harvest(1U);
+
+	if (ramscrub_cursor >= RAMSCRUB_RAM_SIZE)
+	{
+		ramscrub_cursor = 0U;
+		ramscrub_state.passes++;
+		ramscrub_state.pass_ticks = RAMSCRUB_TIMESTAMP() - ramscrub_pass_start;
+		ramscrub_pass_start = RAMSCRUB_TIMESTAMP();
+		pass_done = TRUE;
+	}
+
+	if ((RAMSCRUB_TIMESTAMP() - start) > ramscrub_state.slice_ticks_max)
+	{
+		ramscrub_state.slice_ticks_max = RAMSCRUB_TIMESTAMP() - start;
+	}
+
+	return pass_done;
+}
+
+boolean ramscrub_read_event(ramscrub_event* event)
+{
+	if (ramscrub_tail == ramscrub_head)
+	{
+		return FALSE;
+	}
+
+	*event = ramscrub_log[ramscrub_tail & (RAMSCRUB_LOG_SIZE - 1U)];
+	ramscrub_tail++;
+
+	return TRUE;
+}
+
+void ramscrub_get_stats(ramscrub_stats* stats)
+{
+	*stats = ramscrub_state;
+}
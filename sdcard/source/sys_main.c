@@ -52,6 +52,11 @@
 /* USER CODE BEGIN (1) */
 #include "usdcard.h"
 #include "usdcard_tests.h"
+#include "ramscrub.h"
+#include "bistsched.h"
+#include "esmlog.h"
+#include "logbin.h"
+#include "telemetry.h"
 #include "error.h"
 #include <stdio.h>
 #include "ti_fee.h"
@@ -89,26 +94,82 @@ int main(void)
 	buffer[2] = 0x35;
 	buffer[3] = 0x45;
 	uint32 address = 0x00014000;
+	esmlog_event esm_event;
+	uint8 esm_payload[ESMLOG_PAYLOAD_SIZE];
+	boolean esm_logged;
+	uint8 retv;
+	ramscrub_event ram_event;
+
+	// Report the results as telemetry records, time stamped with the PMU cycle counter
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	telemetry_init(TELEMETRY_SOURCE_SDCARD);
 
 	oReturnCheck = Fapi_initializeFlashBanks(80);
-	printf("Initialize Flash Banks return: %d\n", oReturnCheck);
+	telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_INIT_BANKS, oReturnCheck));
 	oReturnCheck = Fapi_setActiveFlashBank(Fapi_FlashBank0);
-	printf("Set Active Flash Bank return: %d\n", oReturnCheck);
+	telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_ACTIVE_BANK, oReturnCheck));
 	oReturnCheck = Fapi_enableMainBankSectors(0xFFFF);
-	printf("enable main bank sectors return: %d\n", oReturnCheck);
+	telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_SECTORS, oReturnCheck));
 	while(Fapi_checkFsmForReady() != Fapi_Status_FsmReady);
 	oReturnCheck = Fapi_issueProgrammingCommand((uint32*)address, buffer, (uint8)4, 0, 0, Fapi_DataOnly);
 	while(Fapi_checkFsmForReady() == Fapi_Status_FsmBusy);
-	printf("Return check %d\n", oReturnCheck);
-	printf("FSM Status %d\n", Fapi_getFsmStatus());
-	while(Fapi_checkFsmForReady() == Fapi_Status_FsmBusy);
-
-	printf("Return of programming command %d\n", oReturnCheck);
-
-	printf("After wait while\n");
-
-	// Wait here if the tests are successful
-	while(1);
+	telemetry_put(TELEMETRY_FLASH_PROGRAM, address, TELEMETRY_DETAIL(4U, oReturnCheck));
+	telemetry_put(TELEMETRY_FAPI_STATUS, Fapi_getFsmStatus(), TELEMETRY_DETAIL(TELEMETRY_FAPI_PROGRAM, oReturnCheck));
+	(void) telemetry_flush();
+
+	// Log the ESM events to the card; without a card they are sent as telemetry
+	retv = usd_init();
+	if (retv != SUCCESS)
+	{
+		telemetry_put(TELEMETRY_SD_ERROR, 0U, TELEMETRY_DETAIL(TELEMETRY_SD_INIT, retv));
+	}
+	else if ((retv = logbin_mount(ESMLOG_LOG_FIRST_BLOCK, ESMLOG_LOG_BLOCKS)) != LOGBIN_OK)
+	{
+		telemetry_put(TELEMETRY_SD_ERROR, ESMLOG_LOG_FIRST_BLOCK, TELEMETRY_DETAIL(TELEMETRY_SD_READ, retv));
+	}
+	(void) telemetry_flush();
+
+	// Scrub the RAM and re-run the PBIST tests in the idle loop
+	ramscrub_init();
+	bistsched_init(BISTSCHED_ALL);
+	while(1)
+	{
+		(void) ramscrub_step();
+		(void) bistsched_step();
+
+		// Report the RAM errors the scrubber found
+		while (ramscrub_read_event(&ram_event))
+		{
+			telemetry_put(TELEMETRY_ECC_ERROR, ram_event.address,
+						  TELEMETRY_DETAIL(TELEMETRY_ECC_RAM_SINGLE + ram_event.type - RAMSCRUB_EVENT_SINGLE,
+										   (ram_event.count > 255U) ? 255U : ram_event.count));
+		}
+
+		// Hand the ESM events to the binary log. An event the log does not
+		// take is sent as telemetry instead, so the ring never fills up.
+		esm_logged = FALSE;
+		while (esmlog_peek(&esm_event))
+		{
+			esmlog_encode(&esm_event, esm_payload);
+			if (logbin_append(ESMLOG_RECORD_TYPE, esm_event.timestamp, esm_payload, ESMLOG_PAYLOAD_SIZE) == LOGBIN_OK)
+			{
+				esm_logged = TRUE;
+			}
+			else
+			{
+				telemetry_put(TELEMETRY_ESM_EVENT, esm_event.status, TELEMETRY_DETAIL(esm_event.group, esm_event.channel));
+			}
+			esmlog_release();
+		}
+		if (esm_logged)
+		{
+			// Write the partly filled sector too, the events are rare
+			(void) logbin_flush();
+		}
+		(void) telemetry_flush();
+	}
 /* USER CODE END */
 
     return 0;
@@ -5,6 +5,9 @@
  */
 
 #include "usdcard.h"
+#include "usdcard_crc.h"
+#include "reg_mibspi.h"
+#include <string.h>
 
 //
 // SPI1 configuration parameters (see HALCOGEN configuration on SPI1 peripheral).
@@ -16,13 +19,269 @@ spiDAT1_t usd_dtconf = { .CS_HOLD = TRUE, .WDEL = FALSE, .DFSEL = SPI_FMT_0, .CS
 //
 uint8 sdtype = 0;
 
+//
+// Read-ahead window used by usd_read_block_cached().
+//
+static uint8 usd_rcache[USD_READ_AHEAD_BLOCKS * 512];
+static uint32 usd_rcache_start = 0;
+static uint32 usd_rcache_count = 0;
+
+//
+// State of the background sector transfer (see usd_xfer_write_start()).
+//
+static struct
+{
+	uint8 state;		// USD_XFER_IDLE/BUSY/DONE/ERROR
+	uint8 write;		// TRUE for a write, FALSE for a read
+	uint8 card_busy;	// TRUE while waiting for the card to leave the busy state
+	uint8* data;		// caller buffer
+	uint16 offset;		// first byte of the chunk being shifted
+	uint16 timeout;		// busy polls left before giving up
+	usd_xfer_counters counters;
+}
+usd_xfer = { USD_XFER_IDLE, FALSE, FALSE, 0, 0, 0, { 0, 0 } };
+
+//
+// CRC7 (x^7 + x^3 + 1) of every byte value, used to build the command frames.
+//
+static const uint8 usd_crc7_table[256] =
+{
+	0x00, 0x09, 0x12, 0x1B, 0x24, 0x2D, 0x36, 0x3F,
+	0x48, 0x41, 0x5A, 0x53, 0x6C, 0x65, 0x7E, 0x77,
+	0x19, 0x10, 0x0B, 0x02, 0x3D, 0x34, 0x2F, 0x26,
+	0x51, 0x58, 0x43, 0x4A, 0x75, 0x7C, 0x67, 0x6E,
+	0x32, 0x3B, 0x20, 0x29, 0x16, 0x1F, 0x04, 0x0D,
+	0x7A, 0x73, 0x68, 0x61, 0x5E, 0x57, 0x4C, 0x45,
+	0x2B, 0x22, 0x39, 0x30, 0x0F, 0x06, 0x1D, 0x14,
+	0x63, 0x6A, 0x71, 0x78, 0x47, 0x4E, 0x55, 0x5C,
+	0x64, 0x6D, 0x76, 0x7F, 0x40, 0x49, 0x52, 0x5B,
+	0x2C, 0x25, 0x3E, 0x37, 0x08, 0x01, 0x1A, 0x13,
+	0x7D, 0x74, 0x6F, 0x66, 0x59, 0x50, 0x4B, 0x42,
+	0x35, 0x3C, 0x27, 0x2E, 0x11, 0x18, 0x03, 0x0A,
+	0x56, 0x5F, 0x44, 0x4D, 0x72, 0x7B, 0x60, 0x69,
+	0x1E, 0x17, 0x0C, 0x05, 0x3A, 0x33, 0x28, 0x21,
+	0x4F, 0x46, 0x5D, 0x54, 0x6B, 0x62, 0x79, 0x70,
+	0x07, 0x0E, 0x15, 0x1C, 0x23, 0x2A, 0x31, 0x38,
+	0x41, 0x48, 0x53, 0x5A, 0x65, 0x6C, 0x77, 0x7E,
+	0x09, 0x00, 0x1B, 0x12, 0x2D, 0x24, 0x3F, 0x36,
+	0x58, 0x51, 0x4A, 0x43, 0x7C, 0x75, 0x6E, 0x67,
+	0x10, 0x19, 0x02, 0x0B, 0x34, 0x3D, 0x26, 0x2F,
+	0x73, 0x7A, 0x61, 0x68, 0x57, 0x5E, 0x45, 0x4C,
+	0x3B, 0x32, 0x29, 0x20, 0x1F, 0x16, 0x0D, 0x04,
+	0x6A, 0x63, 0x78, 0x71, 0x4E, 0x47, 0x5C, 0x55,
+	0x22, 0x2B, 0x30, 0x39, 0x06, 0x0F, 0x14, 0x1D,
+	0x25, 0x2C, 0x37, 0x3E, 0x01, 0x08, 0x13, 0x1A,
+	0x6D, 0x64, 0x7F, 0x76, 0x49, 0x40, 0x5B, 0x52,
+	0x3C, 0x35, 0x2E, 0x27, 0x18, 0x11, 0x0A, 0x03,
+	0x74, 0x7D, 0x66, 0x6F, 0x50, 0x59, 0x42, 0x4B,
+	0x17, 0x1E, 0x05, 0x0C, 0x33, 0x3A, 0x21, 0x28,
+	0x5F, 0x56, 0x4D, 0x44, 0x7B, 0x72, 0x69, 0x60,
+	0x0E, 0x07, 0x1C, 0x15, 0x2A, 0x23, 0x38, 0x31,
+	0x46, 0x4F, 0x54, 0x5D, 0x62, 0x6B, 0x70, 0x79
+};
+
+//
+// SPI driver calls issued by the card functions (see usd_get_spi_counters()).
+//
+static usd_spi_counters usd_counters = { 0, 0, 0, 0 };
+
+//
+// All the SPI traffic to the card goes through these two functions, so
+// every transfer of n words costs one driver call and is accounted for.
+//
+static uint32 usd_spi_tx(uint16* buffer, uint32 n)
+{
+	usd_counters.calls++;
+	usd_counters.words += n;
+
+	return spiTransmitData(spiREG1, &usd_dtconf, n, buffer);
+}
+
+static uint32 usd_spi_rx(uint16* buffer, uint32 n)
+{
+	usd_counters.calls++;
+	usd_counters.words += n;
+
+	return spiReceiveData(spiREG1, &usd_dtconf, n, buffer);
+}
+
+//
+// Same as usd_spi_tx()/usd_spi_rx() for byte-packed buffers. The bytes are
+// widened to DAT1 words here, as spiTransmitData() does for 16 bit buffers.
+//
+static uint32 usd_spi_tx8(const uint8* buffer, uint32 n)
+{
+	volatile uint32 SpiBuf;
+	uint32 control = ((uint32)usd_dtconf.DFSEL << 24U)
+				   | ((uint32)usd_dtconf.CSNR << 16U)
+				   | (usd_dtconf.WDEL ? 0x04000000U : 0U)
+				   | (usd_dtconf.CS_HOLD ? 0x10000000U : 0U);
+
+	usd_counters.calls++;
+	usd_counters.words += n;
+
+	while (n != 0U)
+	{
+		if ((spiREG1->FLG & 0x000000FFU) != 0U)
+		{
+			break;
+		}
+
+		// Chip select hold is released on the last byte
+		if (n == 1U)
+		{
+			control &= ~0x10000000U;
+		}
+
+		spiREG1->DAT1 = control | (uint32)*buffer++;
+
+		while ((spiREG1->FLG & 0x00000100U) != 0x00000100U)
+		{
+		} /* Wait */
+		SpiBuf = spiREG1->BUF;
+
+		n--;
+	}
+
+	(void)SpiBuf;
+
+	return (spiREG1->FLG & 0xFFU);
+}
+
+static uint32 usd_spi_rx8(uint8* buffer, uint32 n)
+{
+	uint32 control = ((uint32)usd_dtconf.DFSEL << 24U)
+				   | ((uint32)usd_dtconf.CSNR << 16U)
+				   | (usd_dtconf.WDEL ? 0x04000000U : 0U)
+				   | (usd_dtconf.CS_HOLD ? 0x10000000U : 0U);
+
+	usd_counters.calls++;
+	usd_counters.words += n;
+
+	while (n != 0U)
+	{
+		if ((spiREG1->FLG & 0x000000FFU) != 0U)
+		{
+			break;
+		}
+
+		// Chip select hold is released on the last byte
+		if (n == 1U)
+		{
+			control &= ~0x10000000U;
+		}
+
+		spiREG1->DAT1 = control;
+
+		while ((spiREG1->FLG & 0x00000100U) != 0x00000100U)
+		{
+		} /* Wait */
+		*buffer++ = (uint8)spiREG1->BUF;
+
+		n--;
+	}
+
+	return (spiREG1->FLG & 0xFFU);
+}
+
+//
+// Data phase of one sector, from a 16 bit (data) or a byte-packed (data8) buffer.
+// Exactly one of the two pointers is used, the other one is NULL.
+//
+static void usd_data_tx(const uint16* data, const uint8* data8)
+{
+	if (data8)
+	{
+		usd_spi_tx8(data8, 512U);
+	}
+	else
+	{
+		usd_spi_tx((uint16*)data, 512U);
+	}
+}
+
+static void usd_data_rx(uint16* data, uint8* data8)
+{
+	if (data8)
+	{
+		usd_spi_rx8(data8, 512U);
+	}
+	else
+	{
+		usd_spi_rx(data, 512U);
+	}
+}
+
+//
+// CRC7 of the first length bytes of a command frame, one table lookup per byte.
+//
+static uint8 usd_crc7(const uint16* frame, uint32 length)
+{
+	uint8 crc = 0;
+	uint32 i;
+
+	for (i = 0; i < length; i++)
+	{
+		crc = usd_crc7_table[(uint8)(crc << 1) ^ (uint8)frame[i]];
+	}
+
+	return crc;
+}
+
+//
+// Fills the two CRC bytes sent after a data block. Without USD_DATA_CRC
+// they keep the 0xFF dummy value, which the card ignores in non-CRC mode.
+//
+static void usd_data_crc_fill(const uint16* data, const uint8* data8, uint16* crc)
+{
+#if USD_DATA_CRC
+	uint16 value = data8 ? usd_crc16_8(data8, 512U) : usd_crc16(data, 512U);
+
+	crc[0] = value >> 8;
+	crc[1] = value & 0x00FF;
+#else
+	(void) data;
+	(void) data8;
+	(void) crc;
+#endif
+}
+
+//
+// Checks the two CRC bytes received after a data block.
+// Returns SUCCESS when they match or when USD_DATA_CRC is disabled.
+//
+static uint8 usd_data_crc_check(const uint16* data, const uint8* data8, const uint16* crc)
+{
+#if USD_DATA_CRC
+	uint16 value = data8 ? usd_crc16_8(data8, 512U) : usd_crc16(data, 512U);
+
+	if (((crc[0] & 0x00FF) << 8 | (crc[1] & 0x00FF)) != value)
+	{
+		usd_counters.crc_errors++;
+		return USD_ERROR_DATA_CRC;
+	}
+#else
+	(void) data;
+	(void) data8;
+	(void) crc;
+#endif
+
+	return SUCCESS;
+}
+
 uint8 usd_init()
 {
 	uint16 i;
 	uint16 r1 = 0x00FF;
-	uint16 buffer[] = { 0xFFFF };
+	uint16 buffer[16];
 	uint16 rspbuffer[] = { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF };
 
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
 	if (usd_check_card_presence())
 	{
 		return USD_ERROR_CARD_NOT_DETECTED;
@@ -32,8 +291,9 @@ uint8 usd_init()
 	gioSetBit(spiPORT1, 0, 1);
 	for (i = 0; i < 16; i++)
 	{
-		spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
+		buffer[i] = 0xFFFF;
 	}
+	usd_spi_tx(buffer, 16U);
 
 	// CMD0 with CS = 0 (CMD0+)
 	usd_spi_enable_card();
@@ -43,7 +303,7 @@ uint8 usd_init()
 	for (i = 0; i < 100; i++)
 	{
 		if (r1 == 0x0001) {	break; }
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 	}
 
 	// If the response is not the expected disable the SPI and return a error state
@@ -53,6 +313,18 @@ uint8 usd_init()
 		return USD_ERROR_IDLE_STATE;
 	}
 
+#if USD_CRC_MODE
+	// CMD59 - Turns the CRC check on. From now on the card rejects any
+	// command or data block with a wrong CRC.
+	r1 = usd_send_command(USD_CMD59_CRC_ON_OFF, 0x00000001);
+
+	if (r1 != 0x0001)
+	{
+		usd_spi_disable_card();
+		return USD_ERROR_CRC_ON_OFF;
+	}
+#endif
+
 	// CMD8 - This command asks to the card if it can operate on the voltage range of 2.7-3.6V (0b0001)
 	// If the response is not 'illegal command' the card is a Version 2.00+ card
 	// Otherwise, the card is from type Ver1.X ou is not a card
@@ -62,19 +334,14 @@ uint8 usd_init()
 	for (i = 0; i < 100; i++)
 	{
 		if (r1 == 0x0001) { break; }
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 	}
 
 	// If CMD8 command is successful  => Card from type Ver2.00+
 	if (r1 == 0x0001)
 	{
-		uint8 j;
-
 		// Read the remaining 4 bytes from the R7 response (total 40 bits).
-		for (j = 0; j < 4; ++j)
-		{
-			spiReceiveData(spiREG1, &usd_dtconf, 1U, (rspbuffer + j));
-		}
+		usd_spi_rx(rspbuffer, 4U);
 
 		// Verifies if the card response contains the supply voltage.
 		// Checks also the echo of the check pattern.
@@ -94,7 +361,7 @@ uint8 usd_init()
 		do
 		{
 			r1 = usd_send_command(USD_CMD55_APP_CMD, 0);
-			r1 = usd_send_command(USD_ACMD41_SD_SEND_OP_COND, 0);
+			r1 = usd_send_command(USD_ACMD41_SD_SEND_OP_COND, 0x40000000); // HCS
 
 			// If response is successful
 			if (r1 == 0x0000)
@@ -119,10 +386,7 @@ uint8 usd_init()
 		if (r1 == 0)
 		{
 			// Reading the last 4 bytes from R3 response
-			for (j = 0; j < 4; ++j)
-			{
-				spiReceiveData(spiREG1, &usd_dtconf, 1U, (rspbuffer + j));
-			}
+			usd_spi_rx(rspbuffer, 4U);
 
 			// Verifying the state of CCS (Card Capacity Status) bit.
 			// If it is on we have a SDHC or SDXC card.
@@ -163,114 +427,33 @@ uint16 usd_send_command(uint8 cmd, uint32 arg)
 {
 	uint16 j;
 	uint16 buffer[] = { 0x0000 };
-
-	switch(cmd)
-	{
-		case USD_CMD0_GO_IDLE_STATE:
-			buffer[0] = 0x0040;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0095;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer); // pre-calculated crc
-		break;
-
-		case USD_CMD8_SEND_IF_COND:
-			buffer[0] = 0x0048;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0001;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00AA;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0087;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer); // pre-calculated crc
-		break;
-
-		case USD_CMD55_APP_CMD:
-			buffer[0] = 0x0077;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_ACMD41_SD_SEND_OP_COND:
-			buffer[0] = 0x0069;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0040;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD58_READ_OCR:
-			buffer[0] = 0x007A;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD13_SEND_STATUS:
-			buffer[0] = 0x004D;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x0000;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD24_WRITE_BLOCK:
-			buffer[0] = 0x0058;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0xFF000000) >> 24; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x00FF0000) >> 16; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x0000FF00) >> 8;  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x000000FF); 	  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD17_READ_SINGLE_BLOCK:
-			buffer[0] = 0x0051;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0xFF000000) >> 24; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x00FF0000) >> 16; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x0000FF00) >> 8;  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x000000FF); 	  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD32_ERASE_WR_BLK_START_ADDRESS:
-			buffer[0] = 0x0060;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0xFF000000) >> 24; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x00FF0000) >> 16; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x0000FF00) >> 8;  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x000000FF); 	  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD33_ERASE_WR_BLK_END_ADDRESS:
-			buffer[0] = 0x0061;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0xFF000000) >> 24; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x00FF0000) >> 16; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x0000FF00) >> 8;  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x000000FF); 	  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
-
-		case USD_CMD38_ERASE:
-			buffer[0] = 0x0066;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0xFF000000) >> 24; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x00FF0000) >> 16; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x0000FF00) >> 8;  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = (arg & 0x000000FF); 	  spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-			buffer[0] = 0x00FF;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-		break;
+	uint16 frame[USD_CDM_SIZE];
+
+	// Start bit + transmission bit + command index, argument (MSB first)
+	// and CRC7 + end bit. The same frame serves every command.
+	frame[0] = 0x0040 | (cmd & 0x3F);
+	frame[1] = (arg & 0xFF000000) >> 24;
+	frame[2] = (arg & 0x00FF0000) >> 16;
+	frame[3] = (arg & 0x0000FF00) >> 8;
+	frame[4] = (arg & 0x000000FF);
+	frame[5] = (uint16)(usd_crc7(frame, USD_CDM_SIZE - 1U) << 1) | 0x0001;
+
+	// The whole command frame goes out in a single SPI transfer
+	usd_spi_tx(frame, USD_CDM_SIZE);
+
+	// Discard the stuff byte that follows CMD12
+	if (cmd == USD_CMD12_STOP_TRANSMISSION)
+	{
+		usd_spi_rx(buffer, 1U);
 	}
 
+	// The R1 response is the first byte with the MSB cleared. Checking only
+	// for 0xFF would take the tail of a CMD18 data block as the CMD12 response.
 	for (j = 0; j < 8; ++j)
 	{
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 
-		if (buffer[0] != 0x00FF)
+		if ((buffer[0] & 0x0080) == 0)
 		{
 			break;
 		}
@@ -279,12 +462,21 @@ uint16 usd_send_command(uint8 cmd, uint32 arg)
 	return buffer[0];
 }
 
-uint8 usd_write_block(uint16* data, uint32 blkaddr)
+static uint8 usd_write_block_any(const uint16* data, const uint8* data8, uint32 blkaddr)
 {
 	uint16 i;
 	uint16 buffer[] = { 0x0000 };
+	uint16 crc[] = { 0x00FF, 0x00FF };
 	uint16 r1 = 0x00FF;
 
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
+	usd_read_cache_invalidate();
+
 	// Enables the card (CS = 0)
 	usd_spi_enable_card();
 
@@ -299,17 +491,19 @@ uint8 usd_write_block(uint16* data, uint32 blkaddr)
 	}
 
 	// Data Token transmission. Its used in the commands CMD17/CMD18/CMD24
-	buffer[0] = 0x00FE;	spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
+	buffer[0] = 0x00FE;	usd_spi_tx(buffer, 1U);
 
 	// Send the data to the card
-	spiTransmitData(spiREG1, &usd_dtconf, 512U, data);
+	usd_data_tx(data, data8);
 
-	// Sends two dummy bytes for the CRC
-	buffer[0] = 0x00FF; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
-	buffer[0] = 0x00FF; spiTransmitData(spiREG1, &usd_dtconf, 1U, buffer);
+	// Sends the two CRC bytes
+	usd_data_crc_fill(data, data8, crc);
+	usd_spi_tx(crc, 2U);
+
+	usd_counters.sectors++;
 
 	// Reads the Response Token
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+	usd_spi_rx(buffer, 1U);
 
 	// Checks the Response Token to verify if the data was accepted.
 	// If not, disable the card and return an error code.
@@ -325,7 +519,7 @@ uint8 usd_write_block(uint16* data, uint32 blkaddr)
 	i = 0xFFFF; // Timeout variable
 	do
 	{
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 	}
 	while(buffer[0] == 0x0000 && --i);
 
@@ -342,12 +536,141 @@ uint8 usd_write_block(uint16* data, uint32 blkaddr)
 	return SUCCESS;
 }
 
-uint8 usd_read_block(uint16* data, uint32 blkaddr)
+//
+// Ends a CMD25 once the command was accepted, on success and on every error:
+// sends the Stop Tran token, waits for the card to finish the programming and
+// disables the card. Without the token the card stays in the receive-data
+// state and rejects the next command.
+//
+static uint8 usd_write_blocks_stop(void)
+{
+	uint16 i;
+	uint16 buffer[] = { 0x0000 };
+
+	// Stop Tran Token - Ends the multiple block write
+	buffer[0] = USD_TOKEN_STOP_TRAN; usd_spi_tx(buffer, 1U);
+
+	// One byte gap before the card signals busy
+	usd_spi_rx(buffer, 1U);
+
+	// Wait the card to finish the programming
+	i = 0xFFFF; // Timeout variable
+	do
+	{
+		usd_spi_rx(buffer, 1U);
+	}
+	while(buffer[0] == 0x0000 && --i);
+
+	// Disables the card (CS = 1)
+	usd_spi_disable_card();
+
+	// Writing timout. Returns an error code
+	return (i == 0) ? 1 : SUCCESS;
+}
+
+static uint8 usd_write_blocks_any(const uint16* data, const uint8* data8, uint32 blkaddr_start, uint32 count)
 {
 	uint16 i;
+	uint32 blk;
+	uint16 buffer[] = { 0x0000 };
+	uint16 crc[] = { 0x00FF, 0x00FF };
+	uint16 r1 = 0x00FF;
+
+	if (count == 0)
+	{
+		return SUCCESS;
+	}
+
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
+	usd_read_cache_invalidate();
+
+	// Enables the card (CS = 0)
+	usd_spi_enable_card();
+
+#if USD_MULTI_WRITE_PRE_ERASE
+	// ACMD23 - Number of blocks to be pre-erased before the writing
+	// A failure here is not fatal, the card just programs without pre-erase
+	usd_send_command(USD_CMD55_APP_CMD, 0);
+	usd_send_command(USD_ACMD23_SET_WR_BLK_ERASE_COUNT, count & 0x007FFFFF);
+#endif
+
+	// CMD25 - Send a command to write multiple blocks
+	r1 = usd_send_command(USD_CMD25_WRITE_MULTIPLE_BLOCK, blkaddr_start);
+
+	// If the CMD25 fails, disable CS and returns an error code
+	if (r1 != 0)
+	{
+		usd_spi_disable_card();
+		return 1;
+	}
+
+	// One dummy byte before the first data token
+	buffer[0] = 0x00FF; usd_spi_tx(buffer, 1U);
+
+	for (blk = 0; blk < count; blk++)
+	{
+		// Data Token transmission. Each block of the CMD25 has its own token
+		buffer[0] = USD_TOKEN_START_MULTI_WRITE; usd_spi_tx(buffer, 1U);
+
+		// Send the data to the card
+		usd_data_tx(data, data8);
+
+		// Sends the two CRC bytes
+		usd_data_crc_fill(data, data8, crc);
+		usd_spi_tx(crc, 2U);
+
+		usd_counters.sectors++;
+
+		// Reads the Response Token
+		usd_spi_rx(buffer, 1U);
+
+		// Checks the Response Token to verify if the data was accepted.
+		// If not, stop the transaction, disable the card and return an error code.
+		if (((buffer[0] & 0x000E) >> 1) != 0x0002)
+		{
+			(void) usd_write_blocks_stop();
+			return 1;
+		}
+
+		// Wait the card to leave the busy state before the next block
+		i = 0xFFFF; // Timeout variable
+		do
+		{
+			usd_spi_rx(buffer, 1U);
+		}
+		while(buffer[0] == 0x0000 && --i);
+
+		// Writing timout. The card must still leave the receive-data state
+		if (i == 0)
+		{
+			(void) usd_write_blocks_stop();
+			return 1;
+		}
+
+		// Next sector of the caller buffer
+		if (data) { data += 512U; } else { data8 += 512U; }
+	}
+
+	return usd_write_blocks_stop();
+}
+
+static uint8 usd_read_block_any(uint16* data, uint8* data8, uint32 blkaddr)
+{
 	uint16 buffer[] = { 0x0000 };
+	uint16 crc[] = { 0x00FF, 0x00FF };
 	uint16 r1 = 0x00FF, timeout;
 
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
 	// Enables the card (CS = 0)
 	usd_spi_enable_card();
 
@@ -363,7 +686,7 @@ uint8 usd_read_block(uint16* data, uint32 blkaddr)
 	// Wait to receive the Start Block Token
 	for (timeout = 1000; timeout; timeout--)
 	{
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 
 		if (buffer[0] == 0x00FE) { break; }
 	}
@@ -375,28 +698,225 @@ uint8 usd_read_block(uint16* data, uint32 blkaddr)
 		return 1;
 	}
 
-	// Write the data
-	for (i = 0; i < 512; i++)
+	// Read the whole block in one transfer
+	usd_data_rx(data, data8);
+
+	// Read two CRC bytes
+	usd_spi_rx(crc, 2U);
+
+	usd_counters.sectors++;
+
+	// Disables the card (CS = 1)
+	usd_spi_disable_card();
+
+	// Checks the block against its CRC, a bit flip on the link is reported as an error
+	return usd_data_crc_check(data, data8, crc);
+}
+
+static uint8 usd_read_blocks_any(uint16* data, uint8* data8, uint32 blkaddr_start, uint32 count)
+{
+	uint16 i;
+	uint32 blk;
+	uint16 buffer[] = { 0x0000 };
+	uint16 crc[] = { 0x00FF, 0x00FF };
+	uint16 r1 = 0x00FF, timeout;
+	uint8 retv = SUCCESS;
+
+	if (count == 0)
 	{
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, (data + i));
+		return SUCCESS;
 	}
 
-	// Read two CRC bytes
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
+	// Enables the card (CS = 0)
+	usd_spi_enable_card();
+
+	// CMD18 - The card streams blocks until it receives a CMD12
+	r1 = usd_send_command(USD_CMD18_READ_MULTIPLE_BLOCK, blkaddr_start);
+
+	if (r1 != 0)
+	{
+		usd_spi_disable_card();
+		return 1;
+	}
+
+	for (blk = 0; blk < count; blk++)
+	{
+		// Wait to receive the Start Block Token
+		for (timeout = 1000; timeout; timeout--)
+		{
+			usd_spi_rx(buffer, 1U);
+
+			if (buffer[0] == USD_TOKEN_START_BLOCK) { break; }
+		}
+
+		// If Start Block Token don't come, stop the transmission and return an error code
+		if (timeout == 0)
+		{
+			usd_send_command(USD_CMD12_STOP_TRANSMISSION, 0);
+			usd_spi_disable_card();
+			return 1;
+		}
+
+		// Read the data of this block
+		usd_data_rx(data, data8);
+
+		// Read two CRC bytes
+		usd_spi_rx(crc, 2U);
+
+		usd_counters.sectors++;
+
+		// A corrupted block does not stop the stream, the error is returned at the end
+		if (usd_data_crc_check(data, data8, crc) != SUCCESS)
+		{
+			retv = USD_ERROR_DATA_CRC;
+		}
+
+		// Next sector of the caller buffer
+		if (data) { data += 512U; } else { data8 += 512U; }
+	}
+
+	// CMD12 - Stops the stream of blocks
+	r1 = usd_send_command(USD_CMD12_STOP_TRANSMISSION, 0);
+
+	// Wait the card to leave the busy state (R1b response)
+	i = 0xFFFF; // Timeout variable
+	do
+	{
+		usd_spi_rx(buffer, 1U);
+	}
+	while(buffer[0] == 0x0000 && --i);
 
 	// Disables the card (CS = 1)
 	usd_spi_disable_card();
 
+	if (r1 != 0 || i == 0)
+	{
+		return 1;
+	}
+
+	return retv;
+}
+
+uint8 usd_write_block(uint16* data, uint32 blkaddr)
+{
+	return usd_write_block_any(data, 0, blkaddr);
+}
+
+uint8 usd_write_block8(const uint8* data, uint32 blkaddr)
+{
+	return usd_write_block_any(0, data, blkaddr);
+}
+
+uint8 usd_write_blocks(uint16* data, uint32 blkaddr_start, uint32 count)
+{
+	return usd_write_blocks_any(data, 0, blkaddr_start, count);
+}
+
+uint8 usd_write_blocks8(const uint8* data, uint32 blkaddr_start, uint32 count)
+{
+	return usd_write_blocks_any(0, data, blkaddr_start, count);
+}
+
+uint8 usd_read_block(uint16* data, uint32 blkaddr)
+{
+	return usd_read_block_any(data, 0, blkaddr);
+}
+
+uint8 usd_read_block8(uint8* data, uint32 blkaddr)
+{
+	return usd_read_block_any(0, data, blkaddr);
+}
+
+uint8 usd_read_blocks(uint16* data, uint32 blkaddr_start, uint32 count)
+{
+	return usd_read_blocks_any(data, 0, blkaddr_start, count);
+}
+
+uint8 usd_read_blocks8(uint8* data, uint32 blkaddr_start, uint32 count)
+{
+	return usd_read_blocks_any(0, data, blkaddr_start, count);
+}
+
+//
+// Makes sure blkaddr is in the read-ahead window and returns its bytes.
+//
+static uint8* usd_read_cache_lookup(uint32 blkaddr)
+{
+	// Miss - refill the whole window starting at the requested sector
+	if (usd_rcache_count == 0 || blkaddr < usd_rcache_start
+		|| blkaddr >= usd_rcache_start + usd_rcache_count)
+	{
+		usd_rcache_count = 0;
+
+		if (usd_read_blocks8(usd_rcache, blkaddr, USD_READ_AHEAD_BLOCKS))
+		{
+			return 0;
+		}
+
+		usd_rcache_start = blkaddr;
+		usd_rcache_count = USD_READ_AHEAD_BLOCKS;
+	}
+
+	return usd_rcache + ((blkaddr - usd_rcache_start) * 512U);
+}
+
+uint8 usd_read_block_cached(uint16* data, uint32 blkaddr)
+{
+	uint16 i;
+	uint8* src = usd_read_cache_lookup(blkaddr);
+
+	if (src == 0)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < 512; i++)
+	{
+		data[i] = src[i];
+	}
+
 	return SUCCESS;
 }
 
+uint8 usd_read_block8_cached(uint8* data, uint32 blkaddr)
+{
+	uint8* src = usd_read_cache_lookup(blkaddr);
+
+	if (src == 0)
+	{
+		return 1;
+	}
+
+	memcpy(data, src, 512U);
+
+	return SUCCESS;
+}
+
+void usd_read_cache_invalidate()
+{
+	usd_rcache_count = 0;
+}
+
 uint8 usd_erase_blocks(uint32 blkaddr_start, uint32 blkaddr_stop)
 {
 	uint16 timeout;
 	uint16 buffer[] = { 0x0000 };
 	uint16 r1 = 0x00FF;
 
+	// SPI1 belongs to the background transfer until usd_xfer_service() ends it
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return USD_ERROR_XFER_BUSY;
+	}
+
+	usd_read_cache_invalidate();
+
 	// Enables the card (CS = 0)
 	usd_spi_enable_card();
 
@@ -427,7 +947,7 @@ uint8 usd_erase_blocks(uint32 blkaddr_start, uint32 blkaddr_stop)
 	timeout = 0xFFFF; // Timeout variable
 	do
 	{
-		spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+		usd_spi_rx(buffer, 1U);
 	}
 	while(buffer[0] == 0x0000 && --timeout);
 
@@ -444,6 +964,310 @@ uint8 usd_erase_blocks(uint32 blkaddr_start, uint32 blkaddr_stop)
 	return SUCCESS;
 }
 
+//
+// Switches SPI1 to multi-buffer mode and starts shifting the next
+// USD_XFER_CHUNK words of the sector through transfer group 0.
+//
+static void usd_xfer_start_chunk(void)
+{
+	uint16 i;
+	uint16 control = (uint16)((uint16)4U << 13U)	// buffer mode: always transfer
+				   | (uint16)((uint16)1U << 12U)	// chip select hold
+				   | (uint16)SPI_CS_0;				// same chip select as usd_dtconf
+
+	mibspiREG1->MIBSPIE = (mibspiREG1->MIBSPIE & 0xFFFFFFFEU) | 1U;
+
+	// Transfer group 0 covers buffers 0 to USD_XFER_CHUNK - 1 and starts
+	// as soon as it is enabled (one shot, always triggered)
+	mibspiREG1->TGCTRL[1U] = (uint32)USD_XFER_CHUNK << 8U;
+	mibspiREG1->TGCTRL[0U] = (uint32)((uint32)1U << 30U)	// oneshot
+						   | (uint32)((uint32)7U << 20U)	// trigger event: always
+						   | (uint32)((uint32)0U << 16U)	// trigger source: disabled
+						   | (uint32)((uint32)0U << 8U);	// start buffer
+
+	for (i = 0; i < USD_XFER_CHUNK; i++)
+	{
+		mibspiRAM1->tx[i].control = (i == USD_XFER_CHUNK - 1U) ? (control & 0xEFFFU) : control;
+		mibspiRAM1->tx[i].data = usd_xfer.write ? (uint16)usd_xfer.data[usd_xfer.offset + i] : 0x0000;
+	}
+
+	// Clears a stale completion flag and enables the group
+	mibspiREG1->TGINTFLG = (uint32)1U << 16U;
+	mibspiREG1->TGCTRL[0U] |= 0x80000000U;
+
+	usd_xfer.counters.chunks++;
+}
+
+//
+// Ends the data phase: back to compatibility mode, CRC and response are
+// handled with the polling driver as in usd_write_block(). After a write the
+// card busy state is left to usd_xfer_service().
+//
+static uint8 usd_xfer_finish(void)
+{
+	uint16 buffer[] = { 0x0000 };
+	uint16 crc[] = { 0x00FF, 0x00FF };
+	uint8 retv = SUCCESS;
+
+	mibspiREG1->TGCTRL[0U] &= 0x7FFFFFFFU;
+	mibspiREG1->MIBSPIE = mibspiREG1->MIBSPIE & 0xFFFFFFFEU;
+
+	usd_counters.sectors++;
+
+	if (usd_xfer.write)
+	{
+		// Sends the two CRC bytes
+		usd_data_crc_fill(0, usd_xfer.data, crc);
+		usd_spi_tx(crc, 2U);
+
+		// Checks the Response Token to verify if the data was accepted
+		usd_spi_rx(buffer, 1U);
+
+		if (((buffer[0] & 0x000E) >> 1) == 0x0002)
+		{
+			// Data accepted, the card stays selected while it programs
+			usd_xfer.card_busy = TRUE;
+			usd_xfer.timeout = 0xFFFF;
+			return SUCCESS;
+		}
+
+		retv = 1;
+	}
+	else
+	{
+		// Read two CRC bytes and check them
+		usd_spi_rx(crc, 2U);
+		retv = usd_data_crc_check(0, usd_xfer.data, crc);
+	}
+
+	// Disables the card (CS = 1)
+	usd_spi_disable_card();
+
+	return retv;
+}
+
+uint8 usd_xfer_write_start(const uint8* data, uint32 blkaddr)
+{
+	uint16 buffer[] = { 0x0000 };
+	uint16 r1 = 0x00FF;
+
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return 1;
+	}
+
+	usd_read_cache_invalidate();
+
+	// Enables the card (CS = 0)
+	usd_spi_enable_card();
+
+	// CMD24 - Send a command to write a block
+	r1 = usd_send_command(USD_CMD24_WRITE_BLOCK, blkaddr);
+
+	if (r1 != 0)
+	{
+		usd_spi_disable_card();
+		usd_xfer.state = USD_XFER_ERROR;
+		return 1;
+	}
+
+	// Data Token transmission
+	buffer[0] = USD_TOKEN_START_BLOCK; usd_spi_tx(buffer, 1U);
+
+	usd_xfer.write = TRUE;
+	usd_xfer.card_busy = FALSE;
+	usd_xfer.data = (uint8*)data; // only read for a write
+	usd_xfer.offset = 0;
+	usd_xfer.state = USD_XFER_BUSY;
+
+	usd_xfer_start_chunk();
+
+	return SUCCESS;
+}
+
+uint8 usd_xfer_read_start(uint8* data, uint32 blkaddr)
+{
+	uint16 buffer[] = { 0x0000 };
+	uint16 r1 = 0x00FF, timeout;
+
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return 1;
+	}
+
+	// Enables the card (CS = 0)
+	usd_spi_enable_card();
+
+	// CMD17 - Send a command to read a block
+	r1 = usd_send_command(USD_CMD17_READ_SINGLE_BLOCK, blkaddr);
+
+	if (r1 != 0)
+	{
+		usd_spi_disable_card();
+		usd_xfer.state = USD_XFER_ERROR;
+		return 1;
+	}
+
+	// Wait to receive the Start Block Token
+	for (timeout = 1000; timeout; timeout--)
+	{
+		usd_spi_rx(buffer, 1U);
+
+		if (buffer[0] == USD_TOKEN_START_BLOCK) { break; }
+	}
+
+	if (timeout == 0)
+	{
+		usd_spi_disable_card();
+		usd_xfer.state = USD_XFER_ERROR;
+		return 1;
+	}
+
+	usd_xfer.write = FALSE;
+	usd_xfer.card_busy = FALSE;
+	usd_xfer.data = data;
+	usd_xfer.offset = 0;
+	usd_xfer.state = USD_XFER_BUSY;
+
+	usd_xfer_start_chunk();
+
+	return SUCCESS;
+}
+
+uint8 usd_xfer_erase_start(uint32 blkaddr_start, uint32 blkaddr_stop)
+{
+	uint16 r1 = 0x00FF;
+
+	if (usd_xfer.state == USD_XFER_BUSY)
+	{
+		return 1;
+	}
+
+	usd_read_cache_invalidate();
+
+	// Enables the card (CS = 0)
+	usd_spi_enable_card();
+
+	// CMD32/CMD33 - Range of sectors, CMD38 - Erase it
+	r1 = usd_send_command(USD_CMD32_ERASE_WR_BLK_START_ADDRESS, blkaddr_start);
+
+	if (r1 == 0)
+	{
+		r1 = usd_send_command(USD_CMD33_ERASE_WR_BLK_END_ADDRESS, blkaddr_stop);
+	}
+
+	if (r1 == 0)
+	{
+		r1 = usd_send_command(USD_CMD38_ERASE, 0x00);
+	}
+
+	if (r1 != 0)
+	{
+		usd_spi_disable_card();
+		usd_xfer.state = USD_XFER_ERROR;
+		return 1;
+	}
+
+	// No data phase, only the busy state is left
+	usd_xfer.write = TRUE;
+	usd_xfer.card_busy = TRUE;
+	usd_xfer.timeout = 0xFFFF;
+	usd_xfer.state = USD_XFER_BUSY;
+
+	return SUCCESS;
+}
+
+uint8 usd_xfer_service()
+{
+	uint16 i;
+	uint16 buffer[] = { 0x0000 };
+
+	if (usd_xfer.state != USD_XFER_BUSY)
+	{
+		return usd_xfer.state;
+	}
+
+	// One poll of the card busy state per call, so the caller never stalls
+	if (usd_xfer.card_busy)
+	{
+		usd_spi_rx(buffer, 1U);
+
+		if (buffer[0] == 0x0000 && --usd_xfer.timeout)
+		{
+			usd_xfer.counters.busy_polls++;
+			return USD_XFER_BUSY;
+		}
+
+		usd_xfer.card_busy = FALSE;
+		usd_xfer.state = (usd_xfer.timeout != 0) ? USD_XFER_DONE : USD_XFER_ERROR;
+
+		// Disables the card (CS = 1)
+		usd_spi_disable_card();
+		spiEndNotification(spiREG1);
+
+		return usd_xfer.state;
+	}
+
+	// The chunk is still being shifted, the CPU is free for other work
+	if ((mibspiREG1->TGINTFLG & ((uint32)1U << 16U)) == 0U)
+	{
+		usd_xfer.counters.busy_polls++;
+		return USD_XFER_BUSY;
+	}
+
+	mibspiREG1->TGINTFLG = (uint32)1U << 16U;
+
+	if (!usd_xfer.write)
+	{
+		for (i = 0; i < USD_XFER_CHUNK; i++)
+		{
+			usd_xfer.data[usd_xfer.offset + i] = (uint8)mibspiRAM1->rx[i].data;
+		}
+	}
+
+	usd_xfer.offset += USD_XFER_CHUNK;
+
+	if (usd_xfer.offset < 512U)
+	{
+		usd_xfer_start_chunk();
+		return USD_XFER_BUSY;
+	}
+
+	if (usd_xfer_finish() != SUCCESS)
+	{
+		usd_xfer.state = USD_XFER_ERROR;
+	}
+	else if (!usd_xfer.card_busy)
+	{
+		usd_xfer.state = USD_XFER_DONE;
+	}
+	else
+	{
+		return USD_XFER_BUSY;
+	}
+
+	// Completion is reported through the HALCoGen SPI end notification
+	spiEndNotification(spiREG1);
+
+	return usd_xfer.state;
+}
+
+uint8 usd_xfer_status()
+{
+	return usd_xfer.state;
+}
+
+void usd_get_xfer_counters(usd_xfer_counters* counters)
+{
+	*counters = usd_xfer.counters;
+}
+
+void usd_reset_xfer_counters()
+{
+	usd_xfer.counters.chunks = 0;
+	usd_xfer.counters.busy_polls = 0;
+}
+
 void usd_spi_enable_card()
 {
 	// Put the Chip Select in a LOW logic state
@@ -452,21 +1276,29 @@ void usd_spi_enable_card()
 
 void usd_spi_disable_card()
 {
-	uint16 buffer[] = { 0x0000 };
+	uint16 buffer[6];
 
 	// Put the Chip Select in a HIGH logic state
 	gioSetBit(spiPORT1, 0, 1);
 
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
-	spiReceiveData(spiREG1, &usd_dtconf, 1U, buffer);
+	// Extra clocks so the card releases the MISO line
+	usd_spi_rx(buffer, 6U);
 }
 
 uint32 usd_check_card_presence()
 {
 	return gioGetBit(hetPORT1, 24);
 }
+
+void usd_get_spi_counters(usd_spi_counters* counters)
+{
+	*counters = usd_counters;
+}
+
+void usd_reset_spi_counters()
+{
+	usd_counters.calls = 0;
+	usd_counters.words = 0;
+	usd_counters.sectors = 0;
+	usd_counters.crc_errors = 0;
+}
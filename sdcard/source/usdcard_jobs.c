@@ -0,0 +1,154 @@
+/**
+ *	\file usdcard_jobs.c
+ *	\brief Queue of asynchronous read, write and erase jobs on top of the
+ *	background transfers of usdcard.c.
+ */
+
+#include "usdcard.h"
+#include "usdcard_jobs.h"
+
+#define USD_JOB_READ	0x00
+#define USD_JOB_WRITE	0x01
+#define USD_JOB_ERASE	0x02
+
+typedef struct
+{
+	uint8 type;
+	uint8* data;
+	uint32 blkaddr;
+	uint32 blkaddr_stop;
+	volatile uint8* result;
+}
+usd_job;
+
+//
+// Bounded ring of jobs. The job at usd_job_head is the running one once
+// usd_job_running is TRUE.
+//
+static usd_job usd_jobs[USD_JOB_QUEUE_SIZE];
+static uint8 usd_job_head = 0;
+static uint8 usd_job_count = 0;
+static uint8 usd_job_running = FALSE;
+static uint8 usd_job_last_result = USD_JOB_OK;
+
+static uint8 usd_job_push(uint8 type, uint8* data, uint32 blkaddr, uint32 blkaddr_stop, volatile uint8* result)
+{
+	usd_job* job;
+
+	if (usd_job_count == USD_JOB_QUEUE_SIZE)
+	{
+		return USD_ERROR_QUEUE_FULL;
+	}
+
+	job = &usd_jobs[(usd_job_head + usd_job_count) % USD_JOB_QUEUE_SIZE];
+	job->type = type;
+	job->data = data;
+	job->blkaddr = blkaddr;
+	job->blkaddr_stop = blkaddr_stop;
+	job->result = result;
+
+	if (result)
+	{
+		*result = USD_JOB_PENDING;
+	}
+
+	usd_job_count++;
+
+	return SUCCESS;
+}
+
+//
+// Removes the running job from the queue and publishes its result.
+//
+static void usd_job_end(uint8 result)
+{
+	usd_job* job = &usd_jobs[usd_job_head];
+
+	if (job->result)
+	{
+		*job->result = result;
+	}
+
+	usd_job_last_result = result;
+	usd_job_running = FALSE;
+	usd_job_head = (usd_job_head + 1U) % USD_JOB_QUEUE_SIZE;
+	usd_job_count--;
+}
+
+uint8 usd_job_read(uint8* data, uint32 blkaddr, volatile uint8* result)
+{
+	return usd_job_push(USD_JOB_READ, data, blkaddr, 0, result);
+}
+
+uint8 usd_job_write(const uint8* data, uint32 blkaddr, volatile uint8* result)
+{
+	return usd_job_push(USD_JOB_WRITE, (uint8*)data, blkaddr, 0, result);
+}
+
+uint8 usd_job_erase(uint32 blkaddr_start, uint32 blkaddr_stop, volatile uint8* result)
+{
+	return usd_job_push(USD_JOB_ERASE, 0, blkaddr_start, blkaddr_stop, result);
+}
+
+void usd_main_function()
+{
+	usd_job* job;
+	uint8 retv, state;
+
+	if (usd_job_count == 0)
+	{
+		return;
+	}
+
+	job = &usd_jobs[usd_job_head];
+
+	// Start the job at the head of the queue
+	if (!usd_job_running)
+	{
+		switch(job->type)
+		{
+			case USD_JOB_READ:
+				retv = usd_xfer_read_start(job->data, job->blkaddr);
+			break;
+
+			case USD_JOB_WRITE:
+				retv = usd_xfer_write_start(job->data, job->blkaddr);
+			break;
+
+			default:
+				retv = usd_xfer_erase_start(job->blkaddr, job->blkaddr_stop);
+			break;
+		}
+
+		if (retv != SUCCESS)
+		{
+			usd_job_end(USD_JOB_FAILED);
+			return;
+		}
+
+		usd_job_running = TRUE;
+		return;
+	}
+
+	// One step of the running job
+	state = usd_xfer_service();
+
+	if (state == USD_XFER_DONE)
+	{
+		usd_job_end(USD_JOB_OK);
+	}
+	else if (state != USD_XFER_BUSY)
+	{
+		usd_job_end(USD_JOB_FAILED);
+	}
+}
+
+uint8 usd_get_status()
+{
+	return (usd_job_count != 0) ? USD_BUSY : USD_IDLE;
+}
+
+uint8 usd_get_job_result()
+{
+	return usd_job_last_result;
+}
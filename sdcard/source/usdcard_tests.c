@@ -1,8 +1,24 @@
 #include "usdcard.h"
 #include "usdcard_tests.h"
+#include "usdcard_crc.h"
+#include "usdcard_jobs.h"
+#include "logbin.h"
+#include "ramscrub.h"
+#include "bistsched.h"
+#include "telemetry.h"
+#include <stdio.h>
+#include "reg_het.h"
+#include "sys_vim.h"
+#include "reg_tcram.h"
+#include "sys_core.h"
+#include "sys_pmu.h"
+#include "system.h"
 
 uint16 buffer[512];
 uint16 abuffer[512];
+uint16 mbuffer[USD_TEST_MULTI_BLOCKS * 512];
+uint8 pbuffer[512];
+uint8 pabuffer[512];
 
 uint8 usd_test_one_write_one_read_same_block()
 {
@@ -285,6 +301,541 @@ uint8 usd_test_erase_two_blocks()
 	return 0;
 }
 
+uint8 usd_test_write_blocks_and_read()
+{
+	uint16 retv, i;
+	uint32 blk;
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		for (i = 0; i < 512; i++){ mbuffer[blk * 512 + i] = (uint16) (0x0041 + blk); }
+	}
+
+	retv = usd_write_blocks(mbuffer, 8, USD_TEST_MULTI_BLOCKS);
+
+	if(retv) return 1;
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		for (i = 0; i < 512; i++){ abuffer[i] = (uint16) 0xFFFF; }
+		retv = usd_read_block(abuffer, 8 + blk);
+
+		if(retv) return 1;
+
+		for (i = 0; i < 512; i++)
+		{
+			if (abuffer[i] != (uint16) (0x0041 + blk))
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+uint8 usd_test_read_blocks_and_cached()
+{
+	uint16 retv, i;
+	uint32 blk;
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		for (i = 0; i < 512; i++){ mbuffer[blk * 512 + i] = (uint16) (0x0061 + blk); }
+	}
+
+	retv = usd_write_blocks(mbuffer, 8, USD_TEST_MULTI_BLOCKS);
+
+	if(retv) return 1;
+
+	for (i = 0; i < USD_TEST_MULTI_BLOCKS * 512; i++){ mbuffer[i] = (uint16) 0xFFFF; }
+	retv = usd_read_blocks(mbuffer, 8, USD_TEST_MULTI_BLOCKS);
+
+	if(retv) return 1;
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		for (i = 0; i < 512; i++)
+		{
+			if (mbuffer[blk * 512 + i] != (uint16) (0x0061 + blk))
+			{
+				return 1;
+			}
+		}
+	}
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		for (i = 0; i < 512; i++){ abuffer[i] = (uint16) 0xFFFF; }
+		retv = usd_read_block_cached(abuffer, 8 + blk);
+
+		if(retv) return 1;
+
+		for (i = 0; i < 512; i++)
+		{
+			if (abuffer[i] != (uint16) (0x0061 + blk))
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+uint8 usd_test_crc16_known_value()
+{
+	uint16 i;
+
+	// CRC16 of a block filled with 0xFF, as given by the SD specification
+	for (i = 0; i < 512; i++){ buffer[i] = (uint16) 0x00FF; }
+
+	if (usd_crc16(buffer, 512) != 0x7FA1) return 1;
+	if (usd_crc16_bytewise(buffer, 512) != 0x7FA1) return 1;
+
+	// Both kernels must agree on lengths that are not a multiple of four
+	for (i = 0; i < 512; i++){ buffer[i] = (uint16) ((i * 7U + 3U) & 0x00FF); }
+
+	for (i = 509; i <= 512; i++)
+	{
+		if (usd_crc16(buffer, i) != usd_crc16_bytewise(buffer, i)) return 1;
+	}
+
+	return 0;
+}
+
+uint8 usd_test_packed_write_read()
+{
+	uint16 retv, i;
+
+	for (i = 0; i < 512; i++){ pbuffer[i] = (uint8) (i * 3U); }
+
+	retv = usd_write_block8(pbuffer, 1);
+
+	if(retv) return 1;
+
+	// The 16 bit and the packed paths must see the same sector
+	for (i = 0; i < 512; i++){ abuffer[i] = (uint16) 0xFFFF; }
+	retv = usd_read_block(abuffer, 1);
+
+	if(retv) return 1;
+
+	for (i = 0; i < 512; i++){ pabuffer[i] = (uint8) 0xFF; }
+	retv = usd_read_block8(pabuffer, 1);
+
+	if(retv) return 1;
+
+	for (i = 0; i < 512; i++)
+	{
+		if (abuffer[i] != (uint16) pbuffer[i]) return 1;
+		if (pabuffer[i] != pbuffer[i]) return 1;
+	}
+
+	return 0;
+}
+
+uint8 usd_test_xfer_write_read()
+{
+	uint16 retv, i;
+
+	for (i = 0; i < 512; i++){ pbuffer[i] = (uint8) i; }
+
+	retv = usd_xfer_write_start(pbuffer, 2);
+
+	if(retv) return 1;
+
+	while (usd_xfer_service() == USD_XFER_BUSY);
+
+	if (usd_xfer_status() != USD_XFER_DONE) return 1;
+
+	for (i = 0; i < 512; i++){ pabuffer[i] = (uint8) 0xFF; }
+	retv = usd_xfer_read_start(pabuffer, 2);
+
+	if(retv) return 1;
+
+	while (usd_xfer_service() == USD_XFER_BUSY);
+
+	if (usd_xfer_status() != USD_XFER_DONE) return 1;
+
+	for (i = 0; i < 512; i++)
+	{
+		if (pabuffer[i] != (uint8) i)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+uint8 usd_test_jobs_write_read_erase()
+{
+	uint16 i;
+	volatile uint8 wres, rres, eres, r2res;
+	uint8* erased = (uint8*) mbuffer;
+
+	for (i = 0; i < 512; i++){ pbuffer[i] = (uint8) 0x43; }
+	for (i = 0; i < 512; i++){ pabuffer[i] = (uint8) 0xFF; }
+
+	// Jobs run in the order they were queued
+	if (usd_job_write(pbuffer, 4, &wres)) return 1;
+	if (usd_job_read(pabuffer, 4, &rres)) return 1;
+	if (usd_job_erase(4, 4, &eres)) return 1;
+	if (usd_job_read(erased, 4, &r2res)) return 1;
+
+	// The queue is bounded
+	if (usd_job_erase(5, 5, 0) != USD_ERROR_QUEUE_FULL) return 1;
+
+	while (usd_get_status() == USD_BUSY)
+	{
+		usd_main_function();
+	}
+
+	if (wres != USD_JOB_OK || rres != USD_JOB_OK || eres != USD_JOB_OK || r2res != USD_JOB_OK) return 1;
+
+	for (i = 0; i < 512; i++)
+	{
+		if (pabuffer[i] != 0x43) return 1;
+		if (erased[i] != 0x00) return 1;
+	}
+
+	return 0;
+}
+
+uint8 usd_test_logbin_mount_resume()
+{
+	uint16 i;
+	uint32 offset;
+	logbin_info before, after;
+	logbin_record record;
+	boolean found = FALSE;
+
+	if (usd_erase_blocks(32, 39)) return 1;
+
+	// Blank range: new log at its first sector
+	if (logbin_mount(32, 8)) return 1;
+	logbin_get_info(&before);
+	if (before.sector != 0 || before.sequence != 0) return 1;
+
+	// About three sectors of records
+	for (i = 0; i < 20; i++){ pbuffer[i] = (uint8) i; }
+	for (i = 0; i < 40; i++)
+	{
+		if (logbin_append(0x01, i, pbuffer, 20)) return 1;
+	}
+	if (logbin_flush()) return 1;
+	logbin_get_info(&before);
+
+	// A new mount finds the same tail
+	if (logbin_mount(32, 8)) return 1;
+	logbin_get_info(&after);
+	if (after.sector != before.sector || after.offset != before.offset || after.sequence != before.sequence) return 1;
+
+	if (logbin_append(0x02, 1234, pbuffer, 8)) return 1;
+	if (logbin_flush()) return 1;
+
+	if (usd_read_block8(pabuffer, 32 + after.sector)) return 1;
+	offset = LOGBIN_SECTOR_HEADER_SIZE;
+	while (logbin_parse_record(pabuffer, &offset, &record))
+	{
+		found = (boolean) (record.type == 0x02 && record.sequence == 40 && record.timestamp == 1234);
+	}
+
+	return found ? 0 : 1;
+}
+
+uint8 usd_test_ramscrub_single_bit()
+{
+	static volatile uint64 word = 0x0123456789ABCDEFULL;
+	uint32 address = (uint32) &word;
+	volatile uint32* ecc = (volatile uint32*) (address + RAMSCRUB_ECC_OFFSET);
+	ramscrub_event event;
+	boolean found = FALSE;
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+
+	ramscrub_init();
+	while (ramscrub_read_event(&event)) {}
+
+	// Flip one ECC bit of the word, as checkB0RAMECC() does
+	tcram1REG->RAMCTRL = 0x0005010AU;
+	tcram2REG->RAMCTRL = 0x0005010AU;
+	_coreDisableRamEcc_();
+	*ecc ^= 0x1U;
+	_coreEnableRamEcc_();
+	tcram1REG->RAMCTRL = 0x0005000AU;
+	tcram2REG->RAMCTRL = 0x0005000AU;
+
+	// One pass corrects the word and logs its address
+	while (!ramscrub_step()) {}
+	while (ramscrub_read_event(&event))
+	{
+		if (event.type == RAMSCRUB_EVENT_SINGLE && event.address == address) found = TRUE;
+	}
+	if (!found || word != 0x0123456789ABCDEFULL) return 1;
+
+	// The word was written back with a correct ECC: the next pass is clean
+	while (!ramscrub_step()) {}
+
+	return ramscrub_read_event(&event) ? 1 : 0;
+}
+
+//
+// Converts a number of bytes moved in a number of CPU cycles to kB/s.
+//
+static uint32 usd_bench_kbps(uint32 bytes, uint32 cycles)
+{
+	if (cycles == 0) return 0;
+
+	return (uint32)(((float64)bytes * (float64)HCLK_FREQ * 1000.0) / (float64)cycles);
+}
+
+//
+// Single block against multi-block writes, in kB/s of PMU cycles. The same
+// comparison runs on a PC against a card model, see sim/source/usdcard_bench.c.
+//
+uint8 usd_bench_write_single_vs_multi(uint32* single_kbps, uint32* multi_kbps)
+{
+	uint16 retv;
+	uint32 blk, cycles;
+
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS * 512; blk++){ mbuffer[blk] = (uint16) (blk & 0x00FF); }
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+
+	// Single block path: one CMD24 per sector
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		retv = usd_write_block(mbuffer + (blk * 512), 16 + blk);
+		if(retv) return 1;
+	}
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	cycles = _pmuGetCycleCount_();
+	*single_kbps = usd_bench_kbps(USD_TEST_MULTI_BLOCKS * 512, cycles);
+
+	// Streaming path: one CMD25 for all sectors
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	retv = usd_write_blocks(mbuffer, 16, USD_TEST_MULTI_BLOCKS);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	if(retv) return 1;
+	cycles = _pmuGetCycleCount_();
+	*multi_kbps = usd_bench_kbps(USD_TEST_MULTI_BLOCKS * 512, cycles);
+
+	return 0;
+}
+
+//
+// Single block against multi-block reads, in kB/s of PMU cycles. The host
+// version in sim/source/usdcard_bench.c also times the read-ahead window.
+//
+uint8 usd_bench_read_single_vs_multi(uint32* single_kbps, uint32* multi_kbps)
+{
+	uint16 retv;
+	uint32 blk, cycles;
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+
+	// Single block path: one CMD17 per sector
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	for (blk = 0; blk < USD_TEST_MULTI_BLOCKS; blk++)
+	{
+		retv = usd_read_block(mbuffer + (blk * 512), 16 + blk);
+		if(retv) return 1;
+	}
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	cycles = _pmuGetCycleCount_();
+	*single_kbps = usd_bench_kbps(USD_TEST_MULTI_BLOCKS * 512, cycles);
+
+	// Streaming path: one CMD18/CMD12 for all sectors
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	retv = usd_read_blocks(mbuffer, 16, USD_TEST_MULTI_BLOCKS);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	if(retv) return 1;
+	cycles = _pmuGetCycleCount_();
+	*multi_kbps = usd_bench_kbps(USD_TEST_MULTI_BLOCKS * 512, cycles);
+
+	return 0;
+}
+
+uint8 usd_bench_spi_calls_per_sector(uint32* write_calls, uint32* read_calls)
+{
+	uint16 retv, i;
+	usd_spi_counters counters;
+
+	for (i = 0; i < 512; i++){ buffer[i] = (uint16) 0x0041; }
+
+	usd_reset_spi_counters();
+	retv = usd_write_block(buffer, 0);
+	if(retv) return 1;
+	usd_get_spi_counters(&counters);
+	*write_calls = counters.calls / counters.sectors;
+
+	usd_reset_spi_counters();
+	retv = usd_read_block(abuffer, 0);
+	if(retv) return 1;
+	usd_get_spi_counters(&counters);
+	*read_calls = counters.calls / counters.sectors;
+
+	return 0;
+}
+
+void usd_bench_crc16_cycles(uint32* bytewise_cycles, uint32* slice4_cycles)
+{
+	uint16 i;
+	volatile uint16 crc;
+
+	for (i = 0; i < 512; i++){ buffer[i] = (uint16) (i & 0x00FF); }
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	crc = usd_crc16_bytewise(buffer, 512);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	*bytewise_cycles = _pmuGetCycleCount_();
+
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	crc = usd_crc16(buffer, 512);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	*slice4_cycles = _pmuGetCycleCount_();
+
+	(void)crc;
+}
+
+void usd_bench_telemetry_cycles(uint32* record_cycles, uint32* printf_cycles)
+{
+	uint8 record[TELEMETRY_RECORD_SIZE];
+	char line[64];
+	volatile int length;
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+
+	// The programming result and FSM status that sys_main.c printed, as one record and as text
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	telemetry_encode(record, TELEMETRY_FAPI_STATUS, 0U, 0x00000010U, TELEMETRY_DETAIL(TELEMETRY_FAPI_PROGRAM, 0U));
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	*record_cycles = _pmuGetCycleCount_();
+
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	length = sprintf(line, "Return check %d\nFSM Status %d\n", 0, 0x00000010);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	*printf_cycles = _pmuGetCycleCount_();
+
+	(void)length;
+}
+
+//
+// Blocking write against a background transfer of the same sector. The host
+// version in sim/source/usdcard_bench.c also checks the chunk order on a
+// model of the MibSPI1 buffer RAM.
+//
+uint8 usd_bench_xfer_overlap(uint32* blocking_cycles, uint32* xfer_cycles, uint32* free_polls)
+{
+	uint16 retv, i;
+	usd_xfer_counters counters;
+
+	for (i = 0; i < 512; i++){ buffer[i] = (uint16) 0x0055; }
+	for (i = 0; i < 512; i++){ pbuffer[i] = (uint8) 0x55; }
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+
+	// Polling path: the CPU is busy for the whole sector
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	retv = usd_write_block(buffer, 3);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	if(retv) return 1;
+	*blocking_cycles = _pmuGetCycleCount_();
+
+	// Background path: every busy poll is a slot where other work could run
+	usd_reset_xfer_counters();
+	_pmuResetCycleCounter_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+	retv = usd_xfer_write_start(pbuffer, 3);
+	if(retv) return 1;
+	while (usd_xfer_service() == USD_XFER_BUSY);
+	_pmuStopCounters_(pmuCYCLE_COUNTER);
+	if (usd_xfer_status() != USD_XFER_DONE) return 1;
+	*xfer_cycles = _pmuGetCycleCount_();
+
+	usd_get_xfer_counters(&counters);
+	*free_polls = counters.busy_polls;
+
+	return 0;
+}
+
+//
+// Order-sensitive fingerprint of a RAM region, to compare it before and after a test.
+//
+static uint32 usd_test_fingerprint(uint32 address, uint32 size)
+{
+	const volatile uint32* word = (const volatile uint32*) address;
+	uint32 sum = 0;
+	uint32 i;
+
+	for (i = 0; i < (size / 4U); i++)
+	{
+		sum = ((sum << 5) | (sum >> 27)) ^ word[i];
+	}
+
+	return sum;
+}
+
+uint8 usd_test_bistsched_restore()
+{
+	uint32 tests = (1U << BISTSCHED_PBIST_ROM) | (1U << BISTSCHED_VIM_RAM) | (1U << BISTSCHED_HET1_RAM);
+	uint32 vim = usd_test_fingerprint(0xFFF82000U, VIM_CHANNELS * 4U);
+	uint32 het = usd_test_fingerprint((uint32) hetRAM1, sizeof(hetRAMBASE_t));
+	uint32 gcr = hetREG1->GCR;
+	uint32 done = 0;
+	uint32 polls = 0;
+	bistsched_stats stats;
+	uint32 test;
+
+	_pmuInit_();
+	_pmuEnableCountersGlobal_();
+	_pmuStartCounters_(pmuCYCLE_COUNTER);
+
+	// Back to back, one run of each test
+	bistsched_init(tests);
+	bistsched_set_period(0U);
+	while (done < 3U && polls < 1000000U)
+	{
+		done += bistsched_step() ? 1U : 0U;
+		polls++;
+	}
+	bistsched_init(0U);
+	bistsched_set_period(BISTSCHED_PERIOD);
+	if (done != 3U) return 1;
+
+	for (test = 0; test < BISTSCHED_TESTS; test++)
+	{
+		bistsched_get_stats(test, &stats);
+		if (((tests >> test) & 1U) != 0U && (stats.runs != 1U || stats.passed != 1U || stats.last_ticks == 0U)) return 1;
+	}
+
+	// The RAM the algorithms overwrote is back, and the HET runs again
+	if (usd_test_fingerprint(0xFFF82000U, VIM_CHANNELS * 4U) != vim) return 1;
+	if (usd_test_fingerprint((uint32) hetRAM1, sizeof(hetRAMBASE_t)) != het) return 1;
+
+	return (hetREG1->GCR == gcr) ? 0 : 1;
+}
+
 int usd_unit_tests()
 {
 	uint8 failed = 0;
@@ -297,6 +848,15 @@ int usd_unit_tests()
 	failed += usd_test_write_erase_read();					  //OK
 	failed += usd_test_erase_two_continuous_blocks();		  //OK
 	failed += usd_test_erase_two_blocks();					  //OK
+	failed += usd_test_write_blocks_and_read();
+	failed += usd_test_read_blocks_and_cached();
+	failed += usd_test_crc16_known_value();
+	failed += usd_test_packed_write_read();
+	failed += usd_test_xfer_write_read();
+	failed += usd_test_jobs_write_read_erase();
+	failed += usd_test_logbin_mount_resume();
+	failed += usd_test_ramscrub_single_bit();
+	failed += usd_test_bistsched_restore();
 
 	return (failed > 0) ? 1 : 0;
 }